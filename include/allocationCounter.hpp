@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Counts heap allocations per task, to check that loops allocate nothing once running.
+ *
+ * The counts come from wrapping the malloc family at link time (`-Wl,--wrap=malloc` and so on),
+ * which the Makefile does with `COUNT_ALLOCATIONS:=1`. Wrapping catches every malloc() call in
+ * the image, operator new included. newlib's own allocations for stdio buffers call _malloc_r
+ * directly and aren't counted. Built without the flags, the counts stay zero and `isCounting()` is
+ * false.
+ *
+ * Tasks are told apart by their handle in a fixed table, so counting never allocates. A task
+ * created after the table is full is counted with the rest in the last slot, and a new task which
+ * reuses a deleted task's handle inherits its counts.
+ *
+ * LoopRate reads `getTaskCount()` at every wake, which gives each loop's allocations per
+ * iteration.
+ */
+class AllocationCounter {
+  public:
+  /**
+   * @return Whether the malloc family is wrapped, so the counts are real.
+   */
+  static bool isCounting();
+
+  /**
+   * @return The allocations the calling task has made.
+   */
+  static std::uint32_t getTaskCount();
+
+  /**
+   * @return The allocations every task has made.
+   */
+  static std::uint32_t getTotalCount();
+
+  /**
+   * Prints each task's allocations and bytes allocated.
+   */
+  static void printAll(FILE *ifile = stdout);
+
+  static constexpr std::size_t maxTasks = 32;
+};
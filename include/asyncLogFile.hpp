@@ -0,0 +1,125 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+/**
+ * A log file for okapi::Logger which never makes the logging thread wait on the SD card.
+ *
+ * okapi::Logger formats each statement (time, thread name, level and message) and fprintf()s it
+ * to its FILE under a mutex. Given `getFile()`, that fprintf() lands in a fixed-size ring in
+ * memory instead; a background task writes the ring out to the real file in batches. If a burst
+ * fills the ring, statements which don't fit are dropped and counted, and the file gets a line
+ * saying how many went missing. Nothing blocks and nothing is allocated per statement.
+ *
+ * The ring has one writer, since Logger serializes its writes, and one reader, the task, so they
+ * share it through two atomic indices without a lock.
+ *
+ *   auto logFile = AsyncLogFile::open(TimeUtilFactory::createDefault(), "/usd/logging.txt");
+ *   // nullptr without an SD card, and a Logger with no file logs nothing
+ *   auto logger = std::make_shared<Logger>(TimeUtilFactory::createDefault().getTimer(),
+ *                                          logFile ? logFile->getFile() : nullptr,
+ *                                          Logger::LogLevel::debug);
+ *
+ * The FILE belongs to the Logger, which closes it when destroyed; closing it writes out whatever
+ * is left in the ring. The AsyncLogFile lives until both the FILE and every shared_ptr are gone.
+ */
+class AsyncLogFile {
+  public:
+  /**
+   * Opens a file the way okapi::Logger does: a `/ser/` stream is written, anything else appended
+   * to. Returns nullptr if it can't be opened.
+   *
+   * @param itimeUtil The TimeUtil for the writing task's rate.
+   * @param ifileName The file to write, e.x. `/usd/logging.txt`.
+   * @param icapacity The ring's size in bytes, rounded up to a power of two.
+   * @param iperiod How often the task writes the ring out.
+   */
+  static std::shared_ptr<AsyncLogFile> open(const okapi::TimeUtil &itimeUtil,
+                                            const std::string &ifileName,
+                                            std::size_t icapacity = 16384,
+                                            okapi::QTime iperiod = 50 * okapi::millisecond);
+
+  /**
+   * Writes to an already open file instead, which is closed with the stream.
+   */
+  static std::shared_ptr<AsyncLogFile> open(const okapi::TimeUtil &itimeUtil,
+                                            FILE *itarget,
+                                            std::size_t icapacity = 16384,
+                                            okapi::QTime iperiod = 50 * okapi::millisecond);
+
+  AsyncLogFile(const AsyncLogFile &) = delete;
+  AsyncLogFile &operator=(const AsyncLogFile &) = delete;
+  ~AsyncLogFile();
+
+  /**
+   * @return The stream to hand to okapi::Logger. Pass it to exactly one owner, who closes it.
+   */
+  FILE *getFile() const;
+
+  /**
+   * @return How many writes were dropped because the ring was full.
+   */
+  std::size_t getOverruns() const;
+
+  /**
+   * @return How many bytes have been written out to the file.
+   */
+  std::size_t getBytesWritten() const;
+
+  protected:
+  AsyncLogFile(const okapi::TimeUtil &itimeUtil,
+               FILE *itarget,
+               std::size_t icapacity,
+               okapi::QTime iperiod);
+
+  okapi::TimeUtil timeUtil;
+  FILE *target;
+  FILE *stream{nullptr};
+  std::unique_ptr<char[]> ring;
+  std::size_t capacity; // a power of two, so indices wrap with a mask
+  okapi::QTime period;
+
+  // Free-running: the ring holds [tail, head), masked
+  std::atomic<std::size_t> head{0};
+  std::atomic<std::size_t> tail{0};
+  std::atomic<std::size_t> overruns{0};
+  std::atomic<std::size_t> bytesWritten{0};
+  std::size_t reportedOverruns{0};
+
+  std::atomic_bool dying{false};
+  std::atomic_bool finished{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * Copies into the ring, or drops it whole if it doesn't fit. Called on the logging thread.
+   */
+  void push(const char *ibuffer, std::size_t isize);
+
+  /**
+   * Writes the ring out to the target. Called on the task.
+   */
+  void drain();
+
+  /**
+   * Stops the task once it has drained the ring and closes the target.
+   */
+  void close();
+
+  static std::shared_ptr<AsyncLogFile> openStream(std::shared_ptr<AsyncLogFile> ifile);
+
+  /*
+   * The stream's fopencookie() callbacks. The cookie is a heap-allocated shared_ptr to the
+   * AsyncLogFile, which keeps it alive while the stream is open.
+   */
+  static ssize_t cookieWrite(void *icookie, const char *ibuffer, std::size_t isize);
+  static int cookieClose(void *icookie);
+
+  static void trampoline(void *icontext);
+  void loop();
+};
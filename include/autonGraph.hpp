@@ -0,0 +1,206 @@
+#pragma once
+
+#include "autonTimeline.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Runs an autonomous routine as a graph of steps, each started as soon as what it waits on
+ * allows, instead of straight-line code with mechanisms in detached tasks and guessed delays.
+ *
+ * Every step is a blocking action on a lane, and declares the conditions it starts on:
+ *
+ *   AutonGraph graph(TimeUtilFactory::createDefault(), odometer);
+ *   auto drive = graph.add("drive 1.1 m", Lane::drive, [] { chain.moveDistance(1.1_m); });
+ *   auto intake = graph.add("intake", Lane::intake, [] { spinIntake("intake", 200, 2000); },
+ *                           {AutonGraph::atDistance(drive, 0.3_m)});
+ *   graph.add("stack", Lane::tray, stackTray,
+ *             {AutonGraph::after(intake), AutonGraph::after(drive)});
+ *   graph.run();
+ *
+ * A step starts once all of its conditions hold:
+ *  - `after(X, d)`: X finished at least d ago,
+ *  - `afterStart(X, d)`: X started at least d ago,
+ *  - `atDistance(X, y)`: the robot has travelled y since X started, or X finished short of it,
+ *  - `when(f)`: f returns true, e.x. a limit switch or sensor reading.
+ * A step with no conditions starts right away.
+ *
+ * Each lane has a task of its own which runs its steps one at a time, in the order they became
+ * ready, since a mechanism can only do one thing at a time. Steps on different lanes run
+ * concurrently. The graph records when each step became ready, started and finished.
+ */
+class AutonGraph {
+  public:
+  using Lane = AutonTimeline::Lane;
+  using StepId = std::size_t;
+
+  /**
+   * What a step waits on. Made by `after()`, `afterStart()`, `atDistance()` and `when()`.
+   */
+  struct Condition {
+    enum class Kind { after, afterStart, atDistance, when };
+
+    Kind kind;
+    StepId step;
+    double amount; // ms, or m for atDistance
+    std::function<bool()> predicate;
+  };
+
+  /**
+   * The timing of one step in the last run, in ms since it began.
+   */
+  struct Record {
+    std::uint32_t readyMs{0};  // its conditions held
+    std::uint32_t startMs{0};  // its lane took it up
+    std::uint32_t endMs{0};
+    bool finished{false};
+  };
+
+  /**
+   * @param itimeUtil The TimeUtil for timestamps and the scheduler's rate.
+   * @param iodometer Reads how far the drive's wheels have turned, e.x. the encoders' average, for
+   * `atDistance()`. Leave it empty when no step waits on distance.
+   */
+  explicit AutonGraph(const okapi::TimeUtil &itimeUtil,
+                      std::function<okapi::QLength()> iodometer = nullptr);
+
+  ~AutonGraph();
+
+  AutonGraph(const AutonGraph &) = delete;
+  AutonGraph &operator=(const AutonGraph &) = delete;
+
+  /**
+   * Adds a step. Conditions may only refer to steps added before it, so the graph has no cycles.
+   * Waits for any step still running from a run that timed out to finish first.
+   *
+   * @param iname The name in the report.
+   * @param ilane The lane whose task runs the step.
+   * @param iaction The step itself, returning once it is done.
+   * @param iconditions What the step starts on.
+   * @return The step, for other steps' conditions.
+   */
+  StepId add(std::string iname,
+             Lane ilane,
+             std::function<void()> iaction,
+             std::vector<Condition> iconditions = {});
+
+  /**
+   * Removes every step, e.x. to build another routine. Cancels the steps which haven't started,
+   * and waits for any still running from a run that timed out to finish first.
+   */
+  void clear();
+
+  /**
+   * Keeps the steps which haven't started from starting, e.x. once autonomous is over and a timed
+   * out run's steps would otherwise carry on into driver control. A step already running can't be
+   * interrupted, so it still finishes.
+   */
+  void cancel();
+
+  /**
+   * Runs every step and returns once all have finished.
+   *
+   * @param itimeout How long to wait for them. Steps still running after it are left to finish;
+   * a later run doesn't start them again, and counts them once they finish.
+   * @return Whether every step finished in time.
+   */
+  bool run(okapi::QTime itimeout = 15 * okapi::second);
+
+  /**
+   * @return Whether the step has finished in the current or last run, e.x. for an intake step to
+   * run until a drive step is done.
+   */
+  bool isFinished(StepId istep) const;
+
+  /**
+   * @return The timing of each step in the last run, in the order they were added.
+   */
+  std::vector<Record> getReport() const;
+
+  /**
+   * Prints a line per step with when it became ready, started and finished.
+   */
+  void printReport() const;
+
+  static Condition after(StepId istep, okapi::QTime idelay = 0 * okapi::millisecond);
+
+  static Condition afterStart(StepId istep, okapi::QTime idelay = 0 * okapi::millisecond);
+
+  static Condition atDistance(StepId istep, okapi::QLength idistance);
+
+  static Condition when(std::function<bool()> ipredicate);
+
+  protected:
+  enum class State { pending, ready, running, finished, cancelled };
+
+  struct Step {
+    std::string name;
+    Lane lane;
+    std::function<void()> action;
+    std::vector<Condition> conditions;
+    State state{State::pending};
+    std::uint64_t order{0}; // when it became ready, so each lane takes steps up in that order
+    double startDistance{0};
+    Record record;
+  };
+
+  struct Worker {
+    AutonGraph *graph;
+    Lane lane;
+    CrossplatformThread *task{nullptr};
+    std::atomic_bool finished{false};
+  };
+
+  okapi::TimeUtil timeUtil;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  std::function<okapi::QLength()> odometer;
+  std::vector<Step> steps;
+  std::uint64_t readyCount{0};
+  std::array<Worker, AutonTimeline::laneCount> workers;
+  mutable CrossplatformMutex stepsLock;
+  std::atomic_bool dying{false};
+
+  std::uint32_t now() const;
+
+  double distance() const;
+
+  /**
+   * Takes the lock once no step is running, checking every 10 ms until then. Workers read a
+   * running step without the lock, so `steps` may only change once this returns.
+   */
+  void lockIdle();
+
+  /**
+   * @return Whether the condition holds, counting `when()` conditions as holding, since their
+   * predicates are checked without the lock. Called with the lock held.
+   */
+  bool holds(const Condition &icondition) const;
+
+  /**
+   * @return Whether the step's `when()` predicates all hold. Called without the lock, so a
+   * predicate may call back into the graph, e.x. `isFinished()`.
+   */
+  bool predicatesHold(const Step &istep) const;
+
+  /**
+   * Marks the pending steps whose conditions hold as ready. Takes the lock itself.
+   */
+  void promote();
+
+  /**
+   * @return The ready step the lane should run next, or `steps.size()` if there is none.
+   * Called with the lock held.
+   */
+  std::size_t nextOn(Lane ilane) const;
+
+  static void trampoline(void *icontext);
+
+  void loop(Lane ilane);
+};
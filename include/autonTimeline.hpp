@@ -0,0 +1,150 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Records when each step of an autonomous routine ran, on one lane per mechanism, and works out
+ * from that what the routine's length actually waited on.
+ *
+ * Blocking drive motions, mechanisms running in their own tasks and fixed `pros::delay`s each
+ * record a span from their start to their end:
+ *
+ *   AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::intake, "intake");
+ *   ...
+ *   autonTimeline.delay(1000); // instead of pros::delay(1000)
+ *
+ * The report then shows
+ *  - the critical path: the chain of spans, each ending as the next began, that leads back from
+ *    whatever finished last. Shortening anything else doesn't shorten the routine.
+ *  - each lane's busy and idle time over the routine, the slack a mechanism has to take on work.
+ *  - the fixed delays, and how much of each was spent with no mechanism running, which is time
+ *    the routine waited on nothing but the clock.
+ *
+ * Spans are stored in a buffer reserved up front, so recording never allocates; once it is full
+ * further spans are dropped.
+ */
+class AutonTimeline {
+  public:
+  enum class Lane { drive, intake, tray, arm, delay };
+  static constexpr std::size_t laneCount = 5;
+
+  /**
+   * Returned by `begin()` when the span isn't recorded.
+   */
+  static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+  struct Span {
+    char name[32];
+    Lane lane;
+    std::uint32_t startMs; // since `start()`
+    std::uint32_t endMs;
+    bool open;
+  };
+
+  /**
+   * Records a span over its own lifetime.
+   */
+  class Scope {
+    public:
+    Scope(AutonTimeline &itimeline, Lane ilane, const char *iname);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    protected:
+    AutonTimeline &timeline;
+    std::size_t span;
+  };
+
+  /**
+   * @param itimeUtil The TimeUtil for timestamps.
+   * @param icapacity The most spans to keep.
+   */
+  explicit AutonTimeline(const okapi::TimeUtil &itimeUtil, std::size_t icapacity = 128);
+
+  /**
+   * Clears the spans and starts recording, with the routine starting now.
+   */
+  void start();
+
+  /**
+   * Stops recording. Spans still open end now.
+   */
+  void stop();
+
+  bool isRecording() const;
+
+  /**
+   * Starts a span. Names longer than 31 characters are cut off.
+   *
+   * @return The span to pass to `end()`, or `none` when not recording or full.
+   */
+  std::size_t begin(Lane ilane, const char *iname);
+
+  /**
+   * Ends a span from `begin()`.
+   */
+  void end(std::size_t ispan);
+
+  /**
+   * Waits for a fixed time, recorded on the delay lane.
+   */
+  void delay(std::uint32_t ims);
+
+  /**
+   * @return A copy of the spans recorded, in the order they started.
+   */
+  std::vector<Span> getSpans() const;
+
+  /**
+   * @return The spans on the critical path, first to last, as indices into `getSpans()`.
+   */
+  std::vector<std::size_t> getCriticalPath() const;
+
+  /**
+   * Prints the critical path, each lane's busy and idle time and the fixed delays to stdout.
+   */
+  void printReport() const;
+
+  /**
+   * Writes the spans as CSV with columns lane,name,start_ms,end_ms,critical.
+   *
+   * @param ifileName The file to write, e.x. `/usd/timeline.csv`.
+   * @return Whether the file was written.
+   */
+  bool save(const std::string &ifileName) const;
+
+  static const char *laneName(Lane ilane);
+
+  protected:
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  std::size_t capacity;
+  std::vector<Span> spans;
+  bool recording{false};
+  mutable CrossplatformMutex spansLock;
+
+  std::uint32_t now() const;
+
+  /**
+   * @return The spans with open ones ending now.
+   */
+  std::vector<Span> snapshot() const;
+
+  static std::vector<std::size_t> criticalPath(const std::vector<Span> &ispans);
+
+  /**
+   * @return How long any span on the lanes in `ilanes` ran between `ifrom` and `ito`, counting
+   * overlapping spans once.
+   */
+  static std::uint32_t busyTime(const std::vector<Span> &ispans,
+                                std::initializer_list<Lane> ilanes,
+                                std::uint32_t ifrom,
+                                std::uint32_t ito);
+};
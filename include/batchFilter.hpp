@@ -0,0 +1,217 @@
+#pragma once
+
+#include "simd.hpp"
+#include <array>
+#include <cstddef>
+
+/*
+ * Filters for many channels at once, e.x. every drive and mechanism motor's velocity, in a single
+ * call per tick instead of one virtual okapi::Filter call per channel.
+ *
+ * State is laid out as structure-of-arrays: one array per state variable, indexed by channel.
+ * Each filter's math then runs on four channels at a time through simd.hpp (NEON on the V5), with
+ * any leftover channels done one by one. They run in single precision, which is what NEON does
+ * and plenty for sensor readings. Otherwise the math matches the okapi filters of the same name.
+ */
+
+template <std::size_t channels> using ChannelArray = std::array<float, channels>;
+
+/**
+ * okapi::EmaFilter on every channel, with one shared alpha.
+ */
+template <std::size_t channels> class BatchEmaFilter {
+  public:
+  /**
+   * @param ialpha alpha gain, as for okapi::EmaFilter
+   */
+  explicit BatchEmaFilter(const float ialpha) : alpha(ialpha) {
+  }
+
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements
+   * @return filtered results
+   */
+  const ChannelArray<channels> &filter(const ChannelArray<channels> &ireadings) {
+    simd::forEach<channels>([&](auto v, const std::size_t i) {
+      using V = decltype(v);
+      const V a = simd::splat<V>(alpha);
+      const V b = simd::splat<V>(1 - alpha);
+      const V out = simd::add(simd::mul(a, simd::load<V>(&ireadings[i])),
+                              simd::mul(b, simd::load<V>(&output[i])));
+      simd::store(&output[i], out);
+    });
+    return output;
+  }
+
+  const ChannelArray<channels> &getOutput() const {
+    return output;
+  }
+
+  void setGains(const float ialpha) {
+    alpha = ialpha;
+  }
+
+  protected:
+  float alpha;
+  ChannelArray<channels> output{};
+};
+
+/**
+ * okapi::DemaFilter on every channel, with one shared alpha and beta.
+ */
+template <std::size_t channels> class BatchDemaFilter {
+  public:
+  /**
+   * @param ialpha alpha gain, as for okapi::DemaFilter
+   * @param ibeta beta gain, as for okapi::DemaFilter
+   */
+  BatchDemaFilter(const float ialpha, const float ibeta) : alpha(ialpha), beta(ibeta) {
+  }
+
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements
+   * @return filtered results
+   */
+  const ChannelArray<channels> &filter(const ChannelArray<channels> &ireadings) {
+    simd::forEach<channels>([&](auto v, const std::size_t i) {
+      using V = decltype(v);
+      const V lastS = simd::load<V>(&outputS[i]);
+      const V lastB = simd::load<V>(&outputB[i]);
+      const V s = simd::add(simd::mul(simd::splat<V>(alpha), simd::load<V>(&ireadings[i])),
+                            simd::mul(simd::splat<V>(1 - alpha), simd::add(lastS, lastB)));
+      const V b = simd::add(simd::mul(simd::splat<V>(beta), simd::sub(s, lastS)),
+                            simd::mul(simd::splat<V>(1 - beta), lastB));
+      simd::store(&outputS[i], s);
+      simd::store(&outputB[i], b);
+      simd::store(&output[i], simd::add(s, b));
+    });
+    return output;
+  }
+
+  const ChannelArray<channels> &getOutput() const {
+    return output;
+  }
+
+  void setGains(const float ialpha, const float ibeta) {
+    alpha = ialpha;
+    beta = ibeta;
+  }
+
+  protected:
+  float alpha;
+  float beta;
+  ChannelArray<channels> outputS{};
+  ChannelArray<channels> outputB{};
+  ChannelArray<channels> output{};
+};
+
+/**
+ * okapi::AverageFilter<n> on every channel, with RunningAverageFilter's running sums: O(1) per
+ * reading, recomputed from the window each time it wraps around.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t channels, std::size_t n> class BatchAverageFilter {
+  static_assert(n > 0, "BatchAverageFilter needs at least one tap");
+
+  public:
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements
+   * @return filtered results
+   */
+  const ChannelArray<channels> &filter(const ChannelArray<channels> &ireadings) {
+    ChannelArray<channels> &oldest = data[index];
+    const bool wrapped = ++index >= n;
+    if (wrapped) {
+      index = 0;
+    }
+
+    simd::forEach<channels>([&](auto v, const std::size_t i) {
+      using V = decltype(v);
+      const V reading = simd::load<V>(&ireadings[i]);
+      V total = simd::add(simd::load<V>(&sum[i]), simd::sub(reading, simd::load<V>(&oldest[i])));
+      simd::store(&oldest[i], reading);
+      if (wrapped) {
+        total = simd::splat<V>(0);
+        for (const auto &row : data) {
+          total = simd::add(total, simd::load<V>(&row[i]));
+        }
+      }
+      simd::store(&sum[i], total);
+      simd::store(&output[i], simd::mul(total, simd::splat<V>(1.0f / n)));
+    });
+    return output;
+  }
+
+  const ChannelArray<channels> &getOutput() const {
+    return output;
+  }
+
+  protected:
+  std::array<ChannelArray<channels>, n> data{};
+  std::size_t index{0};
+  ChannelArray<channels> sum{};
+  ChannelArray<channels> output{};
+};
+
+/**
+ * okapi::MedianFilter<n> on every channel. Each group of four channels is sorted with the same
+ * branch-free network of min/max operations, so this suits short windows; for long ones use a
+ * SlidingMedianFilter per channel.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t channels, std::size_t n> class BatchMedianFilter {
+  static_assert(n > 0, "BatchMedianFilter needs at least one tap");
+
+  public:
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements
+   * @return filtered results
+   */
+  const ChannelArray<channels> &filter(const ChannelArray<channels> &ireadings) {
+    data[index] = ireadings;
+    if (++index >= n) {
+      index = 0;
+    }
+
+    simd::forEach<channels>([&](auto v, const std::size_t i) {
+      using V = decltype(v);
+      V sorted[n];
+      for (std::size_t k = 0; k < n; k++) {
+        sorted[k] = simd::load<V>(&data[k][i]);
+      }
+
+      // Insertion sort as a network: every comparison happens, whatever the data
+      for (std::size_t k = 1; k < n; k++) {
+        for (std::size_t j = k; j > 0; j--) {
+          const V lo = simd::min(sorted[j - 1], sorted[j]);
+          sorted[j] = simd::max(sorted[j - 1], sorted[j]);
+          sorted[j - 1] = lo;
+        }
+      }
+      simd::store(&output[i], sorted[middleIndex]);
+    });
+    return output;
+  }
+
+  const ChannelArray<channels> &getOutput() const {
+    return output;
+  }
+
+  protected:
+  // okapi::MedianFilter's middle index: the lower median for an even window
+  static constexpr std::size_t middleIndex = (n & 1) ? n / 2 : n / 2 - 1;
+
+  std::array<ChannelArray<channels>, n> data{};
+  std::size_t index{0};
+  ChannelArray<channels> output{};
+};
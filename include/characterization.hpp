@@ -0,0 +1,96 @@
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * Drivetrain characterization. Drives the chassis open-loop through ChassisModel::driveVectorVoltage
+ * and records timestamped voltage and side positions, so kS/kV/kA can be fit offline with
+ * tools/characterize (the same units FeedbackMotionProfileController::Gains uses).
+ *
+ * Two kinds of test are run in each direction:
+ *  - quasi-static: the voltage ramps up slowly, so acceleration is negligible and the samples give
+ *    kS and kV.
+ *  - step: a constant voltage is applied from rest, so the acceleration phase gives kA.
+ */
+class DriveCharacterizer {
+  public:
+  struct Sample {
+    std::uint32_t time; // ms since the test started
+    std::uint8_t test;  // index into the test names, see `save()`
+    float volts;        // commanded voltage, signed
+    float left;         // left side position in meters
+    float right;        // right side position in meters
+  };
+
+  /**
+   * @param itimeUtil The TimeUtil used for timestamps and the sample rate.
+   * @param imodel The chassis to drive. Must be in a brake mode that lets it coast between tests.
+   * @param iscales The chassis scales, used to convert encoder ticks to meters.
+   * @param imaxDistance Each test stops once either side has travelled this far.
+   */
+  DriveCharacterizer(const okapi::TimeUtil &itimeUtil,
+                     std::shared_ptr<okapi::ChassisModel> imodel,
+                     const okapi::ChassisScales &iscales,
+                     okapi::QLength imaxDistance = 1.5 * okapi::meter);
+
+  /**
+   * Ramps the voltage from zero at `irampRate` volts per second until `imaxVolts` or the distance
+   * limit is reached.
+   *
+   * @param irampRate The ramp rate in volts per second.
+   * @param imaxVolts The voltage to stop at.
+   * @param ibackwards Whether to drive backwards.
+   */
+  void runQuasistatic(double irampRate, double imaxVolts, bool ibackwards);
+
+  /**
+   * Applies a constant voltage from rest until the time or distance limit is reached.
+   *
+   * @param ivolts The voltage to apply.
+   * @param iduration The longest the test may run.
+   * @param ibackwards Whether to drive backwards.
+   */
+  void runStep(double ivolts, okapi::QTime iduration, bool ibackwards);
+
+  /**
+   * Runs the standard sequence: quasi-static forward and backward at 0.5 V/s, then 6 V steps
+   * forward and backward, pausing between tests so the robot comes to rest. The robot needs
+   * `imaxDistance` of clear space in front of it; each backward test returns it roughly to the
+   * start.
+   */
+  void runAll();
+
+  /**
+   * Writes the recorded samples as CSV: `time_ms,test,volts,left_m,right_m`, where test is
+   * one of `quasistatic-forward`, `quasistatic-backward`, `step-forward`, `step-backward`.
+   *
+   * @param ifileName The file to write, e.x. `/usd/characterization.csv`.
+   * @return Whether the file was written.
+   */
+  bool save(const std::string &ifileName) const;
+
+  /**
+   * @return The samples recorded so far.
+   */
+  const std::vector<Sample> &getSamples() const;
+
+  protected:
+  okapi::TimeUtil timeUtil;
+  std::shared_ptr<okapi::ChassisModel> model;
+  okapi::ChassisScales scales;
+  okapi::QLength maxDistance;
+  std::vector<Sample> samples;
+
+  /**
+   * Drives with the voltage returned by `ivoltsAt(seconds)` until it returns `std::nullopt` or the
+   * distance limit is reached, recording a sample every 10 ms. Zero volts is a voltage like any
+   * other, e.x. the start of a ramp.
+   */
+  template <typename F> void record(std::uint8_t itest, F ivoltsAt);
+};
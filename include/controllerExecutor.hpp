@@ -0,0 +1,159 @@
+#pragma once
+
+#include "okapi/api/control/iterative/iterativeController.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "timingStats.hpp"
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Runs control loops' steps in one task on one clock, instead of a task per controller.
+ *
+ * Each okapi async controller steps in its own task at its own rate, so their phases drift
+ * against each other: the controller may step just before the sensors it reads update, and the
+ * output waits up to a period to reach the motor. Here every registered step runs on a common
+ * tick, in stage order, sense then estimate then control then actuate, so each tick's outputs
+ * come from that tick's readings. Within a stage the shorter periods run first (rate-monotonic
+ * order), then registration order.
+ *
+ * Every step, every stage, the whole tick and the sensor-to-actuator latency (from the first
+ * sense step starting to the last actuate step finishing, on ticks which run both) are timed in
+ * microseconds, with anything longer than a tick counted as an overrun.
+ *
+ *   ControllerExecutor executor(TimeUtilFactory::createDefault());
+ *   executor.addController("lift", liftPid, [&] { return lift.getPosition(); },
+ *                          [&](double out) { lift.controllerSet(out); });
+ *   executor.start();
+ *   ...
+ *   executor.save("/usd/executor.csv");
+ *
+ * okapi's own async controllers can't join in without changing OkapiLib, so register their
+ * iterative counterparts instead. tools/executorBenchmark measures the sensor-to-motor latency
+ * this saves over a task per stage.
+ */
+class ControllerExecutor {
+  public:
+  enum class Stage { sense, estimate, control, actuate };
+
+  static constexpr std::size_t stageCount = 4;
+
+  /**
+   * @param itimeUtil The TimeUtil for the task's rate.
+   * @param itick The base period. Every step's period is a whole number of ticks.
+   */
+  explicit ControllerExecutor(const okapi::TimeUtil &itimeUtil,
+                              okapi::QTime itick = 10 * okapi::millisecond);
+
+  ControllerExecutor(const ControllerExecutor &) = delete;
+  ControllerExecutor &operator=(const ControllerExecutor &) = delete;
+  ~ControllerExecutor();
+
+  /**
+   * Registers a step. It first runs on the next tick whose count is a multiple of its period.
+   *
+   * @param iname The name in reports.
+   * @param istage When in the tick it runs.
+   * @param iperiod How often it runs, rounded to a whole number of ticks, at least one.
+   * @param istep The step.
+   */
+  void add(std::string iname, Stage istage, okapi::QTime iperiod, std::function<void()> istep);
+
+  /**
+   * Registers an iterative controller as three steps: the input is read in the sense stage, the
+   * controller steps in the control stage and its output is written in the actuate stage.
+   *
+   * @param iname The name in reports.
+   * @param icontroller The controller, e.x. an IterativePosPIDController.
+   * @param iinput Reads the controller's input.
+   * @param ioutput Writes the controller's output.
+   * @param iperiod How often it runs.
+   */
+  void addController(const std::string &iname,
+                     std::shared_ptr<okapi::IterativeController<double, double>> icontroller,
+                     std::function<double()> iinput,
+                     std::function<void(double)> ioutput,
+                     okapi::QTime iperiod = 10 * okapi::millisecond);
+
+  /**
+   * Starts running the steps in the background.
+   */
+  void start();
+
+  /**
+   * Stops running the steps. No step is running once this returns.
+   */
+  void stop();
+
+  bool isRunning() const;
+
+  /**
+   * Runs one tick now, for driving the executor from the caller's own loop instead of `start()`.
+   */
+  void tick();
+
+  /**
+   * Clears every timing, keeping the steps.
+   */
+  void clearStats();
+
+  /**
+   * @return How many ticks took longer than a tick.
+   */
+  std::uint32_t getOverruns() const;
+
+  /**
+   * Prints each step's, stage's and the tick's timing, and the latency.
+   */
+  void printReport() const;
+
+  /**
+   * Writes the same as `printReport()` as CSV, one row per step, a `stage` row per stage, then the
+   * tick and the latency:
+   * name,stage,period_ms,count,mean_us,p99_us,max_us,overruns.
+   *
+   * @param ifileName The file to write, e.x. `/usd/executor.csv`.
+   * @return Whether the file was written.
+   */
+  bool save(const std::string &ifileName) const;
+
+  static const char *stageName(Stage istage);
+
+  protected:
+  struct Step {
+    std::string name;
+    Stage stage;
+    std::uint32_t ticks; // the period, in ticks
+    std::function<void()> step;
+    TimingStats stats;
+  };
+
+  okapi::TimeUtil timeUtil;
+  okapi::QTime tickPeriod;
+  std::uint32_t tickUs;
+  std::vector<Step> steps; // sorted by stage, then period, then registration
+  std::array<TimingStats, stageCount> stageStats;
+  TimingStats tickStats;
+  TimingStats latencyStats;
+  std::uint32_t tickCount{0};
+  mutable CrossplatformMutex stepsLock;
+  std::atomic_bool running{false};
+  std::atomic_bool dying{false};
+  std::atomic_bool finished{false};
+  CrossplatformThread *task{nullptr};
+
+  void tickLocked();
+
+  /**
+   * Writes a row per step, stage, the tick and the latency, as CSV or as a table.
+   */
+  void write(FILE *ifile, bool icsv) const;
+
+  static void trampoline(void *icontext);
+  void loop();
+};
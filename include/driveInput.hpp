@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A response curve for a controller stick: maps every reading the stick can give, -128 to 127, to
+ * motor power, -127 to 127. The table is worked out at compile time, so shaping a reading at run
+ * time is one lookup.
+ */
+class InputCurve {
+  public:
+  static constexpr std::size_t size = 256;
+
+  /**
+   * Straight through, apart from the deadband.
+   *
+   * @param ideadband Readings this close to center give no power, e.x. for a stick which doesn't
+   * return to 0. The rest of the range is stretched to still reach full power at the end.
+   */
+  static constexpr InputCurve linear(const int ideadband = 0) {
+    return cubic(ideadband, 0);
+  }
+
+  /**
+   * Blends a straight line with a cubic, giving finer control near center and the same full power.
+   *
+   * @param ideadband As for `linear()`.
+   * @param iweight How much of the cubic, 0 (linear) to 1 (pure cubic).
+   */
+  static constexpr InputCurve cubic(const int ideadband, const double iweight) {
+    InputCurve curve;
+    for (int reading = -128; reading <= 127; reading++) {
+      const double t = stretch(reading, ideadband);
+      curve.table[index(reading)] = round(127 * ((1 - iweight) * t + iweight * t * t * t));
+    }
+    return curve;
+  }
+
+  /**
+   * An exponential curve, the usual "expo": power is `t * e^(k (|t| - 1))` of full power, for the
+   * reading t from -1 to 1 past the deadband. Higher k keeps more of the stick's travel for low
+   * power; 0 is linear.
+   *
+   * @param ideadband As for `linear()`.
+   * @param ik The exponent's scale, e.x. 2 to 4.
+   */
+  static constexpr InputCurve expo(const int ideadband, const double ik) {
+    InputCurve curve;
+    for (int reading = -128; reading <= 127; reading++) {
+      const double t = stretch(reading, ideadband);
+      const double magnitude = t < 0 ? -t : t;
+      curve.table[index(reading)] = round(127 * t * exp(ik * (magnitude - 1)));
+    }
+    return curve;
+  }
+
+  /**
+   * @return The power for a stick reading. Readings outside the stick's range are clamped.
+   */
+  constexpr int operator()(const int ireading) const {
+    return table[index(ireading < -128 ? -128 : ireading > 127 ? 127 : ireading)];
+  }
+
+  /**
+   * @return Whether the curve is 0 at center, gives full power at both ends, never falls as the
+   * reading rises, and is the same in both directions.
+   */
+  constexpr bool isWellFormed() const {
+    if ((*this)(0) != 0 || (*this)(127) != 127 || (*this)(-127) != -127) {
+      return false;
+    }
+    for (int reading = -127; reading <= 127; reading++) {
+      if ((*this)(reading) != -(*this)(-reading)) {
+        return false;
+      }
+      if (reading > -127 && (*this)(reading) < (*this)(reading - 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  protected:
+  std::array<std::int8_t, size> table{};
+
+  static constexpr std::size_t index(const int ireading) {
+    return static_cast<std::size_t>(ireading + 128);
+  }
+
+  /**
+   * @return The reading past the deadband as -1 to 1. -128 is read as -127, so the curve is
+   * symmetric.
+   */
+  static constexpr double stretch(const int ireading, const int ideadband) {
+    const int magnitude = ireading < 0 ? (ireading < -127 ? 127 : -ireading) : ireading;
+    if (magnitude <= ideadband) {
+      return 0;
+    }
+    const double t = static_cast<double>(magnitude - ideadband) / (127 - ideadband);
+    return ireading < 0 ? -t : t;
+  }
+
+  static constexpr std::int8_t round(const double ivalue) {
+    return static_cast<std::int8_t>(ivalue < 0 ? ivalue - 0.5 : ivalue + 0.5);
+  }
+
+  /**
+   * e^x for x from -k to 0, by series, since `std::exp` isn't constexpr.
+   */
+  static constexpr double exp(const double ix) {
+    // e^x = (e^(x/16))^16, with the series only needing to cover |x/16| <= 1
+    const double x = ix / 16;
+    double sum = 1;
+    double term = 1;
+    for (int n = 1; n < 20; n++) {
+      term *= x / n;
+      sum += term;
+    }
+    for (int i = 0; i < 4; i++) {
+      sum *= sum;
+    }
+    return sum;
+  }
+};
+
+/**
+ * Shapes driver stick readings into drive motor power for each side:
+ *  - a response curve (InputCurve) with a deadband, looked up per stick,
+ *  - a slew limit on how fast each side's power may change per tick, with separate limits for
+ *    speeding up and for slowing down or reversing, so a hard direction change doesn't spin the
+ *    wheels or tip the robot,
+ *  - optionally, traction limiting: while a side draws more current than the limit, e.x. because
+ *    its wheels are pushing against something or about to break loose, its power is scaled down
+ *    by the limit over the current.
+ *
+ *   DriveInputShaper shaper(InputCurve::cubic(5, 0.6));
+ *   ...
+ *   const auto power = shaper.tank(master.get_analog(ANALOG_LEFT_Y),
+ *                                  master.get_analog(ANALOG_RIGHT_Y));
+ *   left_motor1.move(power.left);
+ *
+ * Everything at run time is integer math on a few values, so it is cheap to call every tick.
+ */
+class DriveInputShaper {
+  public:
+  struct Power {
+    int left{0};
+    int right{0};
+  };
+
+  struct Limits {
+    int accelStep{127}; // most power a side may gain per tick
+    int decelStep{127}; // most power a side may lose per tick, including through zero
+    int currentMa{0};   // a side's current draw to start cutting power back at, or 0 for none
+  };
+
+  /**
+   * Shapes with the curve alone, without slew or traction limits.
+   *
+   * @param icurve The stick response.
+   */
+  explicit DriveInputShaper(const InputCurve &icurve);
+
+  /**
+   * @param icurve The stick response.
+   * @param ilimits The slew and traction limits.
+   */
+  DriveInputShaper(const InputCurve &icurve, Limits ilimits);
+
+  /**
+   * Shapes a tick of tank drive, one stick per side.
+   *
+   * @param ileft The left stick's reading.
+   * @param iright The right stick's reading.
+   * @param ileftMa The left side's current draw, for traction limiting.
+   * @param irightMa The right side's current draw.
+   * @return Each side's power, -127 to 127.
+   */
+  Power tank(int ileft, int iright, int ileftMa = 0, int irightMa = 0);
+
+  /**
+   * Shapes a tick of arcade drive. Power and turn are each shaped by the curve, then mixed; when a
+   * side would go past full power, both are scaled down together so the turn keeps its share.
+   *
+   * @param ipower The forward stick's reading.
+   * @param iturn The turn stick's reading, positive to turn right.
+   * @param ileftMa The left side's current draw, for traction limiting.
+   * @param irightMa The right side's current draw.
+   * @return Each side's power, -127 to 127.
+   */
+  Power arcade(int ipower, int iturn, int ileftMa = 0, int irightMa = 0);
+
+  /**
+   * Forgets the last power sent, e.x. when driver control starts, so the first tick slews from 0.
+   */
+  void reset();
+
+  void setLimits(Limits ilimits);
+
+  const Limits &getLimits() const;
+
+  protected:
+  InputCurve curve;
+  Limits limits;
+  Power last;
+
+  /**
+   * @return The side's power after the slew and traction limits, given what it was last tick.
+   */
+  int limit(int itarget, int ilast, int icurrentMa) const;
+
+  Power apply(int ileft, int iright, int ileftMa, int irightMa);
+};
+
+static_assert(InputCurve::linear().isWellFormed(), "linear curve is malformed");
+static_assert(InputCurve::linear(10).isWellFormed(), "linear curve with deadband is malformed");
+static_assert(InputCurve::linear(10)(10) == 0 && InputCurve::linear(10)(-10) == 0,
+              "deadband doesn't give 0");
+static_assert(InputCurve::linear(10)(11) == 1, "deadband doesn't stretch the rest of the range");
+static_assert(InputCurve::linear()(-128) == -127, "-128 isn't read as -127");
+static_assert(InputCurve::linear()(64) == 64, "linear curve isn't linear");
+static_assert(InputCurve::cubic(5, 0.6).isWellFormed(), "cubic curve is malformed");
+static_assert(InputCurve::cubic(0, 1)(64) == 16, "cubic curve isn't cubic");
+static_assert(InputCurve::expo(5, 3).isWellFormed(), "expo curve is malformed");
+static_assert(InputCurve::expo(0, 0)(64) == 64, "expo with k = 0 isn't linear");
+static_assert(InputCurve::expo(0, 3)(64) < InputCurve::cubic(0, 0.5)(64),
+              "expo curve doesn't soften the middle of the range");
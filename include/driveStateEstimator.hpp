@@ -0,0 +1,112 @@
+#pragma once
+
+#include "fixedKalmanFilter.hpp"
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/units/QAcceleration.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <cstdint>
+
+/**
+ * Estimates each drive side's position, velocity and acceleration with a FixedKalmanFilter, fusing
+ *  - the tracking wheels' encoder ticks, which measure position precisely but only in whole ticks,
+ *  - the drive motors' integrated encoder velocities, which are direct but noisy and slip with
+ *    the wheels,
+ *  - optionally, the IMU's yaw rate, which ties the two sides' velocities together.
+ *
+ * Each side is modeled as moving at constant acceleration between steps, with white jerk. Nothing
+ * is allocated, and a step is a few microseconds, so it keeps up with a 5 or 10 ms loop.
+ */
+class DriveStateEstimator {
+  public:
+  struct Config {
+    okapi::ChassisScales trackingScales{{2.75 * okapi::inch, 5.25 * okapi::inch},
+                                        okapi::quadEncoderTPR};
+    okapi::QLength driveWheelDiameter{4 * okapi::inch};
+    double driveGearRatio{1};  // wheel rpm per motor rpm
+    double jerkNoise{30};      // process noise spectral density, m/s^3 / sqrt(Hz)
+    double tickNoise{0.5};     // tracking wheel quantization, ticks
+    double velocityNoise{5};   // drive motor velocity, rpm
+    double yawRateNoise{2};    // IMU yaw rate, deg/s
+  };
+
+  /**
+   * One side's estimate.
+   */
+  struct SideState {
+    okapi::QLength position;
+    okapi::QSpeed velocity;
+    okapi::QAcceleration acceleration;
+  };
+
+  /**
+   * Runs the default Config, which matches main.cpp's chassis.
+   */
+  DriveStateEstimator();
+
+  /**
+   * @param iconfig The chassis' dimensions and its sensors' noise.
+   */
+  explicit DriveStateEstimator(const Config &iconfig);
+
+  /**
+   * Advances the estimate by `idt`, then corrects it with every reading. The first call after
+   * construction or `reset()` zeroes the tracking wheels at their current ticks.
+   *
+   * @param idt The time since the last step.
+   * @param ileftTicks The left tracking wheel's ticks.
+   * @param irightTicks The right tracking wheel's ticks.
+   * @param ileftVelocity The left drive motors' velocity, rpm.
+   * @param irightVelocity The right drive motors' velocity, rpm.
+   * @param iyawRate The IMU's yaw rate, clockwise positive like okapi's odometry, or NaN for none.
+   */
+  void step(okapi::QTime idt,
+            std::int32_t ileftTicks,
+            std::int32_t irightTicks,
+            double ileftVelocity,
+            double irightVelocity,
+            okapi::QAngularSpeed iyawRate);
+
+  /*
+   * The parts of `step()`, for sensors which read at different rates. Call `predict()` once per
+   * loop, then the updates for whichever readings are new.
+   */
+  void predict(okapi::QTime idt);
+  void updateTicks(std::int32_t ileftTicks, std::int32_t irightTicks);
+  void updateVelocities(double ileftVelocity, double irightVelocity);
+  void updateYawRate(okapi::QAngularSpeed iyawRate);
+
+  /**
+   * Forgets the estimate. The next tick reading becomes zero.
+   */
+  void reset();
+
+  SideState getLeft() const;
+  SideState getRight() const;
+
+  /**
+   * @return The chassis' yaw rate the estimate implies, clockwise positive.
+   */
+  okapi::QAngularSpeed getYawRate() const;
+
+  const Config &getConfig() const;
+
+  protected:
+  // State: left position, velocity, acceleration, then the same for the right side, in SI units
+  static constexpr std::size_t states = 6;
+  using Filter = FixedKalmanFilter<states>;
+
+  Config config;
+  double metersPerTick;
+  double metersPerSecondPerRpm;
+  Filter filter;
+  bool started{false};
+  std::int32_t startLeft{0};
+  std::int32_t startRight{0};
+
+  SideState side(std::size_t ioffset) const;
+
+  static Filter::Covariance initialCovariance();
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "okapi/api/chassis/controller/odomChassisController.hpp"
+#include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include <atomic>
+
+/**
+ * An AsyncMotionProfileController which follows paths closed-loop. Instead of commanding each
+ * segment's velocity open-loop, every segment drives the side motors with a voltage made of
+ * feed-forward on the segment's velocity and acceleration, PD feedback on the distance each side
+ * is behind or ahead of the profile, and a heading correction from odometry.
+ *
+ * Requires a SkidSteerModel (the model ChassisControllerBuilder makes for two encoders).
+ */
+class FeedbackMotionProfileController : public okapi::AsyncMotionProfileController {
+  public:
+  /**
+   * Follower gains. Outputs are in volts; distances are in meters along each side's profile.
+   */
+  struct Gains {
+    double kP{0};    // volts per meter of position error
+    double kD{0};    // volts per meter/second of position error rate
+    double kV{0};    // volts per meter/second of profile velocity
+    double kA{0};    // volts per meter/second^2 of profile acceleration
+    double kS{0};    // volts to overcome static friction, applied in the direction of travel
+    double kTurn{0}; // volts per radian of heading error, added to one side and removed from the other
+  };
+
+  /**
+   * The tracking error of the last path followed.
+   */
+  struct TrackingError {
+    double finalLeft{0};  // meters
+    double finalRight{0}; // meters
+    double finalHeading{0}; // radians
+    double maxDistance{0};  // meters, worst side over the whole path
+  };
+
+  /**
+   * Builds the controller. Call `startThread()` afterwards, as AsyncMotionProfileControllerBuilder
+   * would.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param ilimits The default limits.
+   * @param ichassis The odometry chassis to drive; its model, scales, gearset and heading are used.
+   * @param igains The follower gains.
+   * @param ilogger The logger tracking error is logged to.
+   */
+  FeedbackMotionProfileController(
+    const okapi::TimeUtil &itimeUtil,
+    const okapi::PathfinderLimits &ilimits,
+    const std::shared_ptr<okapi::OdomChassisController> &ichassis,
+    const Gains &igains,
+    const std::shared_ptr<okapi::Logger> &ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Sets new follower gains. They are picked up by the next path.
+   */
+  void setGains(const Gains &igains);
+
+  /**
+   * @return The follower gains.
+   */
+  Gains getGains() const;
+
+  /**
+   * @return The tracking error of the last path that finished.
+   */
+  TrackingError getTrackingError() const;
+
+  protected:
+  std::shared_ptr<okapi::OdomChassisController> chassis;
+  Gains gains;
+  TrackingError trackingError;
+  mutable CrossplatformMutex gainsMutex;
+
+  void executeSinglePath(const TrajectoryPair &path,
+                         std::unique_ptr<okapi::AbstractRate> rate) override;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "fixedMatrix.hpp"
+
+/**
+ * A Kalman filter over N states, with its matrices sized at compile time so it never allocates.
+ * Unlike okapi::EKFFilter, which filters one value with constant noise, the model and noise are
+ * supplied on every step, so they can follow the loop's dt.
+ *
+ * Each sensor is a separate `update()` with its own measurement size M, so sensors which read at
+ * different rates, or sometimes not at all, are fused as their readings arrive. For an extended
+ * Kalman filter, pass the nonlinear model's prediction alongside its Jacobian.
+ *
+ * @tparam N The number of states.
+ */
+template <std::size_t N> class FixedKalmanFilter {
+  public:
+  using State = FixedVector<N>;
+  using Covariance = FixedMatrix<N, N>;
+
+  /**
+   * @param istate The initial state estimate.
+   * @param icovariance The initial estimate's covariance; large for states which aren't known.
+   */
+  FixedKalmanFilter(const State &istate, const Covariance &icovariance)
+    : state(istate), covariance(icovariance) {
+  }
+
+  /**
+   * Advances the estimate by a linear model: x = F x.
+   *
+   * @param itransition The state transition, F.
+   * @param iprocessNoise The covariance of the model's error over this step, Q.
+   */
+  void predict(const Covariance &itransition, const Covariance &iprocessNoise) {
+    predict(itransition * state, itransition, iprocessNoise);
+  }
+
+  /**
+   * Advances the estimate by a nonlinear model: x = f(x).
+   *
+   * @param ipredicted The model's prediction, f(x).
+   * @param ijacobian The model's Jacobian at x, F.
+   * @param iprocessNoise The covariance of the model's error over this step, Q.
+   */
+  void predict(const State &ipredicted,
+               const Covariance &ijacobian,
+               const Covariance &iprocessNoise) {
+    state = ipredicted;
+    covariance = ijacobian * covariance * ijacobian.transpose() + iprocessNoise;
+  }
+
+  /**
+   * Corrects the estimate with a measurement which is linear in the state: z = H x.
+   *
+   * @param imeasurement The measurement, z.
+   * @param iobservation The observation model, H.
+   * @param inoise The measurement's covariance, R.
+   * @return Whether the measurement was used; it isn't if its innovation covariance is singular.
+   */
+  template <std::size_t M>
+  bool update(const FixedVector<M> &imeasurement,
+              const FixedMatrix<M, N> &iobservation,
+              const FixedMatrix<M, M> &inoise) {
+    return update(imeasurement, iobservation * state, iobservation, inoise);
+  }
+
+  /**
+   * Corrects the estimate with a measurement which is nonlinear in the state: z = h(x).
+   *
+   * @param imeasurement The measurement, z.
+   * @param iexpected The measurement the estimate predicts, h(x).
+   * @param ijacobian The observation model's Jacobian at x, H.
+   * @param inoise The measurement's covariance, R.
+   * @return Whether the measurement was used; it isn't if its innovation covariance is singular.
+   */
+  template <std::size_t M>
+  bool update(const FixedVector<M> &imeasurement,
+              const FixedVector<M> &iexpected,
+              const FixedMatrix<M, N> &ijacobian,
+              const FixedMatrix<M, M> &inoise) {
+    const FixedMatrix<N, M> crossCovariance = covariance * ijacobian.transpose();
+    FixedMatrix<M, M> innovationInverse;
+    if (!(ijacobian * crossCovariance + inoise).invert(innovationInverse)) {
+      return false;
+    }
+
+    const FixedMatrix<N, M> gain = crossCovariance * innovationInverse;
+    state += gain * (imeasurement - iexpected);
+    covariance -= gain * (ijacobian * covariance);
+
+    // Keep round-off from making the covariance asymmetric
+    for (std::size_t r = 0; r < N; r++) {
+      for (std::size_t c = r + 1; c < N; c++) {
+        const double mean = (covariance(r, c) + covariance(c, r)) / 2;
+        covariance(r, c) = mean;
+        covariance(c, r) = mean;
+      }
+    }
+    return true;
+  }
+
+  const State &getState() const {
+    return state;
+  }
+
+  const Covariance &getCovariance() const {
+    return covariance;
+  }
+
+  /**
+   * Replaces the estimate, e.x. when the robot is placed somewhere known.
+   */
+  void reset(const State &istate, const Covariance &icovariance) {
+    state = istate;
+    covariance = icovariance;
+  }
+
+  protected:
+  State state;
+  Covariance covariance;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+/**
+ * A matrix with its dimensions fixed at compile time, stored inline in row-major order, so
+ * matrices live on the stack or in their owner and nothing is allocated. Dimension mismatches are
+ * compile errors. Meant for the small matrices of state estimation, e.x. a 6x6 covariance; every
+ * operation is a plain loop the compiler can unroll.
+ */
+template <std::size_t R, std::size_t C> class FixedMatrix {
+  public:
+  static constexpr std::size_t rows = R;
+  static constexpr std::size_t cols = C;
+
+  FixedMatrix() = default;
+
+  /**
+   * @param ivalues The elements in row-major order, e.x. `{1, 2, 3, 4}` for [[1, 2], [3, 4]].
+   */
+  FixedMatrix(const std::array<double, R * C> &ivalues) : data(ivalues) {
+  }
+
+  static FixedMatrix identity() {
+    static_assert(R == C, "Only a square matrix has an identity");
+    FixedMatrix out;
+    for (std::size_t i = 0; i < R; i++) {
+      out(i, i) = 1;
+    }
+    return out;
+  }
+
+  double &operator()(const std::size_t irow, const std::size_t icol) {
+    return data[irow * C + icol];
+  }
+
+  double operator()(const std::size_t irow, const std::size_t icol) const {
+    return data[irow * C + icol];
+  }
+
+  /**
+   * Indexes a column vector.
+   */
+  double &operator[](const std::size_t i) {
+    static_assert(C == 1, "Only a vector has one index");
+    return data[i];
+  }
+
+  double operator[](const std::size_t i) const {
+    static_assert(C == 1, "Only a vector has one index");
+    return data[i];
+  }
+
+  FixedMatrix<C, R> transpose() const {
+    FixedMatrix<C, R> out;
+    for (std::size_t r = 0; r < R; r++) {
+      for (std::size_t c = 0; c < C; c++) {
+        out(c, r) = (*this)(r, c);
+      }
+    }
+    return out;
+  }
+
+  FixedMatrix &operator+=(const FixedMatrix &rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] += rhs.data[i];
+    }
+    return *this;
+  }
+
+  FixedMatrix &operator-=(const FixedMatrix &rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] -= rhs.data[i];
+    }
+    return *this;
+  }
+
+  FixedMatrix &operator*=(const double rhs) {
+    for (double &value : data) {
+      value *= rhs;
+    }
+    return *this;
+  }
+
+  /**
+   * Inverts a square matrix by Gauss-Jordan elimination with partial pivoting.
+   *
+   * @param oinverse The inverse, if there is one.
+   * @return Whether the matrix could be inverted; false if it is singular.
+   */
+  bool invert(FixedMatrix &oinverse) const {
+    static_assert(R == C, "Only a square matrix has an inverse");
+    FixedMatrix a = *this;
+    oinverse = identity();
+    for (std::size_t col = 0; col < R; col++) {
+      std::size_t pivot = col;
+      for (std::size_t r = col + 1; r < R; r++) {
+        if (std::abs(a(r, col)) > std::abs(a(pivot, col))) {
+          pivot = r;
+        }
+      }
+      if (a(pivot, col) == 0) {
+        return false;
+      }
+      if (pivot != col) {
+        for (std::size_t c = 0; c < R; c++) {
+          std::swap(a(pivot, c), a(col, c));
+          std::swap(oinverse(pivot, c), oinverse(col, c));
+        }
+      }
+
+      const double scale = 1 / a(col, col);
+      for (std::size_t c = 0; c < R; c++) {
+        a(col, c) *= scale;
+        oinverse(col, c) *= scale;
+      }
+      for (std::size_t r = 0; r < R; r++) {
+        const double factor = a(r, col);
+        if (r == col || factor == 0) {
+          continue;
+        }
+        for (std::size_t c = 0; c < R; c++) {
+          a(r, c) -= factor * a(col, c);
+          oinverse(r, c) -= factor * oinverse(col, c);
+        }
+      }
+    }
+    return true;
+  }
+
+  std::array<double, R * C> data{};
+};
+
+template <std::size_t N> using FixedVector = FixedMatrix<N, 1>;
+
+template <std::size_t R, std::size_t C>
+FixedMatrix<R, C> operator+(FixedMatrix<R, C> lhs, const FixedMatrix<R, C> &rhs) {
+  return lhs += rhs;
+}
+
+template <std::size_t R, std::size_t C>
+FixedMatrix<R, C> operator-(FixedMatrix<R, C> lhs, const FixedMatrix<R, C> &rhs) {
+  return lhs -= rhs;
+}
+
+template <std::size_t R, std::size_t C>
+FixedMatrix<R, C> operator*(FixedMatrix<R, C> lhs, const double rhs) {
+  return lhs *= rhs;
+}
+
+template <std::size_t R, std::size_t K, std::size_t C>
+FixedMatrix<R, C> operator*(const FixedMatrix<R, K> &lhs, const FixedMatrix<K, C> &rhs) {
+  FixedMatrix<R, C> out;
+  for (std::size_t r = 0; r < R; r++) {
+    for (std::size_t k = 0; k < K; k++) {
+      const double value = lhs(r, k);
+      for (std::size_t c = 0; c < C; c++) {
+        out(r, c) += value * rhs(k, c);
+      }
+    }
+  }
+  return out;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "fixedSensorModel.hpp"
+#include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include <array>
+#include <memory>
+
+/**
+ * TwoEncoderOdometry without heap allocation. The stock step() reads the sensors into valarrays
+ * and does valarray arithmetic, allocating several times per step. This one reads a
+ * FixedSensorModel<2> into a std::array and does the same math on it.
+ *
+ * Everything else (state, scales, loop(), the maximum tick difference) is TwoEncoderOdometry's,
+ * so this drops in wherever a TwoEncoderOdometry is used.
+ */
+class FixedTwoEncoderOdometry : public okapi::TwoEncoderOdometry {
+  public:
+  /**
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading sensors, e.x. a FixedSkidSteerModel. It must
+   * implement both ReadOnlyChassisModel and FixedSensorModel<2>.
+   * @param ichassisScales The chassis dimensions.
+   * @param ilogger The logger this instance will log to.
+   */
+  template <typename M>
+  FixedTwoEncoderOdometry(const okapi::TimeUtil &itimeUtil,
+                          const std::shared_ptr<M> &imodel,
+                          const okapi::ChassisScales &ichassisScales,
+                          const std::shared_ptr<okapi::Logger> &ilogger =
+                            okapi::Logger::getDefaultLogger())
+    : TwoEncoderOdometry(itimeUtil, imodel, ichassisScales, ilogger), sensors(imodel) {
+  }
+
+  void step() override;
+
+  protected:
+  std::shared_ptr<const FixedSensorModel<2>> sensors;
+  std::array<std::int32_t, 2> lastSensors{};
+};
+
+/**
+ * ThreeEncoderOdometry without heap allocation, see FixedTwoEncoderOdometry.
+ */
+class FixedThreeEncoderOdometry : public okapi::ThreeEncoderOdometry {
+  public:
+  /**
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading sensors, e.x. a FixedThreeEncoderSkidSteerModel.
+   * It must implement both ReadOnlyChassisModel and FixedSensorModel<3>.
+   * @param ichassisScales The chassis dimensions (the middle wheel scale is the third member).
+   * @param ilogger The logger this instance will log to.
+   */
+  template <typename M>
+  FixedThreeEncoderOdometry(const okapi::TimeUtil &itimeUtil,
+                            const std::shared_ptr<M> &imodel,
+                            const okapi::ChassisScales &ichassisScales,
+                            const std::shared_ptr<okapi::Logger> &ilogger =
+                              okapi::Logger::getDefaultLogger())
+    : ThreeEncoderOdometry(itimeUtil, imodel, ichassisScales, ilogger), sensors(imodel) {
+  }
+
+  void step() override;
+
+  protected:
+  std::shared_ptr<const FixedSensorModel<3>> sensors;
+  std::array<std::int32_t, 3> lastSensors{};
+};
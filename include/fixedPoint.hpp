@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * A signed fixed-point number: a 32-bit integer counting units of 2^-fractionBits. Addition and
+ * subtraction are integer operations and multiplication and division go through 64 bits, so it
+ * works on the integer pipeline alone and is exact wherever the result is representable.
+ * Results out of range wrap around like integers; they aren't saturated.
+ *
+ * Everything is constexpr. Numbers convert in from any arithmetic type implicitly (rounding to the
+ * nearest unit), as float does from double, and out only explicitly.
+ *
+ * @tparam fractionBits The bits below the binary point. With 16 (Q16), the range is +-32768 and
+ * the resolution 1.5e-5.
+ */
+template <int fractionBits> class FixedPoint {
+  static_assert(fractionBits > 0 && fractionBits < 31, "FixedPoint needs an integer bit");
+
+  public:
+  static constexpr std::int32_t one = std::int32_t{1} << fractionBits;
+
+  constexpr FixedPoint() = default;
+
+  template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+  constexpr FixedPoint(const T ivalue) : raw(fromNumber(ivalue)) {
+  }
+
+  /**
+   * @param iraw The value in units of 2^-fractionBits.
+   */
+  static constexpr FixedPoint fromRaw(const std::int32_t iraw) {
+    FixedPoint out;
+    out.raw = iraw;
+    return out;
+  }
+
+  constexpr std::int32_t getRaw() const {
+    return raw;
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+  explicit constexpr operator T() const {
+    return static_cast<T>(raw) / one;
+  }
+
+  constexpr FixedPoint &operator+=(const FixedPoint rhs) {
+    raw += rhs.raw;
+    return *this;
+  }
+
+  constexpr FixedPoint &operator-=(const FixedPoint rhs) {
+    raw -= rhs.raw;
+    return *this;
+  }
+
+  constexpr FixedPoint &operator*=(const FixedPoint rhs) {
+    const std::int64_t product = static_cast<std::int64_t>(raw) * rhs.raw;
+    raw = static_cast<std::int32_t>((product + (one >> 1)) >> fractionBits);
+    return *this;
+  }
+
+  constexpr FixedPoint &operator/=(const FixedPoint rhs) {
+    raw = static_cast<std::int32_t>((static_cast<std::int64_t>(raw) << fractionBits) / rhs.raw);
+    return *this;
+  }
+
+  constexpr FixedPoint operator-() const {
+    return fromRaw(-raw);
+  }
+
+  protected:
+  std::int32_t raw{0};
+
+  template <typename T> static constexpr std::int32_t fromNumber(const T ivalue) {
+    if constexpr (std::is_integral<T>::value) {
+      return static_cast<std::int32_t>(ivalue * one);
+    } else {
+      const T scaled = ivalue * one;
+      return static_cast<std::int32_t>(scaled < 0 ? scaled - T(0.5) : scaled + T(0.5));
+    }
+  }
+};
+
+using Q16 = FixedPoint<16>;
+
+template <int F> constexpr FixedPoint<F> operator+(FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs += rhs;
+}
+
+template <int F> constexpr FixedPoint<F> operator-(FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs -= rhs;
+}
+
+template <int F> constexpr FixedPoint<F> operator*(FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs *= rhs;
+}
+
+template <int F> constexpr FixedPoint<F> operator/(FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs /= rhs;
+}
+
+template <int F> constexpr bool operator==(const FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs.getRaw() == rhs.getRaw();
+}
+
+template <int F> constexpr bool operator!=(const FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs.getRaw() != rhs.getRaw();
+}
+
+template <int F> constexpr bool operator<(const FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs.getRaw() < rhs.getRaw();
+}
+
+template <int F> constexpr bool operator>(const FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs.getRaw() > rhs.getRaw();
+}
+
+template <int F> constexpr bool operator<=(const FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs.getRaw() <= rhs.getRaw();
+}
+
+template <int F> constexpr bool operator>=(const FixedPoint<F> lhs, const FixedPoint<F> rhs) {
+  return lhs.getRaw() >= rhs.getRaw();
+}
+
+/*
+ * Math functions, found by argument-dependent lookup, so generic code can call them unqualified
+ * after `using std::sin;` and so on.
+ */
+
+template <int F> constexpr FixedPoint<F> abs(const FixedPoint<F> ivalue) {
+  return ivalue.getRaw() < 0 ? -ivalue : ivalue;
+}
+
+/**
+ * The square root, rounded down to a unit. Zero for negative numbers.
+ */
+template <int F> constexpr FixedPoint<F> sqrt(const FixedPoint<F> ivalue) {
+  if (ivalue.getRaw() <= 0) {
+    return FixedPoint<F>();
+  }
+
+  // sqrt(raw * 2^-F) * 2^F = sqrt(raw * 2^F), an integer square root bit by bit
+  std::uint64_t remainder = static_cast<std::uint64_t>(ivalue.getRaw()) << F;
+  std::uint64_t root = 0;
+  std::uint64_t bit = std::uint64_t{1} << 62;
+  while (bit > remainder) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (remainder >= root + bit) {
+      remainder -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return FixedPoint<F>::fromRaw(static_cast<std::int32_t>(root));
+}
+
+/**
+ * The sine of an angle in radians, to within a few units for F up to 20.
+ */
+template <int F> constexpr FixedPoint<F> sin(const FixedPoint<F> iradians) {
+  using Fixed = FixedPoint<F>;
+  constexpr Fixed pi = 3.14159265358979323846;
+  constexpr Fixed halfPi = 3.14159265358979323846 / 2;
+  constexpr std::int32_t twoPiRaw = Fixed(2 * 3.14159265358979323846).getRaw();
+
+  // Reduce to [-pi, pi], then fold onto [-pi/2, pi/2] where sin(x) = sin(pi - x)
+  std::int32_t raw = iradians.getRaw() % twoPiRaw;
+  if (raw > pi.getRaw()) {
+    raw -= twoPiRaw;
+  } else if (raw < -pi.getRaw()) {
+    raw += twoPiRaw;
+  }
+  Fixed x = Fixed::fromRaw(raw);
+  if (x > halfPi) {
+    x = pi - x;
+  } else if (x < -halfPi) {
+    x = -pi - x;
+  }
+
+  // Taylor series to x^9, its error is below 4e-6 on [-pi/2, pi/2]
+  const Fixed x2 = x * x;
+  Fixed sum = Fixed(1) - x2 * Fixed(1.0 / 72);
+  sum = Fixed(1) - x2 * Fixed(1.0 / 42) * sum;
+  sum = Fixed(1) - x2 * Fixed(1.0 / 20) * sum;
+  sum = Fixed(1) - x2 * Fixed(1.0 / 6) * sum;
+  return x * sum;
+}
+
+/**
+ * The cosine of an angle in radians, to within a few units for F up to 20.
+ */
+template <int F> constexpr FixedPoint<F> cos(const FixedPoint<F> iradians) {
+  return sin(iradians + FixedPoint<F>(3.14159265358979323846 / 2));
+}
+
+namespace std {
+template <int F> class numeric_limits<FixedPoint<F>> {
+  public:
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = true;
+
+  static constexpr FixedPoint<F> min() {
+    return FixedPoint<F>::fromRaw(1);
+  }
+
+  static constexpr FixedPoint<F> lowest() {
+    return FixedPoint<F>::fromRaw(std::numeric_limits<std::int32_t>::min());
+  }
+
+  static constexpr FixedPoint<F> max() {
+    return FixedPoint<F>::fromRaw(std::numeric_limits<std::int32_t>::max());
+  }
+
+  static constexpr FixedPoint<F> epsilon() {
+    return FixedPoint<F>::fromRaw(1);
+  }
+};
+} // namespace std
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/chassis/model/threeEncoderSkidSteerModel.hpp"
+#include <array>
+#include <cstdint>
+
+/**
+ * A chassis model whose N sensors can be read into a fixed-size array. Unlike
+ * ReadOnlyChassisModel::getSensorVals(), which returns a heap-allocated valarray, reading this way
+ * never allocates, so it is safe at odometry rate. The sensors are in the same order.
+ */
+template <std::size_t N> class FixedSensorModel {
+  public:
+  static constexpr std::size_t sensorCount = N;
+
+  virtual ~FixedSensorModel() = default;
+
+  /**
+   * Read the sensors.
+   *
+   * @return The sensor readings, in getSensorVals()'s order.
+   */
+  virtual std::array<std::int32_t, N> getSensorArray() const = 0;
+};
+
+/**
+ * A SkidSteerModel whose left and right sensors can also be read without allocating.
+ */
+class FixedSkidSteerModel : public okapi::SkidSteerModel, public FixedSensorModel<2> {
+  public:
+  using okapi::SkidSteerModel::SkidSteerModel;
+
+  std::array<std::int32_t, 2> getSensorArray() const override;
+};
+
+/**
+ * A ThreeEncoderSkidSteerModel whose left, right and middle sensors can also be read without
+ * allocating.
+ */
+class FixedThreeEncoderSkidSteerModel : public okapi::ThreeEncoderSkidSteerModel,
+                                        public FixedSensorModel<3> {
+  public:
+  using okapi::ThreeEncoderSkidSteerModel::ThreeEncoderSkidSteerModel;
+
+  std::array<std::int32_t, 3> getSensorArray() const override;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+/**
+ * Text formatted into a buffer of N bytes held inline, for building LCD lines and log messages in
+ * loops without `std::to_string` or string concatenation, which allocate. Formatting is snprintf,
+ * and text past the buffer is cut off, never allocated.
+ *
+ *   FixedString<32> line("%d", left_encoder.get());
+ *   pros::c::lcd_set_text(5, line.c_str());
+ *
+ * @tparam N The buffer size, including the terminating null.
+ */
+template <std::size_t N> class FixedString {
+  static_assert(N > 0, "FixedString needs room for the terminating null");
+
+  public:
+  FixedString() = default;
+
+  /**
+   * Formats the text, as `format()`.
+   */
+  __attribute__((format(printf, 2, 3))) explicit FixedString(const char *ifmt, ...) {
+    va_list args;
+    va_start(args, ifmt);
+    vappend(ifmt, args);
+    va_end(args);
+  }
+
+  /**
+   * Replaces the text with a printf format's output.
+   */
+  __attribute__((format(printf, 2, 3))) FixedString &format(const char *ifmt, ...) {
+    clear();
+    va_list args;
+    va_start(args, ifmt);
+    vappend(ifmt, args);
+    va_end(args);
+    return *this;
+  }
+
+  /**
+   * Adds a printf format's output to the end.
+   */
+  __attribute__((format(printf, 2, 3))) FixedString &append(const char *ifmt, ...) {
+    va_list args;
+    va_start(args, ifmt);
+    vappend(ifmt, args);
+    va_end(args);
+    return *this;
+  }
+
+  FixedString &operator+=(const std::string_view itext) {
+    const std::size_t room = N - 1 - length;
+    const std::size_t copied = itext.size() < room ? itext.size() : room;
+    itext.copy(&buffer[length], copied);
+    length += copied;
+    buffer[length] = '\0';
+    cut = cut || copied < itext.size();
+    return *this;
+  }
+
+  void clear() {
+    length = 0;
+    buffer[0] = '\0';
+    cut = false;
+  }
+
+  const char *c_str() const {
+    return buffer.data();
+  }
+
+  std::size_t size() const {
+    return length;
+  }
+
+  static constexpr std::size_t capacity() {
+    return N - 1;
+  }
+
+  /**
+   * @return Whether some text didn't fit and was cut off.
+   */
+  bool truncated() const {
+    return cut;
+  }
+
+  operator std::string_view() const {
+    return std::string_view(buffer.data(), length);
+  }
+
+  protected:
+  std::array<char, N> buffer{};
+  std::size_t length{0};
+  bool cut{false};
+
+  void vappend(const char *ifmt, va_list iargs) {
+    const int wanted = vsnprintf(&buffer[length], N - length, ifmt, iargs);
+    if (wanted < 0) {
+      buffer[length] = '\0';
+      return;
+    }
+    const std::size_t room = N - 1 - length;
+    if (static_cast<std::size_t>(wanted) > room) {
+      length += room;
+      cut = true;
+    } else {
+      length += static_cast<std::size_t>(wanted);
+    }
+  }
+};
+
+/*
+ * Parsing text in place through string_views, so reading a file line by line needs no
+ * std::string per line or per field.
+ */
+
+/**
+ * @return The text without leading and trailing spaces, tabs and line endings.
+ */
+std::string_view trimText(std::string_view itext);
+
+/**
+ * Splits the first field off a line. Delimiters before the field are skipped, so runs of spaces
+ * separate fields like single ones.
+ *
+ * @param ioline The line. The field and the delimiter after it are removed from the front.
+ * @param idelimiter What separates fields.
+ * @return The field, empty once the line has no more.
+ */
+std::string_view nextField(std::string_view &ioline, char idelimiter = ' ');
+
+/**
+ * Reads a whole field as a number, e.x. `"0.25"` or `" -3 "`.
+ *
+ * @return Whether the field was a number, with nothing else in it but spaces.
+ */
+bool parseNumber(std::string_view ifield, double &ovalue);
+
+bool parseNumber(std::string_view ifield, std::int32_t &ovalue);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "okapi/api/filter/velMath.hpp"
+#include <cstddef>
+#include <vector>
+
+/**
+ * A VelMath which fits a line or a parabola to the last few (timestamp, position) samples by least
+ * squares, instead of differencing two positions over the loop's dt and filtering the result. The
+ * fit's slope at the newest sample is the velocity and, for a parabola, its curvature is the
+ * acceleration.
+ *
+ * Every sample keeps its own timestamp, so a late loop iteration or a sensor which updates slower
+ * than the loop doesn't show up as a velocity spike. Pass the time the sensor took the reading
+ * where it is known, e.x. from motor_get_raw_position:
+ *
+ *   std::uint32_t timestamp;
+ *   const std::int32_t ticks = motor_get_raw_position(port, &timestamp);
+ *   velMath.step(ticks, timestamp * millisecond);
+ *
+ * A sample with the same timestamp as the previous one is a reading the sensor hasn't updated yet,
+ * so it is skipped. Otherwise `step(double)` timestamps samples with the loop dt timer.
+ *
+ * Longer windows average out more of an encoder's quantization at the cost of more lag; a parabola
+ * lags less than a line over the same window but is noisier. tools/velocityBenchmark measures both
+ * on a recorded sensor log.
+ */
+class LeastSquaresVelMath : public okapi::VelMath {
+  public:
+  /**
+   * Throws a `std::invalid_argument` exception if `iticksPerRev` is zero, or if the window is too
+   * short for the fit.
+   *
+   * @param iticksPerRev The number of ticks per revolution (or whatever units you are using).
+   * @param iwindow The number of samples to fit, at least `iorder + 1`.
+   * @param iloopDtTimer The timer which timestamps samples given to `step(double)`.
+   * @param iorder 1 to fit a line (acceleration reads zero), 2 to fit a parabola.
+   * @param ilogger The logger this instance will log to.
+   */
+  LeastSquaresVelMath(
+    double iticksPerRev,
+    std::size_t iwindow,
+    std::unique_ptr<okapi::AbstractTimer> iloopDtTimer,
+    int iorder = 2,
+    std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Adds a sample timestamped now and refits. Returns the velocity.
+   *
+   * @param inewPos The new position measurement.
+   * @return The new velocity estimate.
+   */
+  okapi::QAngularSpeed step(double inewPos) override;
+
+  /**
+   * Adds a sample the sensor took at `itimestamp` and refits. Returns the velocity.
+   *
+   * @param inewPos The new position measurement.
+   * @param itimestamp When the sensor measured it, on any clock which only moves forwards.
+   * @return The new velocity estimate.
+   */
+  okapi::QAngularSpeed step(double inewPos, okapi::QTime itimestamp);
+
+  /**
+   * Forgets every sample. The velocity and acceleration read zero until there are two again.
+   */
+  void reset();
+
+  protected:
+  struct Sample {
+    double time; // seconds
+    double position;
+  };
+
+  std::vector<Sample> samples; // a ring of the last `window` samples
+  std::size_t window;
+  int order;
+  std::size_t newest{0};
+  std::size_t count{0};
+
+  /**
+   * Fits the samples, relative to the newest one, and updates vel and accel.
+   */
+  void fit();
+};
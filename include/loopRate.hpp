@@ -0,0 +1,154 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "timingStats.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+
+/**
+ * Paces a loop to a fixed period and records how well it holds it.
+ *
+ * `pros::delay(10)` after a variable amount of work makes the period 10 ms plus the work, so it
+ * drifts with whatever the loop does that time around. A LoopRate wakes the loop on a fixed
+ * schedule with `Task::delay_until` instead, and on every wake records two things in
+ * microseconds:
+ *  - jitter, how far the period since the last wake was from the nominal one,
+ *  - work, how long the loop ran before asking to wait; work longer than the period is an overrun.
+ * With allocation counting built in (see AllocationCounter), it also records how many heap
+ * allocations each iteration made.
+ *
+ *   LoopRate rate("driver");
+ *   while (true) {
+ *     ...
+ *     rate.delayUntilNext();
+ *   }
+ *
+ * It is also an okapi::AbstractRate, so it can replace `timeUtil.getRate()` in loops written
+ * against okapi, wrapping the rate the TimeUtil supplies.
+ *
+ * Loops are recorded by name and period in a fixed table, which keeps a loop's timing after its
+ * LoopRate is gone, so a helper which makes a LoopRate on every call adds to the same line each
+ * time. `printAll()` prints a line per loop to the terminal. Loops past `maxLoops` share the last
+ * line, printed as "other loops". The table's stats take about 3 KiB a loop.
+ */
+class LoopRate : public okapi::AbstractRate {
+  public:
+  static constexpr std::size_t maxLoops = 32;
+
+  /**
+   * Waits with `Task::delay_until`.
+   *
+   * @param iname The name in reports. It is kept, not copied, so it must last as long as the
+   * program, e.x. a string literal.
+   * @param iperiodMs The period of `delayUntilNext()`.
+   */
+  explicit LoopRate(const char *iname, std::uint32_t iperiodMs = 10);
+
+  /**
+   * Waits with another rate, e.x. `timeUtil.getRate()`, so simulated time still applies.
+   */
+  LoopRate(const char *iname,
+           std::unique_ptr<okapi::AbstractRate> irate,
+           std::uint32_t iperiodMs = 10);
+
+  LoopRate(const LoopRate &) = delete;
+  LoopRate &operator=(const LoopRate &) = delete;
+  ~LoopRate() override;
+
+  /**
+   * Waits until one period after the last wake.
+   */
+  void delayUntilNext();
+
+  void delay(okapi::QFrequency ihz) override;
+
+  void delayUntil(okapi::QTime itime) override;
+
+  /**
+   * Waits until `ims` after the last wake. The first call waits from now.
+   */
+  void delayUntil(uint32_t ims) override;
+
+  /**
+   * Forgets the recorded timing, for every LoopRate with this name and period.
+   */
+  void clearStats();
+
+  const char *getName() const;
+
+  /**
+   * @return How many times loops with this name and period have woken.
+   */
+  std::uint32_t getCount() const;
+
+  /**
+   * @return How far each period was from the nominal one, with more than a millisecond off
+   * counted over the limit.
+   */
+  TimingStats getJitter() const;
+
+  /**
+   * @return How long the loop worked each time, with work longer than the period counted over
+   * the limit.
+   */
+  TimingStats getWork() const;
+
+  /**
+   * @return How many allocations each iteration made, with any at all counted over the limit.
+   * Empty unless AllocationCounter is enabled.
+   */
+  TimingStats getAllocations() const;
+
+  /**
+   * Writes a one-line summary short enough for the LCD, e.x. `driver 10ms jit99 80us 0 over`,
+   * followed by the iterations which allocated when allocations are counted.
+   *
+   * @return The length written, as snprintf().
+   */
+  int format(char *obuffer, std::size_t isize) const;
+
+  /**
+   * Prints a line per loop recorded since startup: its period, jitter, work and allocations.
+   */
+  static void printAll(FILE *ifile = stdout);
+
+  protected:
+  /**
+   * A line of the table, shared by every LoopRate with its name and period.
+   */
+  struct Stats {
+    const char *name{nullptr};
+    std::uint32_t periodMs{0};
+    std::uint32_t count{0};
+    TimingStats jitter;
+    TimingStats work;
+    TimingStats allocations;
+    CrossplatformMutex lock;
+  };
+
+  struct Table;
+
+  const char *name;
+  std::unique_ptr<okapi::AbstractRate> rate;
+  std::uint32_t periodMs;
+  std::uint32_t lastTime{0}; // for delay_until
+  bool started{false};
+  std::uint64_t wakeUs{0};
+  std::uint32_t wakeAllocations{0};
+  Stats *stats;
+
+  /**
+   * @return The table, made on first use, so LoopRates constructed during static initialization
+   * find it.
+   */
+  static Table &table();
+
+  /**
+   * @return The line for a name and period, added if there isn't one yet.
+   */
+  static Stats &statsFor(const char *iname, std::uint32_t iperiodMs);
+
+  static void print(FILE *ifile, Stats &istats);
+};
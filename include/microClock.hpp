@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Microseconds since the brain started, for timing code too short for okapi's millisecond timers.
+ * PROS 3.2 only has `millis()`, so on the V5 this reads the SDK's high resolution timer. Built with
+ * THREADS_STD it counts from the first call on std::chrono::steady_clock instead.
+ */
+std::uint64_t microClock();
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "autonTimeline.hpp"
+#include "okapi/api/chassis/controller/odomChassisController.hpp"
+#include "predictiveSettledUtil.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * Runs chassis motions one after another with predictive settling, and optionally chains them:
+ * the next motion starts as soon as the current one is predicted to arrive within the blend time,
+ * instead of after it has fully settled. Each motion is timed, including how long it spent
+ * waiting to settle after first reaching the target band.
+ *
+ * Motions are started with the chassis' async calls and tracked with the chassis model's
+ * encoders, so the chassis' own PID gains and max velocity still apply. A motion which settles
+ * stops the chassis' controllers, so nothing fights whatever drives the motors next. A blended
+ * motion leaves them running for the next motion to retarget, so a chained sequence ends with
+ * `waitUntilSettled()` or `stop()`.
+ *
+ * A motion held short of its band, e.x. by steady-state error or by pushing into a wall, gives up
+ * once its error has held still for 250 ms or it has run for the timeout, and stops the chassis as
+ * if it had settled. The report keeps the last `reportSize` motions.
+ */
+class MotionChain {
+  public:
+  /**
+   * One completed motion.
+   */
+  struct Record {
+    std::string name;
+    std::uint32_t startMs{0};  // since the chain was created or the report was cleared
+    std::uint32_t totalMs{0};  // start of the motion until the next one could start
+    std::uint32_t settleMs{0}; // first entering the target band until settled or blended
+    bool blended{false};       // whether the next motion started before this one settled
+    bool stalled{false};       // whether it gave up short of the band, stalled or out of time
+  };
+
+  static constexpr std::size_t reportSize = 64;
+
+  /**
+   * @param ichassis The chassis to drive.
+   * @param itimeUtil The TimeUtil for timers and the sample rate.
+   * @param idistanceBand Distance error band to settle in.
+   * @param iangleBand Angle error band to settle in.
+   * @param iblendTime How early before the predicted arrival a chained motion hands off.
+   * @param itimeout The longest a motion may run before giving up.
+   */
+  MotionChain(std::shared_ptr<okapi::OdomChassisController> ichassis,
+              const okapi::TimeUtil &itimeUtil,
+              okapi::QLength idistanceBand = 1 * okapi::centimeter,
+              okapi::QAngle iangleBand = 2 * okapi::degree,
+              okapi::QTime iblendTime = 100 * okapi::millisecond,
+              okapi::QTime itimeout = 4 * okapi::second);
+
+  /**
+   * Drives a distance and returns once settled or, when chaining, once blended.
+   */
+  void moveDistance(okapi::QLength itarget);
+
+  /**
+   * Turns by an angle and returns once settled or, when chaining, once blended.
+   */
+  void turnAngle(okapi::QAngle itarget);
+
+  /**
+   * Turns to an absolute odometry heading and returns once settled or, when chaining, once
+   * blended.
+   */
+  void turnToAngle(okapi::QAngle iangle);
+
+  /**
+   * Waits for the chassis itself to settle, e.x. at the end of a chained sequence.
+   */
+  void waitUntilSettled();
+
+  /**
+   * Stops the chassis' controllers where they are, e.x. to end a chained sequence early.
+   */
+  void stop();
+
+  /**
+   * Sets whether motions blend into the next one instead of settling fully. Turning it off while a
+   * blended motion is still running stops the chassis.
+   */
+  void setChaining(bool ichaining);
+
+  /**
+   * Records each motion on a timeline's drive lane as well, or on none when null.
+   */
+  void setTimeline(AutonTimeline *itimeline);
+
+  /**
+   * @return The recorded motions, oldest first.
+   */
+  const std::vector<Record> &getReport() const;
+
+  /**
+   * Prints one line per recorded motion plus the total settle wait to stdout.
+   */
+  void printReport() const;
+
+  /**
+   * Clears the recorded motions and restarts the report clock.
+   */
+  void clearReport();
+
+  protected:
+  enum class Kind { distance, angle };
+
+  std::shared_ptr<okapi::OdomChassisController> chassis;
+  okapi::TimeUtil timeUtil;
+  std::unique_ptr<okapi::AbstractTimer> reportTimer;
+  PredictiveSettledUtil distanceSettled;
+  PredictiveSettledUtil angleSettled;
+  okapi::QTime blendTime;
+  okapi::QTime timeout;
+  bool chaining{false};
+  double carriedDistance{0}; // mm left over from a blended distance motion
+  bool blending{false};      // whether the last motion blended, so the chassis is still driving it
+  std::vector<Record> report;
+  AutonTimeline *timeline{nullptr};
+
+  /**
+   * Starts a motion with the chassis and tracks it until it settles or blends.
+   *
+   * @param ikind Whether the target is a distance in mm or an angle in degrees.
+   * @param itarget The target.
+   * @param iname The name to record the motion under.
+   * @return The error left when the motion finished.
+   */
+  double run(Kind ikind, double itarget, std::string iname);
+
+  /**
+   * @return The distance in mm and angle in degrees travelled since `istart`.
+   */
+  std::pair<double, double> travelled(const std::valarray<std::int32_t> &istart) const;
+};
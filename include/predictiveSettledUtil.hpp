@@ -0,0 +1,61 @@
+#pragma once
+
+#include "okapi/api/control/util/settledUtil.hpp"
+#include <cstddef>
+
+/**
+ * A SettledUtil which predicts arrival instead of always waiting out `atTargetTime`. The error is
+ * expected to be sampled at a fixed period. When the error is inside the target band, is changing
+ * slowly enough, and its current trend keeps it inside the band for the next `horizon` samples,
+ * the controller is considered settled after only `confirmSamples` such samples. Otherwise the
+ * usual dwell-time rule of SettledUtil applies.
+ */
+class PredictiveSettledUtil : public okapi::SettledUtil {
+  public:
+  /**
+   * @param iatTargetTimer A timer used for the dwell-time fallback.
+   * @param iatTargetError The error band to settle in.
+   * @param iatTargetDerivative The largest change in error per sample that can settle.
+   * @param iatTargetTime The dwell time for the fallback rule.
+   * @param isamplePeriod The period `isSettled()` is called at, used to predict arrival times.
+   * @param iconfirmSamples How many consecutive predicted-settled samples are needed.
+   * @param ihorizon How many samples ahead the error trend must stay in the band.
+   */
+  explicit PredictiveSettledUtil(std::unique_ptr<okapi::AbstractTimer> iatTargetTimer,
+                                 double iatTargetError = 50,
+                                 double iatTargetDerivative = 5,
+                                 okapi::QTime iatTargetTime = 250 * okapi::millisecond,
+                                 okapi::QTime isamplePeriod = 10 * okapi::millisecond,
+                                 std::size_t iconfirmSamples = 3,
+                                 double ihorizon = 5);
+
+  /**
+   * Returns whether the controller has settled, by prediction or by dwell time.
+   *
+   * @param ierror The current error.
+   * @return Whether the controller is settled.
+   */
+  bool isSettled(double ierror) override;
+
+  /**
+   * Resets the prediction and the dwell timer.
+   */
+  void reset() override;
+
+  /**
+   * Estimates how long until the error enters the target band at its current rate of change.
+   * Returns zero if it is already in the band and infinity if the error is not shrinking.
+   *
+   * @return The predicted time until arrival.
+   */
+  okapi::QTime getPredictedArrival() const;
+
+  protected:
+  okapi::QTime samplePeriod;
+  std::size_t confirmSamples;
+  double horizon;
+  std::size_t predictedCount{0};
+  double lastSample{0};
+  double lastDerivative{0};
+  bool haveSample{false};
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A piecewise-linear map from a mechanism sensor (e.x. the angler potentiometer) to the angle of
+ * the motor that drives it, in motor degrees. Points are sorted by sensor value; values outside
+ * the table are extrapolated from the nearest segment.
+ */
+class CalibrationTable {
+  public:
+  CalibrationTable() = default;
+
+  /**
+   * @param ipoints (sensor value, motor degrees) pairs. The sensor values must be distinct.
+   */
+  explicit CalibrationTable(std::vector<std::pair<double, double>> ipoints);
+
+  /**
+   * A table for a mechanism whose sensor already reads in motor degrees.
+   */
+  static CalibrationTable identity();
+
+  /**
+   * Loads a table saved with `save()`. Returns an empty table if the file can't be read.
+   *
+   * @param ifileName The file to read, e.x. `/usd/tray.cal`.
+   */
+  static CalibrationTable load(const std::string &ifileName);
+
+  /**
+   * Saves the table as one `sensor degrees` pair per line.
+   *
+   * @param ifileName The file to write.
+   * @return Whether the file was written.
+   */
+  bool save(const std::string &ifileName) const;
+
+  /**
+   * Adds a sample while recording a calibration sweep. Samples whose sensor value is already in
+   * the table are ignored.
+   */
+  void addPoint(double isensor, double idegrees);
+
+  /**
+   * @return Whether the table has enough points to convert positions.
+   */
+  bool isCalibrated() const;
+
+  /**
+   * Converts a sensor reading to motor degrees.
+   */
+  double toDegrees(double isensor) const;
+
+  protected:
+  std::vector<std::pair<double, double>> points;
+};
+
+/**
+ * Moves a mechanism along jerk-limited profiles instead of fixed-speed velocity loops. Targets are
+ * absolute positions in sensor units; the distance to travel is converted to motor revolutions
+ * through the calibration table and followed by an AsyncLinearMotionProfileController whose
+ * "meters" are motor revolutions (build it with a diameter of `1_m / 1_pi`).
+ */
+class ProfiledMechanism {
+  public:
+  /**
+   * @param icontroller The profile controller driving the mechanism motor.
+   * @param isensor Reads the current mechanism position in sensor units.
+   * @param itable Converts sensor units to motor degrees.
+   * @param ideadband Moves shorter than this (in motor degrees) are skipped.
+   */
+  ProfiledMechanism(std::shared_ptr<okapi::AsyncLinearMotionProfileController> icontroller,
+                    std::function<double()> isensor,
+                    CalibrationTable itable,
+                    double ideadband = 2);
+
+  /**
+   * Starts moving to the target and returns. A move that is still running is stopped first, which
+   * waits a few of the controller's 10 ms loops for it to let go of its path, and the new profile
+   * starts from wherever that leaves the mechanism. Tasks calling this at once take turns, so
+   * the last call's target is the one the mechanism ends up moving to.
+   *
+   * @param itarget The target position in sensor units.
+   */
+  void setTarget(double itarget);
+
+  /**
+   * Blocks until the current profile has finished.
+   */
+  void waitUntilSettled();
+
+  /**
+   * @return Whether the current profile has finished.
+   */
+  bool isSettled();
+
+  /**
+   * @return The last target passed to `setTarget()`, in sensor units.
+   */
+  double getTarget() const;
+
+  /**
+   * Replaces the calibration table, e.x. after a calibration sweep.
+   */
+  void setCalibration(CalibrationTable itable);
+
+  /**
+   * @return The calibration table in use.
+   */
+  const CalibrationTable &getCalibration() const;
+
+  protected:
+  std::shared_ptr<okapi::AsyncLinearMotionProfileController> controller;
+  std::function<double()> sensor;
+  CalibrationTable table;
+  double deadband;
+  double target{0};
+  // Moves alternate between two paths, so a new one is never generated over the path the
+  // controller last ran
+  const std::array<std::string, 2> pathIds{{"move a", "move b"}};
+  std::size_t nextPath{0};
+  // Held from stopping the old move to removing its path, so two moves can't swap paths midway
+  CrossplatformMutex moveLock;
+
+  /**
+   * Stops the move in progress, if any, and waits until the controller's task is no longer
+   * following it.
+   */
+  void stop();
+};
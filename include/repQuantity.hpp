@@ -0,0 +1,380 @@
+#pragma once
+
+#include "okapi/api/units/RQuantity.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ratio>
+
+/**
+ * okapi::RQuantity with its value stored as `Rep` instead of always double, e.x. float, which the
+ * V5's NEON unit works in, or a FixedPoint. Dimensions are checked at compile time exactly as for
+ * RQuantity, and quantities of different representations don't mix implicitly: convert them with
+ * `quantityCast()`.
+ *
+ * Spell a type with the okapi quantity it stores, e.x. `Quantity<float, QLength>`. okapi's units
+ * and literals stay double; convert them once, outside any loop, e.x.
+ *
+ *   constexpr auto track = quantityCast<float>(5.25_in);
+ *   constexpr auto meterF = quantityCast<float>(meter);
+ *
+ * Every operation is constexpr. RQuantity itself is unchanged, so okapi's API still takes and
+ * returns doubles.
+ */
+template <typename Rep, typename MassDim, typename LengthDim, typename TimeDim, typename AngleDim>
+class RepQuantity {
+  public:
+  using rep = Rep;
+  using DoubleQuantity = okapi::RQuantity<MassDim, LengthDim, TimeDim, AngleDim>;
+
+  constexpr RepQuantity() : value(0) {
+  }
+
+  explicit constexpr RepQuantity(const Rep ivalue) : value(ivalue) {
+  }
+
+  constexpr RepQuantity &operator+=(const RepQuantity &rhs) {
+    value += rhs.value;
+    return *this;
+  }
+
+  constexpr RepQuantity &operator-=(const RepQuantity &rhs) {
+    value -= rhs.value;
+    return *this;
+  }
+
+  constexpr RepQuantity operator-() const {
+    return RepQuantity(-value);
+  }
+
+  constexpr RepQuantity &operator*=(const Rep rhs) {
+    value *= rhs;
+    return *this;
+  }
+
+  constexpr RepQuantity &operator/=(const Rep rhs) {
+    value /= rhs;
+    return *this;
+  }
+
+  /**
+   * Returns the value of the quantity in multiples of an okapi unit, e.x. `x.convert(inch)`.
+   */
+  constexpr Rep convert(const DoubleQuantity &iunit) const {
+    return value * static_cast<Rep>(1 / iunit.getValue());
+  }
+
+  /**
+   * Returns the quantity as a double okapi::RQuantity, for okapi's API.
+   */
+  constexpr DoubleQuantity toRQuantity() const {
+    return DoubleQuantity(static_cast<double>(value));
+  }
+
+  // Returns the raw value of the quantity, in SI units
+  constexpr Rep getValue() const {
+    return value;
+  }
+
+  constexpr RepQuantity abs() const {
+    using std::abs;
+    return RepQuantity(abs(value));
+  }
+
+  constexpr RepQuantity<Rep,
+                        std::ratio_divide<MassDim, std::ratio<2>>,
+                        std::ratio_divide<LengthDim, std::ratio<2>>,
+                        std::ratio_divide<TimeDim, std::ratio<2>>,
+                        std::ratio_divide<AngleDim, std::ratio<2>>>
+  sqrt() const {
+    using std::sqrt;
+    return RepQuantity<Rep,
+                       std::ratio_divide<MassDim, std::ratio<2>>,
+                       std::ratio_divide<LengthDim, std::ratio<2>>,
+                       std::ratio_divide<TimeDim, std::ratio<2>>,
+                       std::ratio_divide<AngleDim, std::ratio<2>>>(sqrt(value));
+  }
+
+  protected:
+  Rep value;
+};
+
+namespace detail {
+template <typename Rep, typename Q> struct WithRep;
+
+template <typename Rep, typename M, typename L, typename T, typename A>
+struct WithRep<Rep, okapi::RQuantity<M, L, T, A>> {
+  using type = RepQuantity<Rep, M, L, T, A>;
+};
+
+// Keeps a scalar parameter out of template argument deduction, so e.x. `2 * x` works for a float x
+template <typename T> struct Identity { using type = T; };
+template <typename T> using Scalar = typename Identity<T>::type;
+} // namespace detail
+
+/**
+ * The RepQuantity storing `Rep` for an okapi quantity type, e.x. `Quantity<float, QSpeed>`.
+ */
+template <typename Rep, typename Q> using Quantity = typename detail::WithRep<Rep, Q>::type;
+
+/**
+ * Converts an okapi quantity to one stored as `To`.
+ */
+template <typename To, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<To, M, L, T, A> quantityCast(const okapi::RQuantity<M, L, T, A> &iquantity) {
+  return RepQuantity<To, M, L, T, A>(static_cast<To>(iquantity.getValue()));
+}
+
+/**
+ * Converts a quantity to the same one stored as `To`.
+ */
+template <typename To, typename From, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<To, M, L, T, A> quantityCast(const RepQuantity<From, M, L, T, A> &iquantity) {
+  return RepQuantity<To, M, L, T, A>(static_cast<To>(iquantity.getValue()));
+}
+
+// Arithmetic, as for RQuantity, between quantities of one representation:
+// ------------------------------------------------------------------------
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<R, M, L, T, A> operator+(RepQuantity<R, M, L, T, A> lhs,
+                                               const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs += rhs;
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<R, M, L, T, A> operator-(RepQuantity<R, M, L, T, A> lhs,
+                                               const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs -= rhs;
+}
+
+template <typename R,
+          typename M1,
+          typename L1,
+          typename T1,
+          typename A1,
+          typename M2,
+          typename L2,
+          typename T2,
+          typename A2>
+constexpr RepQuantity<R,
+                      std::ratio_add<M1, M2>,
+                      std::ratio_add<L1, L2>,
+                      std::ratio_add<T1, T2>,
+                      std::ratio_add<A1, A2>>
+operator*(const RepQuantity<R, M1, L1, T1, A1> &lhs, const RepQuantity<R, M2, L2, T2, A2> &rhs) {
+  return RepQuantity<R,
+                     std::ratio_add<M1, M2>,
+                     std::ratio_add<L1, L2>,
+                     std::ratio_add<T1, T2>,
+                     std::ratio_add<A1, A2>>(lhs.getValue() * rhs.getValue());
+}
+
+template <typename R,
+          typename M1,
+          typename L1,
+          typename T1,
+          typename A1,
+          typename M2,
+          typename L2,
+          typename T2,
+          typename A2>
+constexpr RepQuantity<R,
+                      std::ratio_subtract<M1, M2>,
+                      std::ratio_subtract<L1, L2>,
+                      std::ratio_subtract<T1, T2>,
+                      std::ratio_subtract<A1, A2>>
+operator/(const RepQuantity<R, M1, L1, T1, A1> &lhs, const RepQuantity<R, M2, L2, T2, A2> &rhs) {
+  return RepQuantity<R,
+                     std::ratio_subtract<M1, M2>,
+                     std::ratio_subtract<L1, L2>,
+                     std::ratio_subtract<T1, T2>,
+                     std::ratio_subtract<A1, A2>>(lhs.getValue() / rhs.getValue());
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<R, M, L, T, A> operator*(const detail::Scalar<R> &lhs,
+                                               const RepQuantity<R, M, L, T, A> &rhs) {
+  return RepQuantity<R, M, L, T, A>(lhs * rhs.getValue());
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<R, M, L, T, A> operator*(const RepQuantity<R, M, L, T, A> &lhs,
+                                               const detail::Scalar<R> &rhs) {
+  return RepQuantity<R, M, L, T, A>(lhs.getValue() * rhs);
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<R, M, L, T, A> operator/(const RepQuantity<R, M, L, T, A> &lhs,
+                                               const detail::Scalar<R> &rhs) {
+  return RepQuantity<R, M, L, T, A>(lhs.getValue() / rhs);
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr RepQuantity<R,
+                      std::ratio_subtract<std::ratio<0>, M>,
+                      std::ratio_subtract<std::ratio<0>, L>,
+                      std::ratio_subtract<std::ratio<0>, T>,
+                      std::ratio_subtract<std::ratio<0>, A>>
+operator/(const detail::Scalar<R> &lhs, const RepQuantity<R, M, L, T, A> &rhs) {
+  return RepQuantity<R,
+                     std::ratio_subtract<std::ratio<0>, M>,
+                     std::ratio_subtract<std::ratio<0>, L>,
+                     std::ratio_subtract<std::ratio<0>, T>,
+                     std::ratio_subtract<std::ratio<0>, A>>(lhs / rhs.getValue());
+}
+
+// Comparison operators:
+// ---------------------
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr bool operator==(const RepQuantity<R, M, L, T, A> &lhs,
+                          const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs.getValue() == rhs.getValue();
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr bool operator!=(const RepQuantity<R, M, L, T, A> &lhs,
+                          const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs.getValue() != rhs.getValue();
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr bool operator<(const RepQuantity<R, M, L, T, A> &lhs,
+                         const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs.getValue() < rhs.getValue();
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr bool operator>(const RepQuantity<R, M, L, T, A> &lhs,
+                         const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs.getValue() > rhs.getValue();
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr bool operator<=(const RepQuantity<R, M, L, T, A> &lhs,
+                          const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs.getValue() <= rhs.getValue();
+}
+
+template <typename R, typename M, typename L, typename T, typename A>
+constexpr bool operator>=(const RepQuantity<R, M, L, T, A> &lhs,
+                          const RepQuantity<R, M, L, T, A> &rhs) {
+  return lhs.getValue() >= rhs.getValue();
+}
+
+// Trigonometry on angles, which are stored in radians:
+// -----------------------------------------------------
+template <typename R>
+constexpr R sin(
+  const RepQuantity<R, std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>> &iangle) {
+  using std::sin;
+  return sin(iangle.getValue());
+}
+
+template <typename R>
+constexpr R cos(
+  const RepQuantity<R, std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>> &iangle) {
+  using std::cos;
+  return cos(iangle.getValue());
+}
+
+/**
+ * A view of contiguous values as quantities of type Q, e.x. a column of a log or a buffer shared
+ * with simd::. Values are stored bare, in SI units, so the same memory can go to code which
+ * doesn't know about units; indexing reads and writes them as Q.
+ */
+template <typename Q> class QuantitySpan {
+  public:
+  using rep = typename Q::rep;
+
+  /**
+   * Reads and writes one element as a Q.
+   */
+  class Reference {
+    public:
+    explicit constexpr Reference(rep &ivalue) : value(ivalue) {
+    }
+
+    constexpr operator Q() const {
+      return Q(value);
+    }
+
+    constexpr Reference &operator=(const Q &iquantity) {
+      value = iquantity.getValue();
+      return *this;
+    }
+
+    constexpr Reference &operator+=(const Q &iquantity) {
+      value += iquantity.getValue();
+      return *this;
+    }
+
+    constexpr Reference &operator-=(const Q &iquantity) {
+      value -= iquantity.getValue();
+      return *this;
+    }
+
+    protected:
+    rep &value;
+  };
+
+  constexpr QuantitySpan(rep *idata, const std::size_t isize) : data(idata), count(isize) {
+  }
+
+  template <std::size_t N>
+  constexpr QuantitySpan(std::array<rep, N> &iarray) : data(iarray.data()), count(N) {
+  }
+
+  constexpr Reference operator[](const std::size_t i) const {
+    return Reference(data[i]);
+  }
+
+  constexpr std::size_t size() const {
+    return count;
+  }
+
+  /**
+   * @return The bare values, in SI units.
+   */
+  constexpr rep *values() const {
+    return data;
+  }
+
+  protected:
+  rep *data;
+  std::size_t count;
+};
+
+/**
+ * A fixed-size array of quantities of type Q, stored as bare values like QuantitySpan's.
+ */
+template <typename Q, std::size_t N> class QuantityArray {
+  public:
+  using rep = typename Q::rep;
+
+  constexpr typename QuantitySpan<Q>::Reference operator[](const std::size_t i) {
+    return typename QuantitySpan<Q>::Reference(storage[i]);
+  }
+
+  constexpr Q operator[](const std::size_t i) const {
+    return Q(storage[i]);
+  }
+
+  static constexpr std::size_t size() {
+    return N;
+  }
+
+  constexpr QuantitySpan<Q> span() {
+    return QuantitySpan<Q>(storage);
+  }
+
+  constexpr rep *values() {
+    return storage.data();
+  }
+
+  constexpr const rep *values() const {
+    return storage.data();
+  }
+
+  protected:
+  std::array<rep, N> storage{};
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <array>
+#include <cstddef>
+
+/**
+ * okapi::AverageFilter<n> in O(1) per reading: a running sum adds the new reading and subtracts
+ * the one leaving the window, instead of re-summing all n every time.
+ *
+ * Floating-point round-off would build up in the running sum, so it is recomputed from the window
+ * every time the window wraps around, once every n readings. The output then stays within a few
+ * ULPs of okapi::AverageFilter's.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t n> class RunningAverageFilter : public okapi::Filter {
+  static_assert(n > 0, "RunningAverageFilter needs at least one tap");
+
+  public:
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    sum += ireading - data[index];
+    data[index] = ireading;
+    if (++index >= n) {
+      index = 0;
+      sum = 0;
+      for (const double reading : data) {
+        sum += reading;
+      }
+    }
+
+    output = sum / static_cast<double>(n);
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  std::array<double, n> data{};
+  std::size_t index{0};
+  double sum{0};
+  double output{0};
+};
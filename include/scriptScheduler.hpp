@@ -0,0 +1,174 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Starts a script's body. Everything from here to `SCRIPT_END` may wait with `SCRIPT_AWAIT`,
+ * `SCRIPT_DELAY` and `SCRIPT_YIELD`.
+ */
+#define SCRIPT_BEGIN(script)                                                                       \
+  switch ((script).resumeAt) {                                                                     \
+  case 0:
+
+/**
+ * Waits until a condition holds, checking it once a tick. Only one wait may be on a line, since
+ * the line number is where the script picks up again.
+ */
+#define SCRIPT_AWAIT(script, condition)                                                            \
+  do {                                                                                             \
+    (script).resumeAt = __LINE__;                                                                  \
+    [[fallthrough]];                                                                               \
+  case __LINE__:                                                                                   \
+    if (!(condition)) {                                                                            \
+      return false;                                                                                \
+    }                                                                                              \
+  } while (0)
+
+/**
+ * Waits a time in ms.
+ */
+#define SCRIPT_DELAY(script, ims)                                                                  \
+  do {                                                                                             \
+    (script).wakeMs = (script).now + (ims);                                                        \
+    SCRIPT_AWAIT(script, (script).now >= (script).wakeMs);                                         \
+  } while (0)
+
+/**
+ * Gives the other scripts the rest of this tick and picks up on the next one.
+ */
+#define SCRIPT_YIELD(script)                                                                       \
+  do {                                                                                             \
+    (script).resumeAt = __LINE__;                                                                  \
+    return false;                                                                                  \
+  case __LINE__:;                                                                                  \
+  } while (0)
+
+/**
+ * Ends a script's body.
+ */
+#define SCRIPT_END(script)                                                                         \
+  }                                                                                                \
+  return true
+
+/**
+ * Runs autonomous actions as scripts which take turns on one task, instead of giving each action
+ * a `pros::Task` of its own and the `TASK_STACK_DEPTH_DEFAULT` (32 KiB) stack that comes with it.
+ *
+ * A script is a function the scheduler calls once a tick. Its waits return to the scheduler, and
+ * the next call jumps back to the wait it stopped at, so it still reads top to bottom:
+ *
+ *   scheduler.spawn("stack", [](ScriptScheduler::Script &s) {
+ *     SCRIPT_BEGIN(s);
+ *     tray.move_velocity(200);
+ *     SCRIPT_AWAIT(s, angler.get_value() >= 1850);
+ *     tray.move_velocity(0);
+ *     SCRIPT_DELAY(s, 125);
+ *     chassis->moveDistanceAsync(-0.2_m);
+ *     SCRIPT_AWAIT(s, chassis->isSettled());
+ *     chassis->stop(); // isSettled() doesn't end the move, as waitUntilSettled() does
+ *     SCRIPT_END(s);
+ *   });
+ *   scheduler.run();
+ *
+ * These are stackless coroutines in the style of protothreads, since the V5 toolchain's C++17 has
+ * no `co_await`. The cost of that is that nothing on the stack lives through a wait: locals must be
+ * declared in a block which doesn't contain one, and state a script keeps across waits goes in the
+ * lambda's captures, declared `mutable`. A script mustn't block either, e.x. with `pros::delay` or
+ * `waitUntilSettled()`, since every other script waits with it.
+ *
+ * Scripts are stored in a buffer reserved up front, and spawning more than it holds throws. A
+ * script may spawn others, which start in the same tick. Spawning and running are meant for one
+ * task, the one calling `run()`, so nothing here is locked.
+ */
+class ScriptScheduler {
+  public:
+  using ScriptId = std::size_t;
+
+  struct Script;
+
+  /**
+   * A script's body. Returns true once the script has finished; the macros do that.
+   */
+  using Body = std::function<bool(Script &)>;
+
+  struct Script {
+    const char *name;
+    Body body;
+    int resumeAt{0};         // the line of the wait to pick up at, set by the macros
+    std::uint32_t now{0};    // ms since the scheduler's clock started, as of this tick
+    std::uint32_t wakeMs{0}; // when `SCRIPT_DELAY` ends
+    std::uint32_t startMs{0};
+    std::uint32_t endMs{0};
+    std::uint32_t resumes{0}; // how many ticks it has been called on
+    bool finished{false};
+  };
+
+  /**
+   * @param itimeUtil The TimeUtil for the clock and the tick rate.
+   * @param icapacity The most scripts to hold between `clear()`s.
+   */
+  explicit ScriptScheduler(const okapi::TimeUtil &itimeUtil, std::size_t icapacity = 16);
+
+  ScriptScheduler(const ScriptScheduler &) = delete;
+  ScriptScheduler &operator=(const ScriptScheduler &) = delete;
+
+  /**
+   * Adds a script, which starts on the next tick, or on this one when a script spawns it.
+   *
+   * @param iname The name in the report; the string must outlive the script.
+   * @param ibody The script.
+   * @return The script, for `isFinished()`.
+   */
+  ScriptId spawn(const char *iname, Body ibody);
+
+  /**
+   * @return Whether the script has finished, e.x. to wait on it with `SCRIPT_AWAIT`.
+   */
+  bool isFinished(ScriptId iscript) const;
+
+  /**
+   * @return Whether every script has finished.
+   */
+  bool isDone() const;
+
+  /**
+   * Calls every script which hasn't finished once.
+   */
+  void step();
+
+  /**
+   * Steps every 10 ms until every script has finished.
+   *
+   * @param itimeout How long to run for. Scripts left unfinished stay where they are.
+   * @return Whether every script finished in time.
+   */
+  bool run(okapi::QTime itimeout = 15 * okapi::second);
+
+  /**
+   * Removes every script and restarts the clock.
+   */
+  void clear();
+
+  /**
+   * @return The scripts, in the order they were spawned.
+   */
+  const std::vector<Script> &getScripts() const;
+
+  /**
+   * Prints a line per script with when it started and finished and how often it was resumed.
+   */
+  void printReport() const;
+
+  protected:
+  okapi::TimeUtil timeUtil;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  std::size_t capacity;
+  std::vector<Script> scripts;
+
+  std::uint32_t now() const;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "fixedOdometry.hpp"
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/filter.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/util/supplier.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * One sensor reading, everything the pipeline consumes.
+ */
+struct SensorSample {
+  std::uint32_t time;   // ms since recording started
+  std::int32_t leftTicks;  // left tracking wheel
+  std::int32_t rightTicks; // right tracking wheel
+  double leftPosition;  // left drive motor encoder, in the motor's encoder units
+  double rightPosition; // right drive motor encoder, in the motor's encoder units
+  double leftVelocity;  // left drive motor, rpm
+  double rightVelocity; // right drive motor, rpm
+  double heading;       // IMU rotation in degrees, NaN if the robot has no IMU
+};
+
+/**
+ * What the pipeline produces from one sample.
+ */
+struct PipelineOutput {
+  double x;             // m, odometry frame transformation
+  double y;             // m
+  double theta;         // deg
+  double leftVelocity;  // filtered, rpm
+  double rightVelocity; // filtered, rpm
+  double angle;         // angle (drive straight) controller output
+  double heading;       // heading hold controller output, 0 without an IMU
+};
+
+/**
+ * A recorded sample and what the pipeline produced from it on the robot.
+ */
+struct SensorRecord {
+  SensorSample sample;
+  PipelineOutput output;
+};
+
+/**
+ * The sensor processing the robot runs, as a pure function of the sample stream: odometry on the
+ * tracking wheels (FixedTwoEncoderOdometry, so stepping it doesn't allocate), a filter on each
+ * drive side's velocity, ChassisControllerPID's angle controller on the tracking wheel difference
+ * and a heading hold controller on the IMU.
+ *
+ * Every stage reads time from the samples' timestamps instead of the system clock, so the same
+ * samples produce the same outputs on the robot, in a host replay, and on every replay after
+ * that. Between the V5 and a host the results only differ where libm does (odometry's sin and cos).
+ */
+class SensorPipeline {
+  public:
+  struct Config {
+    okapi::ChassisScales scales{{2.75 * okapi::inch, 5.25 * okapi::inch}, okapi::quadEncoderTPR};
+    okapi::IterativePosPIDController::Gains angleGains{0.001, 0, 0.0001, 0};
+    okapi::IterativePosPIDController::Gains headingGains{0.02, 0, 0.001, 0}; // per degree
+    okapi::Supplier<std::unique_ptr<okapi::Filter>> velocityFilter{
+      []() -> std::unique_ptr<okapi::Filter> { return std::make_unique<okapi::EmaFilter>(0.5); }};
+  };
+
+  /**
+   * Runs the default Config, which matches main.cpp's chassis.
+   */
+  SensorPipeline();
+
+  /**
+   * @param iconfig The scales, gains and filter to run.
+   */
+  explicit SensorPipeline(const Config &iconfig);
+
+  SensorPipeline(const SensorPipeline &) = delete;
+  SensorPipeline &operator=(const SensorPipeline &) = delete;
+
+  /**
+   * Runs every stage on the next sample. The first sample after construction or `reset()` sets
+   * the origin: the odometry starts at (0, 0, 0) and the heading controller holds its heading.
+   *
+   * @return The outputs for this sample.
+   */
+  const PipelineOutput &step(const SensorSample &isample);
+
+  /*
+   * The stages `step()` runs, in order, for timing them separately. Each one must be called once
+   * per sample, `stepOdometry()` first.
+   */
+  void stepOdometry(const SensorSample &isample);
+  void stepFilters(const SensorSample &isample);
+  void stepControllers(const SensorSample &isample);
+
+  /**
+   * Returns the pipeline to its freshly constructed state.
+   */
+  void reset();
+
+  const PipelineOutput &getOutput() const;
+
+  const Config &getConfig() const;
+
+  protected:
+  class SampleModel;
+
+  Config config;
+  std::shared_ptr<std::uint32_t> now;
+  std::shared_ptr<SampleModel> model;
+  std::unique_ptr<FixedTwoEncoderOdometry> odometry;
+  std::unique_ptr<okapi::Filter> leftFilter;
+  std::unique_ptr<okapi::Filter> rightFilter;
+  std::unique_ptr<okapi::IterativePosPIDController> angleController;
+  std::unique_ptr<okapi::IterativePosPIDController> headingController;
+  bool started{false};
+  std::int32_t startLeft{0};
+  std::int32_t startRight{0};
+  PipelineOutput output{};
+};
+
+/**
+ * Sensor logs as CSV. Doubles are written with 17 significant digits, so they read back exactly.
+ */
+class SensorLog {
+  public:
+  /**
+   * @param ifileName The file to write, e.x. `/usd/sensors.csv`.
+   * @return Whether the file was written.
+   */
+  static bool save(const std::string &ifileName, const std::vector<SensorRecord> &irecords);
+
+  /**
+   * @return The records in the file, or none if it can't be read.
+   */
+  static std::vector<SensorRecord> load(const std::string &ifileName);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "fixedSensorModel.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "sensorPipeline.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Records the drive's sensors every 10 ms and runs them through a SensorPipeline as they come in,
+ * keeping each sample with the outputs it produced. A log saved from the robot replays on the host
+ * with tools/sensorReplay, which checks that the same samples produce the same outputs there.
+ *
+ * Records are stored in a buffer reserved up front; once it is full further samples are dropped.
+ * With a FixedSkidSteerModel the encoders are read into a fixed array, so recording never
+ * allocates. Any other model is read through okapi's `getSensorVals()`, which allocates a valarray
+ * per sample.
+ */
+class SensorRecorder {
+  public:
+  /**
+   * @param itimeUtil The TimeUtil for timestamps and the sample rate.
+   * @param imodel The chassis, whose sensors are the tracking wheels. A FixedSkidSteerModel is
+   * read without allocating.
+   * @param iheading Reads the IMU's rotation in degrees, e.x. `[&] { return imu.get_rotation(); }`.
+   * Leave it empty on a robot without an IMU.
+   * @param icapacity The most samples to keep, 1500 is a whole autonomous period.
+   */
+  SensorRecorder(const okapi::TimeUtil &itimeUtil,
+                 std::shared_ptr<okapi::SkidSteerModel> imodel,
+                 std::function<double()> iheading = nullptr,
+                 std::size_t icapacity = 1500);
+
+  ~SensorRecorder();
+
+  /**
+   * Clears the records and starts recording in the background. The pipeline starts over from the
+   * first sample.
+   */
+  void start();
+
+  /**
+   * Stops recording. No sample is being taken once this returns, so the records can be read.
+   */
+  void stop();
+
+  bool isRecording() const;
+
+  /**
+   * Takes one sample now, for recording from the caller's own loop instead of `start()`.
+   */
+  void record();
+
+  /**
+   * Writes the records as a SensorLog.
+   *
+   * @param ifileName The file to write, e.x. `/usd/sensors.csv`.
+   * @return Whether the file was written.
+   */
+  bool save(const std::string &ifileName) const;
+
+  const std::vector<SensorRecord> &getRecords() const;
+
+  protected:
+  okapi::TimeUtil timeUtil;
+  std::shared_ptr<okapi::SkidSteerModel> model;
+  const FixedSensorModel<2> *fixedModel; // the model, if it can be read without allocating
+  std::function<double()> heading;
+  std::size_t capacity;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  okapi::QTime startTime;
+  SensorPipeline pipeline;
+  std::vector<SensorRecord> records;
+  mutable CrossplatformMutex recordsLock;
+  std::atomic_bool recording{false};
+  std::atomic_bool dying{false};
+  std::atomic_bool finished{false};
+  CrossplatformThread *task{nullptr};
+
+  void recordLocked();
+
+  static void trampoline(void *icontext);
+  void loop();
+};
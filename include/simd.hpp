@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * Four-lane single-precision vectors for the batch filters. On the V5 these are NEON registers
+ * driven through intrinsics: GCC won't use NEON for plain float arithmetic, vectorized or not,
+ * without -funsafe-math-optimizations, because NEON flushes denormals to zero. Elsewhere they are
+ * GCC vector extensions, so host tools run the same code.
+ *
+ * Every operation is also defined for a plain float, so one generic lambda passed to `forEach()`
+ * handles the full groups of four lanes and then the leftover scalars.
+ */
+namespace simd {
+template <typename V> V load(const float *iptr);
+template <typename V> V splat(float ivalue);
+
+#ifdef __ARM_NEON
+using f32x4 = float32x4_t;
+
+template <> inline f32x4 load<f32x4>(const float *iptr) {
+  return vld1q_f32(iptr);
+}
+
+inline void store(float *optr, const f32x4 ivalue) {
+  vst1q_f32(optr, ivalue);
+}
+
+template <> inline f32x4 splat<f32x4>(const float ivalue) {
+  return vdupq_n_f32(ivalue);
+}
+
+inline f32x4 add(const f32x4 a, const f32x4 b) {
+  return vaddq_f32(a, b);
+}
+
+inline f32x4 sub(const f32x4 a, const f32x4 b) {
+  return vsubq_f32(a, b);
+}
+
+inline f32x4 mul(const f32x4 a, const f32x4 b) {
+  return vmulq_f32(a, b);
+}
+
+inline f32x4 min(const f32x4 a, const f32x4 b) {
+  return vminq_f32(a, b);
+}
+
+inline f32x4 max(const f32x4 a, const f32x4 b) {
+  return vmaxq_f32(a, b);
+}
+#else
+typedef float f32x4 __attribute__((vector_size(16)));
+
+template <> inline f32x4 load<f32x4>(const float *iptr) {
+  f32x4 value;
+  std::memcpy(&value, iptr, sizeof(value));
+  return value;
+}
+
+inline void store(float *optr, const f32x4 ivalue) {
+  std::memcpy(optr, &ivalue, sizeof(ivalue));
+}
+
+template <> inline f32x4 splat<f32x4>(const float ivalue) {
+  return f32x4{ivalue, ivalue, ivalue, ivalue};
+}
+
+inline f32x4 add(const f32x4 a, const f32x4 b) {
+  return a + b;
+}
+
+inline f32x4 sub(const f32x4 a, const f32x4 b) {
+  return a - b;
+}
+
+inline f32x4 mul(const f32x4 a, const f32x4 b) {
+  return a * b;
+}
+
+inline f32x4 min(const f32x4 a, const f32x4 b) {
+  return a < b ? a : b;
+}
+
+inline f32x4 max(const f32x4 a, const f32x4 b) {
+  return a < b ? b : a;
+}
+#endif
+
+constexpr std::size_t lanes = 4;
+
+template <> inline float load<float>(const float *iptr) {
+  return *iptr;
+}
+
+template <> inline float splat<float>(const float ivalue) {
+  return ivalue;
+}
+
+inline void store(float *optr, const float ivalue) {
+  *optr = ivalue;
+}
+
+inline float add(const float a, const float b) {
+  return a + b;
+}
+
+inline float sub(const float a, const float b) {
+  return a - b;
+}
+
+inline float mul(const float a, const float b) {
+  return a * b;
+}
+
+inline float min(const float a, const float b) {
+  return a < b ? a : b;
+}
+
+inline float max(const float a, const float b) {
+  return a < b ? b : a;
+}
+
+/**
+ * Runs `ifn(V(), i)` over `count` elements: with V = f32x4 for each full group of four starting
+ * at i, then with V = float for each element left over.
+ */
+template <std::size_t count, typename F> inline void forEach(F &&ifn) {
+  std::size_t i = 0;
+  for (; i + lanes <= count; i += lanes) {
+    ifn(f32x4{}, i);
+  }
+  for (; i < count; i++) {
+    ifn(0.0f, i);
+  }
+}
+} // namespace simd
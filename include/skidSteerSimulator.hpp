@@ -0,0 +1,357 @@
+#pragma once
+
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Simulates a skid-steer drivetrain the way FlywheelSimulator simulates one link: call `step()`
+ * once per timestep and read the state back. Each side is a group of V5 motors driving its wheels
+ * directly. The model covers
+ *   - each gearset's linear torque–speed curve and the motor current limit,
+ *   - the V5 motor's own velocity and position loops for `moveVelocity` and `moveAbsolute`,
+ *   - wheel slip, with traction force limited by friction against the robot's weight,
+ *   - robot mass, yaw inertia and rolling resistance,
+ *   - battery sag from the internal resistance and the total motor current,
+ *   - tracking wheels which count whole encoder ticks.
+ *
+ * The pose is in the start frame: x forward, y to the left, theta counter-clockwise in radians.
+ * All state is guarded by a mutex, so controllers may command the simulated motors from their own
+ * threads while another thread steps the simulation.
+ */
+class SkidSteerSimulator {
+  public:
+  enum Side : std::size_t { left = 0, right = 1 };
+
+  struct Pose {
+    double x{0};     // m
+    double y{0};     // m
+    double theta{0}; // rad
+  };
+
+  /**
+   * @param igearset The drive motors' cartridge.
+   * @param imotorsPerSide The number of motors on each side.
+   * @param imass The robot's mass in kg.
+   * @param iinertia The robot's yaw moment of inertia in kg*m^2.
+   * @param iwheelDiameter The drive wheel diameter in m.
+   * @param iwheelTrack The distance between the left and right drive wheels in m.
+   * @param itimestep The timestep in sec.
+   */
+  explicit SkidSteerSimulator(okapi::AbstractMotor::gearset igearset =
+                                okapi::AbstractMotor::gearset::green,
+                              std::size_t imotorsPerSide = 2,
+                              double imass = 6.0,
+                              double iinertia = 0.15,
+                              double iwheelDiameter = 0.10478,
+                              double iwheelTrack = 0.30,
+                              double itimestep = 0.001);
+
+  virtual ~SkidSteerSimulator();
+
+  /**
+   * Steps the simulation by one timestep.
+   */
+  void step();
+
+  /**
+   * Steps the simulation by whole timesteps until `iseconds` more have been simulated.
+   *
+   * @param iseconds The time to simulate in sec.
+   */
+  void stepFor(double iseconds);
+
+  /**
+   * Drives one side open-loop.
+   *
+   * @param iside The side.
+   * @param ivolts The voltage, limited to the battery voltage.
+   */
+  void setVoltage(Side iside, double ivolts);
+
+  /**
+   * Runs one side's motors on their velocity loop.
+   *
+   * @param iside The side.
+   * @param irpm The target wheel speed in rpm.
+   */
+  void setVelocity(Side iside, double irpm);
+
+  /**
+   * Runs one side's motors on their position loop.
+   *
+   * @param iside The side.
+   * @param idegrees The target wheel angle in degrees.
+   * @param imaxRpm The speed limit on the way there in rpm.
+   */
+  void setPosition(Side iside, double idegrees, double imaxRpm);
+
+  /**
+   * Sets whether one side's motors brake (short their windings) at zero voltage instead of
+   * coasting.
+   */
+  void setBrake(Side iside, bool ibrake);
+
+  /**
+   * Sets the motor current limit in mA. 2500 mA is the V5 default.
+   */
+  void setCurrentLimit(double ilimit);
+
+  /**
+   * Sets the battery's open-circuit voltage and internal resistance in ohms.
+   */
+  void setBattery(double iopenCircuitVoltage, double iinternalResistance);
+
+  /**
+   * Sets the traction coefficient between the wheels and the field and the rolling resistance
+   * coefficient.
+   */
+  void setFriction(double itraction, double irolling);
+
+  /**
+   * Scales each side's motor torque, e.x. to model a weak motor or a rubbing gear.
+   */
+  void setTorqueScale(Side iside, double iscale);
+
+  /**
+   * Sets the tracking wheels.
+   *
+   * @param idiameter The tracking wheel diameter in m.
+   * @param itrack The distance between the left and right tracking wheels in m.
+   * @param itpr The encoder ticks per revolution.
+   */
+  void setTrackingWheels(double idiameter, double itrack, double itpr);
+
+  void setMass(double imass);
+
+  void setInertia(double iinertia);
+
+  void setWheelDiameter(double idiameter);
+
+  void setWheelTrack(double itrack);
+
+  void setTimestep(double itimestep);
+
+  void setPose(const Pose &ipose);
+
+  /**
+   * @return The true pose.
+   */
+  Pose getPose() const;
+
+  /**
+   * @return The simulated time since construction in sec.
+   */
+  double getTime() const;
+
+  /**
+   * @return The forward velocity in m/s.
+   */
+  double getVelocity() const;
+
+  /**
+   * @return The yaw rate in rad/s, counter-clockwise.
+   */
+  double getYawRate() const;
+
+  /**
+   * @return One side's wheel angle in degrees, as the motor encoders see it.
+   */
+  double getWheelPosition(Side iside) const;
+
+  /**
+   * @return One side's wheel speed in rpm.
+   */
+  double getWheelVelocity(Side iside) const;
+
+  /**
+   * @return One side's tracking wheel encoder count.
+   */
+  std::int32_t getTrackingTicks(Side iside) const;
+
+  /**
+   * @return The current drawn by one motor on a side in mA.
+   */
+  double getCurrent(Side iside) const;
+
+  /**
+   * @return The torque of one motor on a side in N*m.
+   */
+  double getTorque(Side iside) const;
+
+  /**
+   * @return The voltage applied to a side's motors in V.
+   */
+  double getAppliedVoltage(Side iside) const;
+
+  /**
+   * @return The battery voltage under the present load in V.
+   */
+  double getBatteryVoltage() const;
+
+  /**
+   * @return The drive motors' cartridge.
+   */
+  okapi::AbstractMotor::gearset getGearset() const;
+
+  /**
+   * Builds a SkidSteerModel whose motors and encoders are this simulation, so ChassisControllerPID,
+   * odometry and the motion profile controllers run against it unchanged.
+   *
+   * @param isim The simulation.
+   * @param itrackingWheels Whether the model's encoders are the tracking wheels or the motors'.
+   * @return The chassis model.
+   */
+  static std::shared_ptr<okapi::SkidSteerModel>
+  makeChassisModel(const std::shared_ptr<SkidSteerSimulator> &isim, bool itrackingWheels = true);
+
+  protected:
+  enum class Control { voltage, velocity, position };
+
+  struct SideState {
+    Control control{Control::voltage};
+    double target{0};          // V, rpm or degrees, per `control`
+    double maxRpm{0};          // position loop speed limit
+    bool brake{false};
+    double torqueScale{1};
+    double omega{0};           // wheel rad/s
+    double angle{0};           // wheel rad
+    double tracking{0};        // tracking wheel travel in m
+    double volts{0};           // applied
+    double torque{0};          // per motor N*m
+    double current{0};         // per motor A
+  };
+
+  mutable CrossplatformMutex mutex;
+  okapi::AbstractMotor::gearset gearset;
+  double motorsPerSide;
+  double mass;             // kg
+  double inertia;          // kg*m^2
+  double wheelDiameter;    // m
+  double wheelTrack;       // m
+  double timestep;         // sec
+  double stallTorque;      // N*m per motor at 12 V
+  double freeSpeed;        // rad/s at 12 V
+  double currentLimit{2.5};          // A
+  double openCircuitVoltage{12.8};   // V
+  double internalResistance{0.1};    // ohm
+  double traction{1.0};
+  double rolling{0.03};
+  double trackingDiameter{0.06985};  // m
+  double trackingTrack{0.13335};     // m
+  double trackingTpr{360};
+  double batteryVoltage{12.8};
+  double time{0};
+  double velocity{0}; // m/s
+  double yawRate{0};  // rad/s
+  Pose pose;
+  std::array<SideState, 2> sides;
+
+  static constexpr double nominalVoltage = 12;
+  static constexpr double stallCurrent = 2.5;  // A at the stall torque
+  static constexpr double wheelInertia = 0.002; // kg*m^2 per side, reflected through the cartridge
+  static constexpr double slipStiffness = 400;  // N per m/s of slip
+  static constexpr double yawScrub = 0.5;       // N*m per rad/s
+  static constexpr double velocityKp = 0.05;    // V per rpm of error
+  static constexpr double positionKp = 2;       // rpm per degree of error
+  static constexpr double minTimestep = 0.000001; // 1 us
+
+  virtual void stepImpl();
+
+  /**
+   * @return The voltage a side's motor controller applies for its current command.
+   */
+  double controlVoltage(const SideState &iside) const;
+};
+
+/**
+ * One side of a SkidSteerSimulator as an AbstractMotor. Velocities are in rpm and positions in
+ * the configured encoder units, as with okapi::Motor.
+ */
+class SimulatedMotor : public okapi::AbstractMotor {
+  public:
+  SimulatedMotor(std::shared_ptr<SkidSteerSimulator> isim, SkidSteerSimulator::Side iside);
+
+  std::int32_t moveAbsolute(double iposition, std::int32_t ivelocity) override;
+  std::int32_t moveRelative(double iposition, std::int32_t ivelocity) override;
+  std::int32_t moveVelocity(std::int16_t ivelocity) override;
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+  std::int32_t modifyProfiledVelocity(std::int32_t ivelocity) override;
+  double getTargetPosition() override;
+  double getPosition() override;
+  std::int32_t tarePosition() override;
+  std::int32_t getTargetVelocity() override;
+  double getActualVelocity() override;
+  std::int32_t getCurrentDraw() override;
+  std::int32_t getDirection() override;
+  double getEfficiency() override;
+  std::int32_t isOverCurrent() override;
+  std::int32_t isOverTemp() override;
+  std::int32_t isStopped() override;
+  std::int32_t getZeroPositionFlag() override;
+  uint32_t getFaults() override;
+  uint32_t getFlags() override;
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override;
+  double getPower() override;
+  double getTemperature() override;
+  double getTorque() override;
+  std::int32_t getVoltage() override;
+  std::int32_t setBrakeMode(okapi::AbstractMotor::brakeMode imode) override;
+  brakeMode getBrakeMode() override;
+  std::int32_t setCurrentLimit(std::int32_t ilimit) override;
+  std::int32_t getCurrentLimit() override;
+  std::int32_t setEncoderUnits(okapi::AbstractMotor::encoderUnits iunits) override;
+  encoderUnits getEncoderUnits() override;
+  std::int32_t setGearing(okapi::AbstractMotor::gearset igearset) override;
+  gearset getGearing() override;
+  std::int32_t setReversed(bool ireverse) override;
+  std::int32_t setVoltageLimit(std::int32_t ilimit) override;
+  std::shared_ptr<okapi::ContinuousRotarySensor> getEncoder() override;
+  void controllerSet(double ivalue) override;
+
+  protected:
+  std::shared_ptr<SkidSteerSimulator> sim;
+  SkidSteerSimulator::Side side;
+  encoderUnits units{encoderUnits::degrees};
+  brakeMode brake{brakeMode::coast};
+  double zero{0};           // degrees
+  double targetPosition{0}; // degrees
+  std::int32_t targetVelocity{0};
+  std::int32_t currentLimit{2500};
+
+  /**
+   * @return Degrees per encoder unit.
+   */
+  double unitScale() const;
+};
+
+/**
+ * One side's tracking wheel, or motor encoder, of a SkidSteerSimulator.
+ */
+class SimulatedEncoder : public okapi::ContinuousRotarySensor {
+  public:
+  /**
+   * @param isim The simulation.
+   * @param iside The side.
+   * @param itrackingWheel Whether this reads the tracking wheel or the motors' encoder in degrees.
+   */
+  SimulatedEncoder(std::shared_ptr<SkidSteerSimulator> isim,
+                   SkidSteerSimulator::Side iside,
+                   bool itrackingWheel = true);
+
+  double get() const override;
+  std::int32_t reset() override;
+  double controllerGet() override;
+
+  protected:
+  std::shared_ptr<SkidSteerSimulator> sim;
+  SkidSteerSimulator::Side side;
+  bool trackingWheel;
+  double zero{0};
+
+  double raw() const;
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+/**
+ * A median filter with the same output as okapi::MedianFilter<n> (the lower median of the last n
+ * readings, starting from a window of zeros), in O(log n) per reading instead of a copy and a
+ * quickselect of the whole window. That makes wide windows, e.x. 51 readings of a noisy
+ * potentiometer or ultrasonic, affordable at loop rate.
+ *
+ * The window's readings are kept in a single array of heap slots around the median: a max-heap of
+ * the smaller readings below it and a min-heap of the larger ones above. Every reading remembers
+ * its slot, so the one leaving the window is replaced in place and sifted up or down one heap.
+ * Nothing is allocated.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t n> class SlidingMedianFilter : public okapi::Filter {
+  static_assert(n > 0, "SlidingMedianFilter needs at least one tap");
+
+  public:
+  SlidingMedianFilter() {
+    for (std::size_t i = 0; i < n; i++) {
+      heap[i] = i;
+      pos[i] = static_cast<int>(i) - below;
+    }
+  }
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    const int p = pos[index];
+    const double old = data[index];
+    data[index] = ireading;
+    if (++index >= n) {
+      index = 0;
+    }
+
+    if (p > 0) {
+      // In the min-heap: sift down if it grew, else up, and past the median into the max-heap
+      if (old < ireading) {
+        minSortDown(p * 2);
+      } else if (minSortUp(p)) {
+        maxSortDown(-1);
+      }
+    } else if (p < 0) {
+      if (ireading < old) {
+        maxSortDown(p * 2);
+      } else if (maxSortUp(p)) {
+        minSortDown(1);
+      }
+    } else {
+      // The median itself was replaced, it may belong in either heap
+      if (maxSortUp(-1)) {
+        maxSortDown(-2);
+      }
+      if (minSortUp(1)) {
+        minSortDown(2);
+      }
+    }
+
+    output = at(0);
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  // okapi::MedianFilter's middle index: the lower median for an even window
+  static constexpr int below = (n & 1) ? n / 2 : n / 2 - 1; // max-heap slots -1 to -below
+  static constexpr int above = static_cast<int>(n) - 1 - below; // min-heap slots 1 to above
+
+  std::array<double, n> data{}; // the window, as a ring
+  std::array<std::size_t, n> heap; // reading index at each slot, slot -below is heap[0]
+  std::array<int, n> pos; // slot of each reading
+  std::size_t index{0};
+  double output{0};
+
+  double at(const int islot) const {
+    return data[heap[islot + below]];
+  }
+
+  /**
+   * Swaps slots i and j if slot i's reading is less than slot j's.
+   *
+   * @return whether they were swapped
+   */
+  bool exchangeIfLess(const int i, const int j) {
+    if (!(at(i) < at(j))) {
+      return false;
+    }
+    std::swap(heap[i + below], heap[j + below]);
+    pos[heap[i + below]] = i;
+    pos[heap[j + below]] = j;
+    return true;
+  }
+
+  /**
+   * Restores the min-heap from slot i down, starting with i against its parent.
+   */
+  void minSortDown(int i) {
+    if constexpr (above == 0) {
+      return;
+    }
+    for (; i <= above; i *= 2) {
+      if (i > 1 && i < above && at(i + 1) < at(i)) {
+        i++;
+      }
+      if (!exchangeIfLess(i, i / 2)) {
+        break;
+      }
+    }
+  }
+
+  /**
+   * Restores the max-heap from slot i down, starting with i against its parent. Slots are negative
+   * on this side, so a slot's children are 2i and 2i - 1.
+   */
+  void maxSortDown(int i) {
+    if constexpr (below == 0) {
+      return;
+    }
+    for (; i >= -below; i *= 2) {
+      if (i < -1 && i > -below && at(i) < at(i - 1)) {
+        i--;
+      }
+      if (!exchangeIfLess(i / 2, i)) {
+        break;
+      }
+    }
+  }
+
+  /**
+   * Restores the min-heap above slot i, up to and including the median.
+   *
+   * @return whether the median changed
+   */
+  bool minSortUp(int i) {
+    if constexpr (above == 0) {
+      return false;
+    }
+    while (i > 0 && exchangeIfLess(i, i / 2)) {
+      i /= 2;
+    }
+    return i == 0;
+  }
+
+  /**
+   * Restores the max-heap above slot i, up to and including the median.
+   *
+   * @return whether the median changed
+   */
+  bool maxSortUp(int i) {
+    if constexpr (below == 0) {
+      return false;
+    }
+    while (i < 0 && exchangeIfLess(i / 2, i)) {
+      i /= 2;
+    }
+    return i == 0;
+  }
+};
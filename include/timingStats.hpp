@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * A running summary of durations in microseconds: count, mean, extremes, percentiles, and how many
+ * exceeded a limit. Percentiles come from a histogram with eight buckets per power of two, so they
+ * are rounded up by at most 1/8 and adding a sample costs a few integer operations, with no
+ * allocation.
+ */
+class TimingStats {
+  public:
+  /**
+   * @param ilimit Samples longer than this many microseconds are counted as over the limit, e.x.
+   * the loop period.
+   */
+  explicit TimingStats(std::uint32_t ilimit = std::numeric_limits<std::uint32_t>::max());
+
+  void add(std::uint32_t ius);
+
+  /**
+   * Forgets every sample. The limit stays.
+   */
+  void clear();
+
+  std::uint32_t getCount() const;
+
+  /**
+   * @return The samples over the limit.
+   */
+  std::uint32_t getOverLimit() const;
+
+  std::uint32_t getLimit() const;
+
+  /**
+   * @return The mean in microseconds, 0 without samples.
+   */
+  double getMean() const;
+
+  std::uint32_t getMin() const;
+
+  std::uint32_t getMax() const;
+
+  /**
+   * @param ifraction The fraction of samples at or below the result, e.x. 0.99.
+   * @return The upper edge of the bucket holding that sample, never above the max.
+   */
+  std::uint32_t getPercentile(double ifraction) const;
+
+  /**
+   * Gives one bucket's bounds, for printing the histogram.
+   *
+   * @param ibucket The bucket, below `bucketCount`.
+   * @return Its samples, which were between `olower` and `oupper` microseconds inclusive.
+   */
+  std::uint32_t getBucket(std::size_t ibucket, std::uint32_t &olower, std::uint32_t &oupper) const;
+
+  static constexpr std::size_t subBuckets = 8;
+  static constexpr std::size_t bucketCount = subBuckets + (32 - 3) * subBuckets;
+
+  protected:
+  std::uint32_t limit;
+  std::uint32_t count{0};
+  std::uint32_t overLimit{0};
+  std::uint64_t sum{0};
+  std::uint32_t min{std::numeric_limits<std::uint32_t>::max()};
+  std::uint32_t max{0};
+  std::array<std::uint32_t, bucketCount> buckets{};
+
+  static std::size_t bucketOf(std::uint32_t ius);
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * Scoped tracing: where each task spends its time, saved as a Chrome trace to open in a trace
+ * viewer (chrome://tracing or ui.perfetto.dev) as one timeline per task.
+ *
+ *   void SensorPipeline::stepFilters(...) {
+ *     TRACE_FUNCTION();
+ *     ...
+ *   }
+ *
+ *   { TRACE_SCOPE("lcd"); ... }
+ *
+ * Each scope records its start and duration in microseconds when it closes, into a ring of the
+ * calling task's own, so tasks never wait on each other and recording never allocates after a
+ * task's first event. A full ring overwrites its oldest events. Scope names must outlive the
+ * trace, e.x. string literals; only the pointer is kept.
+ *
+ * Tracing is built in with `TRACING:=1` in the Makefile, which defines ENABLE_TRACING. Otherwise
+ * every macro here expands to nothing and the tracer isn't compiled.
+ *
+ * TRACE_START() starts recording, TRACE_STOP() stops it and TRACE_SAVE(file) writes what the rings
+ * hold, e.x. `TRACE_SAVE("/usd/trace.json")`. Saving pauses recording, so the rings hold still.
+ */
+
+#ifdef ENABLE_TRACING
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * The tracer behind the macros; use those instead, so tracing compiles away when it's off.
+ */
+class Trace {
+  public:
+  /**
+   * Events kept per task, 12 bytes each on the V5, so 48 KiB a task. 4096 is the last 8 s of a
+   * 100 Hz loop with five scopes per iteration.
+   */
+  static constexpr std::size_t eventsPerTask = 4096;
+
+  /**
+   * Tasks traced at most, which puts all the rings together at 768 KiB.
+   */
+  static constexpr std::size_t maxTasks = 16;
+
+  static void start();
+
+  static void stop();
+
+  static bool isRecording();
+
+  /**
+   * Writes every ring as Chrome trace event JSON.
+   *
+   * @param ifileName The file to write, e.x. `/usd/trace.json`.
+   * @return Whether the file was written.
+   */
+  static bool save(const char *ifileName);
+
+  /**
+   * Records a finished scope on the calling task.
+   */
+  static void record(const char *iname, std::uint32_t istartUs, std::uint32_t idurationUs);
+
+  /**
+   * @return The time in microseconds scopes are measured in.
+   */
+  static std::uint32_t now();
+};
+
+/**
+ * Times its own lifetime. Made by TRACE_SCOPE.
+ */
+class TraceScope {
+  public:
+  explicit TraceScope(const char *iname) : name(iname), start(Trace::now()) {
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  ~TraceScope() {
+    Trace::record(name, start, Trace::now() - start);
+  }
+
+  protected:
+  const char *name;
+  std::uint32_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+#define TRACE_START() Trace::start()
+#define TRACE_STOP() Trace::stop()
+#define TRACE_SAVE(fileName) Trace::save(fileName)
+
+#else
+
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_FUNCTION() static_cast<void>(0)
+#define TRACE_START() static_cast<void>(0)
+#define TRACE_STOP() static_cast<void>(0)
+#define TRACE_SAVE(fileName) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,147 @@
+#include "allocationCounter.hpp"
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#ifndef THREADS_STD
+#include "pros/rtos.h"
+#endif
+
+namespace {
+struct TaskCount {
+  std::atomic<const void *> task{nullptr};
+  char name[32]{};
+  std::atomic<std::uint32_t> count{0};
+  std::atomic<std::uint32_t> bytes{0};
+};
+
+std::array<TaskCount, AllocationCounter::maxTasks> tasks;
+std::atomic<std::uint32_t> total{0};
+
+/**
+ * An identity for the calling task. Before the scheduler starts there is no current task, which
+ * counts as one task of its own.
+ */
+const void *currentTask() {
+#ifdef THREADS_STD
+  thread_local const char self = 0;
+  return &self;
+#else
+  return pros::c::task_get_current();
+#endif
+}
+
+void nameSlot(TaskCount &ioslot, const void *itask) {
+#ifdef THREADS_STD
+  (void)itask;
+  std::strncpy(ioslot.name, "thread", sizeof(ioslot.name) - 1);
+#else
+  const char *name =
+    itask ? pros::c::task_get_name(static_cast<pros::task_t>(const_cast<void *>(itask))) : nullptr;
+  std::strncpy(ioslot.name, name ? name : "(startup)", sizeof(ioslot.name) - 1);
+#endif
+}
+
+/**
+ * Finds the calling task's slot, claiming a free one the first time. Never allocates, since it
+ * runs inside malloc.
+ */
+TaskCount &slotOf(const void *itask) {
+  for (auto &slot : tasks) {
+    const void *owner = slot.task.load(std::memory_order_acquire);
+    if (owner == itask && (itask || slot.name[0] != '\0')) {
+      return slot;
+    }
+    if (!owner && slot.name[0] == '\0') {
+      const void *expected = nullptr;
+      // The name marks the slot as taken, so a null handle (startup) can own one too
+      if (slot.task.compare_exchange_strong(expected, itask)) {
+        nameSlot(slot, itask);
+        return slot;
+      }
+    }
+  }
+  return tasks.back();
+}
+
+void count(const std::size_t ibytes) {
+  TaskCount &slot = slotOf(currentTask());
+  slot.count.fetch_add(1, std::memory_order_relaxed);
+  slot.bytes.fetch_add(static_cast<std::uint32_t>(ibytes), std::memory_order_relaxed);
+  total.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace
+
+/*
+ * The wrappers. `--wrap=malloc` sends every malloc() call to __wrap_malloc and __real_malloc to
+ * the real one. The real ones are weak, so without the flags this still links, and
+ * `isCounting()` can tell.
+ */
+extern "C" {
+void *__real_malloc(std::size_t isize) __attribute__((weak));
+void *__real_calloc(std::size_t icount, std::size_t isize) __attribute__((weak));
+void *__real_realloc(void *iptr, std::size_t isize) __attribute__((weak));
+void __real_free(void *iptr) __attribute__((weak));
+
+void *__wrap_malloc(const std::size_t isize) {
+  count(isize);
+  return __real_malloc(isize);
+}
+
+void *__wrap_calloc(const std::size_t icount, const std::size_t isize) {
+  count(icount * isize);
+  return __real_calloc(icount, isize);
+}
+
+void *__wrap_realloc(void *iptr, const std::size_t isize) {
+  if (isize > 0) {
+    count(isize);
+  }
+  return __real_realloc(iptr, isize);
+}
+
+void __wrap_free(void *iptr) {
+  __real_free(iptr);
+}
+}
+
+bool AllocationCounter::isCounting() {
+  return __real_malloc != nullptr;
+}
+
+std::uint32_t AllocationCounter::getTaskCount() {
+  const void *task = currentTask();
+  for (const auto &slot : tasks) {
+    if (slot.task.load(std::memory_order_acquire) == task && slot.name[0] != '\0') {
+      return slot.count.load(std::memory_order_relaxed);
+    }
+  }
+  return 0;
+}
+
+std::uint32_t AllocationCounter::getTotalCount() {
+  return total.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::printAll(FILE *ifile) {
+  if (!isCounting()) {
+    fprintf(ifile, "Allocations aren't counted, build with COUNT_ALLOCATIONS:=1\n");
+    return;
+  }
+
+  fprintf(ifile, "%-32s %10s %10s\n", "task", "allocs", "bytes");
+  for (const auto &slot : tasks) {
+    // The last slot also counts tasks which found the table full
+    if (slot.name[0] != '\0' || slot.count.load(std::memory_order_relaxed) > 0) {
+      fprintf(ifile,
+              "%-32s %10lu %10lu\n",
+              slot.name[0] != '\0' ? slot.name : "(others)",
+              static_cast<unsigned long>(slot.count.load(std::memory_order_relaxed)),
+              static_cast<unsigned long>(slot.bytes.load(std::memory_order_relaxed)));
+    }
+  }
+  fprintf(ifile,
+          "%-32s %10lu\n",
+          "total",
+          static_cast<unsigned long>(total.load(std::memory_order_relaxed)));
+}
@@ -0,0 +1,157 @@
+#include "asyncLogFile.hpp"
+#include "loopRate.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace okapi;
+
+AsyncLogFile::AsyncLogFile(const TimeUtil &itimeUtil,
+                           FILE *itarget,
+                           const std::size_t icapacity,
+                           const QTime iperiod)
+  : timeUtil(itimeUtil), target(itarget), capacity(1), period(iperiod) {
+  while (capacity < icapacity) {
+    capacity <<= 1;
+  }
+  ring = std::make_unique<char[]>(capacity);
+}
+
+AsyncLogFile::~AsyncLogFile() {
+  // The stream holds a reference, so it has been closed by now and the task has finished
+  delete task;
+}
+
+std::shared_ptr<AsyncLogFile> AsyncLogFile::open(const TimeUtil &itimeUtil,
+                                                 const std::string &ifileName,
+                                                 const std::size_t icapacity,
+                                                 const QTime iperiod) {
+  const bool serial = ifileName.find("/ser/") != std::string::npos;
+  FILE *target = fopen(ifileName.c_str(), serial ? "w" : "a");
+  if (!target) {
+    return nullptr;
+  }
+  return open(itimeUtil, target, icapacity, iperiod);
+}
+
+std::shared_ptr<AsyncLogFile> AsyncLogFile::open(const TimeUtil &itimeUtil,
+                                                 FILE *itarget,
+                                                 const std::size_t icapacity,
+                                                 const QTime iperiod) {
+  if (!itarget) {
+    return nullptr;
+  }
+  return openStream(
+    std::shared_ptr<AsyncLogFile>(new AsyncLogFile(itimeUtil, itarget, icapacity, iperiod)));
+}
+
+std::shared_ptr<AsyncLogFile> AsyncLogFile::openStream(std::shared_ptr<AsyncLogFile> ifile) {
+  cookie_io_functions_t functions{};
+  functions.write = cookieWrite;
+  functions.close = cookieClose;
+
+  auto *cookie = new std::shared_ptr<AsyncLogFile>(ifile);
+  ifile->stream = fopencookie(cookie, "w", functions);
+  if (!ifile->stream) {
+    delete cookie;
+    fclose(ifile->target);
+    return nullptr;
+  }
+
+  // Logger ends every statement with a newline, so each one reaches the ring in a single write
+  setvbuf(ifile->stream, nullptr, _IOLBF, 256);
+  ifile->task = new CrossplatformThread(trampoline, ifile.get(), "AsyncLogFile");
+  return ifile;
+}
+
+FILE *AsyncLogFile::getFile() const {
+  return stream;
+}
+
+std::size_t AsyncLogFile::getOverruns() const {
+  return overruns;
+}
+
+std::size_t AsyncLogFile::getBytesWritten() const {
+  return bytesWritten;
+}
+
+void AsyncLogFile::push(const char *ibuffer, const std::size_t isize) {
+  const std::size_t start = head.load(std::memory_order_relaxed);
+  if (isize > capacity - (start - tail.load(std::memory_order_acquire))) {
+    overruns.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const std::size_t offset = start & (capacity - 1);
+  const std::size_t first = std::min(isize, capacity - offset);
+  std::memcpy(&ring[offset], ibuffer, first);
+  std::memcpy(&ring[0], ibuffer + first, isize - first);
+  head.store(start + isize, std::memory_order_release);
+}
+
+void AsyncLogFile::drain() {
+  const std::size_t end = head.load(std::memory_order_acquire);
+  const std::size_t start = tail.load(std::memory_order_relaxed);
+  const std::size_t dropped = overruns.load(std::memory_order_relaxed);
+  if (end == start && dropped == reportedOverruns) {
+    return;
+  }
+
+  if (end != start) {
+    const std::size_t offset = start & (capacity - 1);
+    const std::size_t first = std::min(end - start, capacity - offset);
+    fwrite(&ring[offset], 1, first, target);
+    fwrite(&ring[0], 1, end - start - first, target);
+    tail.store(end, std::memory_order_release);
+    bytesWritten.fetch_add(end - start, std::memory_order_relaxed);
+  }
+
+  if (dropped != reportedOverruns) {
+    fprintf(target,
+            "AsyncLogFile: %u log writes dropped\n",
+            static_cast<unsigned>(dropped - reportedOverruns));
+    reportedOverruns = dropped;
+  }
+  fflush(target);
+}
+
+void AsyncLogFile::close() {
+  dying = true;
+  auto rate = timeUtil.getRate();
+  while (!finished) {
+    rate->delayUntil(1_ms);
+  }
+  fclose(target);
+}
+
+ssize_t AsyncLogFile::cookieWrite(void *icookie, const char *ibuffer, const std::size_t isize) {
+  (*static_cast<std::shared_ptr<AsyncLogFile> *>(icookie))->push(ibuffer, isize);
+  // Dropped writes count as written, so stdio doesn't mark the stream as failed
+  return static_cast<ssize_t>(isize);
+}
+
+int AsyncLogFile::cookieClose(void *icookie) {
+  auto *file = static_cast<std::shared_ptr<AsyncLogFile> *>(icookie);
+  (*file)->close();
+  delete file;
+  return 0;
+}
+
+void AsyncLogFile::trampoline(void *icontext) {
+  if (icontext) {
+    static_cast<AsyncLogFile *>(icontext)->loop();
+  }
+}
+
+void AsyncLogFile::loop() {
+  LoopRate rate(
+    "AsyncLogFile", timeUtil.getRate(), static_cast<std::uint32_t>(period.convert(millisecond)));
+  while (!dying) {
+    drain();
+    rate.delayUntilNext();
+  }
+
+  // Whatever was logged before the stream closed
+  drain();
+  finished = true;
+}
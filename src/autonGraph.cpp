@@ -0,0 +1,302 @@
+#include "autonGraph.hpp"
+#include "loopRate.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace okapi;
+
+AutonGraph::AutonGraph(const TimeUtil &itimeUtil, std::function<QLength()> iodometer)
+  : timeUtil(itimeUtil), timer(itimeUtil.getTimer()), odometer(std::move(iodometer)) {
+  for (std::size_t lane = 0; lane < workers.size(); lane++) {
+    workers[lane].graph = this;
+    workers[lane].lane = static_cast<Lane>(lane);
+  }
+  timer->placeMark();
+}
+
+AutonGraph::~AutonGraph() {
+  dying = true;
+  auto rate = timeUtil.getRate();
+  for (auto &worker : workers) {
+    if (worker.task) {
+      // Deleting the task while it holds stepsLock would leave the lock taken
+      while (!worker.finished) {
+        rate->delayUntil(1_ms);
+      }
+      delete worker.task;
+    }
+  }
+}
+
+AutonGraph::StepId AutonGraph::add(std::string iname,
+                                   const Lane ilane,
+                                   std::function<void()> iaction,
+                                   std::vector<Condition> iconditions) {
+  lockIdle();
+  const StepId id = steps.size();
+  for (const auto &condition : iconditions) {
+    if (condition.kind != Condition::Kind::when && condition.step >= id) {
+      stepsLock.unlock();
+      throw std::invalid_argument("AutonGraph: Step " + iname +
+                                  " waits on a step that wasn't added before it.");
+    }
+  }
+
+  Step step;
+  step.name = std::move(iname);
+  step.lane = ilane;
+  step.action = std::move(iaction);
+  step.conditions = std::move(iconditions);
+  steps.push_back(std::move(step));
+  stepsLock.unlock();
+  return id;
+}
+
+void AutonGraph::clear() {
+  cancel();
+  lockIdle();
+  steps.clear();
+  stepsLock.unlock();
+}
+
+void AutonGraph::cancel() {
+  stepsLock.lock();
+  for (auto &step : steps) {
+    if (step.state == State::pending || step.state == State::ready) {
+      step.state = State::cancelled;
+    }
+  }
+  stepsLock.unlock();
+}
+
+bool AutonGraph::run(const QTime itimeout) {
+  stepsLock.lock();
+  for (auto &step : steps) {
+    // A step still running from a run that timed out carries on in this one rather than being
+    // started twice; its times restart with the clock
+    if (step.state != State::running) {
+      step.state = State::pending;
+    }
+    step.record = Record();
+  }
+  timer->placeMark();
+  stepsLock.unlock();
+
+  for (auto &worker : workers) {
+    if (!worker.task) {
+      worker.task = new CrossplatformThread(trampoline, &worker, "AutonGraph");
+    }
+  }
+
+  LoopRate rate("AutonGraph", timeUtil.getRate());
+  while (true) {
+    promote();
+    stepsLock.lock();
+    const bool done = std::all_of(
+      steps.begin(), steps.end(), [](const Step &step) { return step.state == State::finished; });
+    stepsLock.unlock();
+
+    if (done) {
+      return true;
+    }
+    if (timer->getDtFromMark() >= itimeout) {
+      return false;
+    }
+    rate.delayUntilNext();
+  }
+}
+
+bool AutonGraph::isFinished(const StepId istep) const {
+  stepsLock.lock();
+  const bool finished = istep < steps.size() && steps[istep].state == State::finished;
+  stepsLock.unlock();
+  return finished;
+}
+
+std::vector<AutonGraph::Record> AutonGraph::getReport() const {
+  std::vector<Record> report;
+  stepsLock.lock();
+  report.reserve(steps.size());
+  for (const auto &step : steps) {
+    report.push_back(step.record);
+  }
+  stepsLock.unlock();
+  return report;
+}
+
+void AutonGraph::printReport() const {
+  printf("%-24s %-7s %8s %8s %8s %8s\n", "step", "lane", "ready", "start", "end", "ms");
+  stepsLock.lock();
+  for (const auto &step : steps) {
+    if (step.state == State::pending || step.state == State::ready ||
+        step.state == State::cancelled) {
+      printf("%-24s %-7s %8s\n", step.name.c_str(), AutonTimeline::laneName(step.lane), "-");
+      continue;
+    }
+    const std::uint32_t end = step.record.finished ? step.record.endMs : now();
+    printf("%-24s %-7s %8lu %8lu %8lu %8lu%s\n",
+           step.name.c_str(),
+           AutonTimeline::laneName(step.lane),
+           static_cast<unsigned long>(step.record.readyMs),
+           static_cast<unsigned long>(step.record.startMs),
+           static_cast<unsigned long>(end),
+           static_cast<unsigned long>(end - step.record.startMs),
+           step.record.finished ? "" : " (running)");
+  }
+  stepsLock.unlock();
+}
+
+AutonGraph::Condition AutonGraph::after(const StepId istep, const QTime idelay) {
+  return Condition{Condition::Kind::after, istep, idelay.convert(millisecond), nullptr};
+}
+
+AutonGraph::Condition AutonGraph::afterStart(const StepId istep, const QTime idelay) {
+  return Condition{Condition::Kind::afterStart, istep, idelay.convert(millisecond), nullptr};
+}
+
+AutonGraph::Condition AutonGraph::atDistance(const StepId istep, const QLength idistance) {
+  return Condition{Condition::Kind::atDistance, istep, idistance.convert(meter), nullptr};
+}
+
+AutonGraph::Condition AutonGraph::when(std::function<bool()> ipredicate) {
+  return Condition{Condition::Kind::when, 0, 0, std::move(ipredicate)};
+}
+
+std::uint32_t AutonGraph::now() const {
+  return static_cast<std::uint32_t>(timer->getDtFromMark().convert(millisecond));
+}
+
+double AutonGraph::distance() const {
+  return odometer ? odometer().convert(meter) : 0;
+}
+
+void AutonGraph::lockIdle() {
+  auto rate = timeUtil.getRate();
+  stepsLock.lock();
+  while (std::any_of(
+    steps.begin(), steps.end(), [](const Step &step) { return step.state == State::running; })) {
+    stepsLock.unlock();
+    rate->delayUntil(10_ms);
+    stepsLock.lock();
+  }
+}
+
+bool AutonGraph::holds(const Condition &icondition) const {
+  if (icondition.kind == Condition::Kind::when) {
+    return true;
+  }
+
+  const Step &step = steps[icondition.step];
+  const bool started = step.state == State::running || step.state == State::finished;
+  switch (icondition.kind) {
+  case Condition::Kind::after:
+    return step.state == State::finished && now() >= step.record.endMs + icondition.amount;
+  case Condition::Kind::afterStart:
+    return started && now() >= step.record.startMs + icondition.amount;
+  case Condition::Kind::atDistance:
+    // A step that finished short of the distance won't get any further
+    return step.state == State::finished ||
+           (started && std::abs(distance() - step.startDistance) >= icondition.amount);
+  case Condition::Kind::when:
+    break;
+  }
+  return false;
+}
+
+bool AutonGraph::predicatesHold(const Step &istep) const {
+  return std::all_of(
+    istep.conditions.begin(), istep.conditions.end(), [](const Condition &condition) {
+      return condition.kind != Condition::Kind::when ||
+             (condition.predicate && condition.predicate());
+    });
+}
+
+void AutonGraph::promote() {
+  std::vector<std::size_t> candidates;
+  stepsLock.lock();
+  for (std::size_t i = 0; i < steps.size(); i++) {
+    if (steps[i].state == State::pending &&
+        std::all_of(steps[i].conditions.begin(),
+                    steps[i].conditions.end(),
+                    [&](const Condition &condition) { return holds(condition); })) {
+      candidates.push_back(i);
+    }
+  }
+  stepsLock.unlock();
+
+  // Steps aren't added or removed during a run, so their conditions can be read without the lock
+  candidates.erase(
+    std::remove_if(candidates.begin(),
+                   candidates.end(),
+                   [&](const std::size_t i) { return !predicatesHold(steps[i]); }),
+    candidates.end());
+
+  stepsLock.lock();
+  // The other conditions only ever go from not holding to holding during a run, so they still do
+  for (const std::size_t i : candidates) {
+    if (steps[i].state == State::pending) {
+      steps[i].state = State::ready;
+      steps[i].order = readyCount++;
+      steps[i].record.readyMs = now();
+    }
+  }
+  stepsLock.unlock();
+}
+
+std::size_t AutonGraph::nextOn(const Lane ilane) const {
+  std::size_t next = steps.size();
+  for (std::size_t i = 0; i < steps.size(); i++) {
+    if (steps[i].lane == ilane && steps[i].state == State::ready &&
+        (next == steps.size() || steps[i].order < steps[next].order)) {
+      next = i;
+    }
+  }
+  return next;
+}
+
+void AutonGraph::trampoline(void *icontext) {
+  if (icontext) {
+    auto *worker = static_cast<Worker *>(icontext);
+    worker->graph->loop(worker->lane);
+  }
+}
+
+void AutonGraph::loop(const Lane ilane) {
+  // LoopRate keeps its name rather than copying it, so each lane's is spelled out
+  static const char *const loopNames[] = {"AutonGraph drive",
+                                          "AutonGraph intake",
+                                          "AutonGraph tray",
+                                          "AutonGraph arm",
+                                          "AutonGraph delay"};
+  static_assert(sizeof(loopNames) / sizeof(loopNames[0]) == AutonTimeline::laneCount,
+                "a lane has no loop name");
+  LoopRate rate(loopNames[static_cast<std::size_t>(ilane)], timeUtil.getRate());
+  while (!dying) {
+    stepsLock.lock();
+    const std::size_t next = nextOn(ilane);
+    if (next < steps.size()) {
+      steps[next].state = State::running;
+      steps[next].record.startMs = now();
+      steps[next].startDistance = distance();
+    }
+    stepsLock.unlock();
+
+    if (next == steps.size()) {
+      rate.delayUntilNext();
+      continue;
+    }
+
+    // Steps aren't added or removed during a run, so the action can run without the lock
+    steps[next].action();
+
+    stepsLock.lock();
+    steps[next].state = State::finished;
+    steps[next].record.endMs = now();
+    steps[next].record.finished = true;
+    stepsLock.unlock();
+    // Start whatever waited on this step now, rather than on the scheduler's next pass
+    promote();
+  }
+  workers[static_cast<std::size_t>(ilane)].finished = true;
+}
@@ -0,0 +1,295 @@
+#include "autonTimeline.hpp"
+#include <algorithm>
+#include <cstring>
+#ifdef THREADS_STD
+#include <chrono>
+#include <thread>
+#else
+#include "pros/rtos.hpp"
+#endif
+
+using namespace okapi;
+
+namespace {
+/**
+ * How long before a span starts another may end and still be what it waited on. Covers the loop
+ * period a task notices it can go on in.
+ */
+constexpr std::uint32_t handoffMs = 20;
+} // namespace
+
+AutonTimeline::Scope::Scope(AutonTimeline &itimeline, const Lane ilane, const char *iname)
+  : timeline(itimeline), span(itimeline.begin(ilane, iname)) {
+}
+
+AutonTimeline::Scope::~Scope() {
+  timeline.end(span);
+}
+
+AutonTimeline::AutonTimeline(const TimeUtil &itimeUtil, const std::size_t icapacity)
+  : timer(itimeUtil.getTimer()), capacity(icapacity) {
+  spans.reserve(capacity);
+  timer->placeMark();
+}
+
+void AutonTimeline::start() {
+  spansLock.lock();
+  spans.clear();
+  timer->placeMark();
+  recording = true;
+  spansLock.unlock();
+}
+
+void AutonTimeline::stop() {
+  spansLock.lock();
+  const std::uint32_t time = now();
+  for (auto &span : spans) {
+    if (span.open) {
+      span.endMs = time;
+      span.open = false;
+    }
+  }
+  recording = false;
+  spansLock.unlock();
+}
+
+bool AutonTimeline::isRecording() const {
+  spansLock.lock();
+  const bool isRecording = recording;
+  spansLock.unlock();
+  return isRecording;
+}
+
+std::size_t AutonTimeline::begin(const Lane ilane, const char *iname) {
+  spansLock.lock();
+  if (!recording || spans.size() >= capacity) {
+    spansLock.unlock();
+    return none;
+  }
+
+  Span span{};
+  std::strncpy(span.name, iname, sizeof(span.name) - 1);
+  span.lane = ilane;
+  span.startMs = now();
+  span.endMs = span.startMs;
+  span.open = true;
+  spans.push_back(span);
+  const std::size_t index = spans.size() - 1;
+  spansLock.unlock();
+  return index;
+}
+
+void AutonTimeline::end(const std::size_t ispan) {
+  spansLock.lock();
+  // A span begun before the last start() isn't in the list any more
+  if (recording && ispan < spans.size() && spans[ispan].open) {
+    spans[ispan].endMs = now();
+    spans[ispan].open = false;
+  }
+  spansLock.unlock();
+}
+
+void AutonTimeline::delay(const std::uint32_t ims) {
+  char name[32];
+  snprintf(name, sizeof(name), "delay %lu ms", static_cast<unsigned long>(ims));
+  Scope scope(*this, Lane::delay, name);
+#ifdef THREADS_STD
+  std::this_thread::sleep_for(std::chrono::milliseconds(ims));
+#else
+  pros::delay(ims);
+#endif
+}
+
+std::vector<AutonTimeline::Span> AutonTimeline::getSpans() const {
+  return snapshot();
+}
+
+std::vector<std::size_t> AutonTimeline::getCriticalPath() const {
+  return criticalPath(snapshot());
+}
+
+void AutonTimeline::printReport() const {
+  const std::vector<Span> all = snapshot();
+  if (all.empty()) {
+    printf("Autonomous timeline: nothing recorded\n");
+    return;
+  }
+
+  std::uint32_t length = 0;
+  for (const auto &span : all) {
+    length = std::max(length, span.endMs);
+  }
+  printf("Autonomous timeline, %lu ms\n", static_cast<unsigned long>(length));
+
+  printf("critical path:\n");
+  std::uint32_t pathEnd = 0;
+  for (const std::size_t i : criticalPath(all)) {
+    const Span &span = all[i];
+    if (span.startMs > pathEnd + handoffMs) {
+      printf("%6lu ms %5lu ms  %-7s (nothing recorded)\n",
+             static_cast<unsigned long>(pathEnd),
+             static_cast<unsigned long>(span.startMs - pathEnd),
+             "");
+    }
+    printf("%6lu ms %5lu ms  %-7s %s\n",
+           static_cast<unsigned long>(span.startMs),
+           static_cast<unsigned long>(span.endMs - span.startMs),
+           laneName(span.lane),
+           span.name);
+    pathEnd = std::max(pathEnd, span.endMs);
+  }
+
+  printf("lanes:\n");
+  for (std::size_t lane = 0; lane < laneCount; lane++) {
+    const std::uint32_t busy = busyTime(all, {static_cast<Lane>(lane)}, 0, length);
+    printf("  %-7s %6lu ms busy %6lu ms idle\n",
+           laneName(static_cast<Lane>(lane)),
+           static_cast<unsigned long>(busy),
+           static_cast<unsigned long>(length - busy));
+  }
+
+  std::uint32_t delayed = 0;
+  std::uint32_t idleDelayed = 0;
+  std::size_t delays = 0;
+  for (const auto &span : all) {
+    if (span.lane != Lane::delay) {
+      continue;
+    }
+    // Time a delay covered mechanisms working is waiting on them; the rest waits on nothing
+    const std::uint32_t covered =
+      busyTime(all, {Lane::intake, Lane::tray, Lane::arm}, span.startMs, span.endMs);
+    delayed += span.endMs - span.startMs;
+    idleDelayed += span.endMs - span.startMs - covered;
+    delays++;
+  }
+  printf("fixed delays: %lu ms in %zu, %lu ms of it with no mechanism running\n",
+         static_cast<unsigned long>(delayed),
+         delays,
+         static_cast<unsigned long>(idleDelayed));
+}
+
+bool AutonTimeline::save(const std::string &ifileName) const {
+  const std::vector<Span> all = snapshot();
+  std::vector<bool> critical(all.size(), false);
+  for (const std::size_t i : criticalPath(all)) {
+    critical[i] = true;
+  }
+
+  FILE *file = fopen(ifileName.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "lane,name,start_ms,end_ms,critical\n");
+  for (std::size_t i = 0; i < all.size(); i++) {
+    fprintf(file,
+            "%s,%s,%lu,%lu,%d\n",
+            laneName(all[i].lane),
+            all[i].name,
+            static_cast<unsigned long>(all[i].startMs),
+            static_cast<unsigned long>(all[i].endMs),
+            critical[i] ? 1 : 0);
+  }
+  fclose(file);
+  return true;
+}
+
+const char *AutonTimeline::laneName(const Lane ilane) {
+  switch (ilane) {
+  case Lane::drive:
+    return "drive";
+  case Lane::intake:
+    return "intake";
+  case Lane::tray:
+    return "tray";
+  case Lane::arm:
+    return "arm";
+  case Lane::delay:
+    return "delay";
+  }
+  return "";
+}
+
+std::uint32_t AutonTimeline::now() const {
+  return static_cast<std::uint32_t>(timer->getDtFromMark().convert(millisecond));
+}
+
+std::vector<AutonTimeline::Span> AutonTimeline::snapshot() const {
+  spansLock.lock();
+  std::vector<Span> copy = spans;
+  const std::uint32_t time = now();
+  spansLock.unlock();
+
+  for (auto &span : copy) {
+    if (span.open) {
+      span.endMs = time;
+    }
+  }
+  return copy;
+}
+
+std::vector<std::size_t> AutonTimeline::criticalPath(const std::vector<Span> &ispans) {
+  std::vector<std::size_t> path;
+  if (ispans.empty()) {
+    return path;
+  }
+
+  std::size_t current = 0;
+  for (std::size_t i = 1; i < ispans.size(); i++) {
+    if (ispans[i].endMs > ispans[current].endMs) {
+      current = i;
+    }
+  }
+
+  // Walk back to whatever finished closest to when the current span started
+  while (current != none) {
+    path.push_back(current);
+    const Span &span = ispans[current];
+    std::size_t previous = none;
+    std::uint32_t previousGap = 0;
+    for (std::size_t i = 0; i < ispans.size(); i++) {
+      const Span &candidate = ispans[i];
+      if (candidate.startMs >= span.startMs || candidate.endMs > span.startMs + handoffMs) {
+        continue;
+      }
+      const std::uint32_t gap = candidate.endMs > span.startMs ? candidate.endMs - span.startMs
+                                                                : span.startMs - candidate.endMs;
+      if (previous == none || gap < previousGap) {
+        previous = i;
+        previousGap = gap;
+      }
+    }
+    current = previous;
+  }
+
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+std::uint32_t AutonTimeline::busyTime(const std::vector<Span> &ispans,
+                                      const std::initializer_list<Lane> ilanes,
+                                      const std::uint32_t ifrom,
+                                      const std::uint32_t ito) {
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> intervals;
+  for (const auto &span : ispans) {
+    if (std::find(ilanes.begin(), ilanes.end(), span.lane) == ilanes.end()) {
+      continue;
+    }
+    const std::uint32_t start = std::max(span.startMs, ifrom);
+    const std::uint32_t end = std::min(span.endMs, ito);
+    if (start < end) {
+      intervals.emplace_back(start, end);
+    }
+  }
+  std::sort(intervals.begin(), intervals.end());
+
+  std::uint32_t busy = 0;
+  std::uint32_t covered = ifrom;
+  for (const auto &[start, end] : intervals) {
+    if (end > covered) {
+      busy += end - std::max(start, covered);
+      covered = end;
+    }
+  }
+  return busy;
+}
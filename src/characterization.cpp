@@ -0,0 +1,120 @@
+#include "characterization.hpp"
+#include "loopRate.hpp"
+#include <cmath>
+#include <cstdio>
+#include <optional>
+
+using namespace okapi;
+
+namespace {
+const char *const testNames[] = {
+  "quasistatic-forward", "quasistatic-backward", "step-forward", "step-backward"};
+
+// Sample storage for one test at 100 Hz is reserved up front so the loop doesn't allocate
+constexpr std::size_t samplesPerTest = 2000;
+} // namespace
+
+DriveCharacterizer::DriveCharacterizer(const TimeUtil &itimeUtil,
+                                       std::shared_ptr<ChassisModel> imodel,
+                                       const ChassisScales &iscales,
+                                       const QLength imaxDistance)
+  : timeUtil(itimeUtil), model(std::move(imodel)), scales(iscales), maxDistance(imaxDistance) {
+}
+
+template <typename F> void DriveCharacterizer::record(const std::uint8_t itest, F ivoltsAt) {
+  samples.reserve(samples.size() + samplesPerTest);
+
+  LoopRate rate("DriveCharacterizer", timeUtil.getRate());
+  auto timer = timeUtil.getTimer();
+  const QTime start = timer->millis();
+  const auto startTicks = model->getSensorVals();
+  const double limit = maxDistance.convert(meter);
+
+  while (true) {
+    const double elapsed = (timer->millis() - start).convert(second);
+    const std::optional<double> volts = ivoltsAt(elapsed);
+    if (!volts) {
+      break;
+    }
+    const auto ticks = model->getSensorVals();
+    const double left = (ticks[0] - startTicks[0]) / scales.straight;
+    const double right = (ticks[1] - startTicks[1]) / scales.straight;
+
+    samples.push_back({static_cast<std::uint32_t>(elapsed * 1000),
+                       itest,
+                       static_cast<float>(*volts),
+                       static_cast<float>(left),
+                       static_cast<float>(right)});
+
+    if (std::abs(left) >= limit || std::abs(right) >= limit) {
+      break;
+    }
+
+    model->driveVectorVoltage(*volts / 12.0, 0);
+    rate.delayUntilNext();
+  }
+
+  model->stop();
+}
+
+void DriveCharacterizer::runQuasistatic(const double irampRate,
+                                        const double imaxVolts,
+                                        const bool ibackwards) {
+  const double sign = ibackwards ? -1 : 1;
+  record(ibackwards ? 1 : 0, [&](double t) -> std::optional<double> {
+    const double volts = irampRate * t;
+    if (volts > imaxVolts) {
+      return std::nullopt;
+    }
+    return sign * volts;
+  });
+}
+
+void DriveCharacterizer::runStep(const double ivolts,
+                                 const QTime iduration,
+                                 const bool ibackwards) {
+  const double sign = ibackwards ? -1 : 1;
+  const double duration = iduration.convert(second);
+  record(ibackwards ? 3 : 2, [&](double t) -> std::optional<double> {
+    if (t > duration) {
+      return std::nullopt;
+    }
+    return sign * ivolts;
+  });
+}
+
+void DriveCharacterizer::runAll() {
+  // A fresh rate for every pause, so each one waits the full second after the previous test
+  auto settle = [&]() { timeUtil.getRate()->delayUntil(1000_ms); };
+  runQuasistatic(0.5, 8, false);
+  settle();
+  runQuasistatic(0.5, 8, true);
+  settle();
+  runStep(6, 2_s, false);
+  settle();
+  runStep(6, 2_s, true);
+}
+
+bool DriveCharacterizer::save(const std::string &ifileName) const {
+  FILE *file = fopen(ifileName.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "time_ms,test,volts,left_m,right_m\n");
+  for (const auto &sample : samples) {
+    fprintf(file,
+            "%lu,%s,%.3f,%.5f,%.5f\n",
+            static_cast<unsigned long>(sample.time),
+            testNames[sample.test],
+            sample.volts,
+            sample.left,
+            sample.right);
+  }
+  fclose(file);
+  return true;
+}
+
+const std::vector<DriveCharacterizer::Sample> &DriveCharacterizer::getSamples() const {
+  return samples;
+}
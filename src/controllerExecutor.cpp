@@ -0,0 +1,241 @@
+#include "controllerExecutor.hpp"
+#include "loopRate.hpp"
+#include "microClock.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace okapi;
+
+ControllerExecutor::ControllerExecutor(const TimeUtil &itimeUtil, const QTime itick)
+  : timeUtil(itimeUtil),
+    tickPeriod(itick),
+    tickUs(static_cast<std::uint32_t>(std::lround(itick.convert(millisecond) * 1000))),
+    stageStats{TimingStats(tickUs), TimingStats(tickUs), TimingStats(tickUs), TimingStats(tickUs)},
+    tickStats(tickUs),
+    latencyStats(tickUs) {
+}
+
+ControllerExecutor::~ControllerExecutor() {
+  dying = true;
+  if (task) {
+    // Deleting the task while it holds stepsLock would leave the lock taken
+    auto rate = timeUtil.getRate();
+    while (!finished) {
+      rate->delayUntil(1_ms);
+    }
+    delete task;
+  }
+}
+
+void ControllerExecutor::add(std::string iname,
+                             const Stage istage,
+                             const QTime iperiod,
+                             std::function<void()> istep) {
+  const auto ticks = static_cast<std::uint32_t>(
+    std::max(1.0, std::round(iperiod.convert(millisecond) / tickPeriod.convert(millisecond))));
+
+  stepsLock.lock();
+  // After every step it doesn't come before, so equal steps run in registration order
+  const auto position =
+    std::upper_bound(steps.begin(), steps.end(), std::make_pair(istage, ticks),
+                     [](const std::pair<Stage, std::uint32_t> &key, const Step &step) {
+                       return key.first < step.stage ||
+                              (key.first == step.stage && key.second < step.ticks);
+                     });
+  steps.insert(position,
+               Step{std::move(iname), istage, ticks, std::move(istep), TimingStats(tickUs)});
+  stepsLock.unlock();
+}
+
+void ControllerExecutor::addController(
+  const std::string &iname,
+  std::shared_ptr<IterativeController<double, double>> icontroller,
+  std::function<double()> iinput,
+  std::function<void(double)> ioutput,
+  const QTime iperiod) {
+  auto reading = std::make_shared<double>(0);
+  auto output = std::make_shared<double>(0);
+  add(iname + " input", Stage::sense, iperiod, [=]() { *reading = iinput(); });
+  add(iname, Stage::control, iperiod, [=]() { *output = icontroller->step(*reading); });
+  add(iname + " output", Stage::actuate, iperiod, [=]() { ioutput(*output); });
+}
+
+void ControllerExecutor::start() {
+  running = true;
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "ControllerExecutor");
+  }
+}
+
+void ControllerExecutor::stop() {
+  // Taking the lock waits out a tick in progress
+  stepsLock.lock();
+  running = false;
+  stepsLock.unlock();
+}
+
+bool ControllerExecutor::isRunning() const {
+  return running;
+}
+
+void ControllerExecutor::tick() {
+  stepsLock.lock();
+  tickLocked();
+  stepsLock.unlock();
+}
+
+void ControllerExecutor::tickLocked() {
+  TRACE_SCOPE("ControllerExecutor::tick");
+  const std::uint64_t tickStart = microClock();
+  std::array<std::uint64_t, stageCount> stageStart{};
+  std::array<std::uint64_t, stageCount> stageEnd{};
+  std::array<bool, stageCount> stageRan{};
+
+  for (auto &step : steps) {
+    if (tickCount % step.ticks != 0) {
+      continue;
+    }
+
+    const auto stage = static_cast<std::size_t>(step.stage);
+    const std::uint64_t start = microClock();
+    step.step();
+    const std::uint64_t end = microClock();
+    step.stats.add(static_cast<std::uint32_t>(end - start));
+
+    if (!stageRan[stage]) {
+      stageRan[stage] = true;
+      stageStart[stage] = start;
+    }
+    stageEnd[stage] = end;
+  }
+
+  for (std::size_t stage = 0; stage < stageCount; stage++) {
+    if (stageRan[stage]) {
+      stageStats[stage].add(static_cast<std::uint32_t>(stageEnd[stage] - stageStart[stage]));
+    }
+  }
+
+  constexpr auto sense = static_cast<std::size_t>(Stage::sense);
+  constexpr auto actuate = static_cast<std::size_t>(Stage::actuate);
+  if (stageRan[sense] && stageRan[actuate]) {
+    latencyStats.add(static_cast<std::uint32_t>(stageEnd[actuate] - stageStart[sense]));
+  }
+
+  tickStats.add(static_cast<std::uint32_t>(microClock() - tickStart));
+  tickCount++;
+}
+
+void ControllerExecutor::clearStats() {
+  stepsLock.lock();
+  for (auto &step : steps) {
+    step.stats.clear();
+  }
+  for (auto &stats : stageStats) {
+    stats.clear();
+  }
+  tickStats.clear();
+  latencyStats.clear();
+  stepsLock.unlock();
+}
+
+std::uint32_t ControllerExecutor::getOverruns() const {
+  stepsLock.lock();
+  const std::uint32_t overruns = tickStats.getOverLimit();
+  stepsLock.unlock();
+  return overruns;
+}
+
+void ControllerExecutor::printReport() const {
+  printf("%-24s %-8s %6s %8s %8s %8s %8s %8s\n",
+         "step",
+         "stage",
+         "ms",
+         "runs",
+         "mean us",
+         "p99 us",
+         "max us",
+         "overruns");
+  stepsLock.lock();
+  write(stdout, false);
+  stepsLock.unlock();
+}
+
+bool ControllerExecutor::save(const std::string &ifileName) const {
+  FILE *file = fopen(ifileName.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "name,stage,period_ms,count,mean_us,p99_us,max_us,overruns\n");
+  stepsLock.lock();
+  write(file, true);
+  stepsLock.unlock();
+  fclose(file);
+  return true;
+}
+
+const char *ControllerExecutor::stageName(const Stage istage) {
+  switch (istage) {
+  case Stage::sense:
+    return "sense";
+  case Stage::estimate:
+    return "estimate";
+  case Stage::control:
+    return "control";
+  case Stage::actuate:
+    return "actuate";
+  }
+  return "";
+}
+
+void ControllerExecutor::write(FILE *ifile, const bool icsv) const {
+  const double tickMs = tickPeriod.convert(millisecond);
+  const auto row = [&](const char *iname,
+                       const char *istage,
+                       const double iperiodMs,
+                       const TimingStats &istats) {
+    fprintf(ifile,
+            icsv ? "%s,%s,%g,%lu,%.1f,%lu,%lu,%lu\n" : "%-24s %-8s %6g %8lu %8.1f %8lu %8lu %8lu\n",
+            iname,
+            istage,
+            iperiodMs,
+            static_cast<unsigned long>(istats.getCount()),
+            istats.getMean(),
+            static_cast<unsigned long>(istats.getPercentile(0.99)),
+            static_cast<unsigned long>(istats.getMax()),
+            static_cast<unsigned long>(istats.getOverLimit()));
+  };
+
+  for (const auto &step : steps) {
+    row(step.name.c_str(), stageName(step.stage), step.ticks * tickMs, step.stats);
+  }
+  for (std::size_t stage = 0; stage < stageCount; stage++) {
+    const char *name = stageName(static_cast<Stage>(stage));
+    row("stage", name, tickMs, stageStats[stage]);
+  }
+  row("tick", "", tickMs, tickStats);
+  row("latency", "", tickMs, latencyStats);
+}
+
+void ControllerExecutor::trampoline(void *icontext) {
+  if (icontext) {
+    static_cast<ControllerExecutor *>(icontext)->loop();
+  }
+}
+
+void ControllerExecutor::loop() {
+  LoopRate rate("ControllerExecutor",
+                timeUtil.getRate(),
+                static_cast<std::uint32_t>(tickPeriod.convert(millisecond)));
+  while (!dying) {
+    // Checked under the lock, so no step runs after `stop()` returns
+    stepsLock.lock();
+    if (running) {
+      tickLocked();
+    }
+    stepsLock.unlock();
+    rate.delayUntilNext();
+  }
+  finished = true;
+}
@@ -0,0 +1,70 @@
+#include "driveInput.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+DriveInputShaper::DriveInputShaper(const InputCurve &icurve) : curve(icurve) {
+}
+
+DriveInputShaper::DriveInputShaper(const InputCurve &icurve, const Limits ilimits)
+  : curve(icurve), limits(ilimits) {
+}
+
+DriveInputShaper::Power DriveInputShaper::tank(const int ileft,
+                                               const int iright,
+                                               const int ileftMa,
+                                               const int irightMa) {
+  return apply(curve(ileft), curve(iright), ileftMa, irightMa);
+}
+
+DriveInputShaper::Power DriveInputShaper::arcade(const int ipower,
+                                                 const int iturn,
+                                                 const int ileftMa,
+                                                 const int irightMa) {
+  const int power = curve(ipower);
+  const int turn = curve(iturn);
+  int left = power + turn;
+  int right = power - turn;
+
+  // Scale both sides by the same amount, rather than clamping one, so the turn isn't lost
+  const int largest = std::max(std::abs(left), std::abs(right));
+  if (largest > 127) {
+    left = left * 127 / largest;
+    right = right * 127 / largest;
+  }
+  return apply(left, right, ileftMa, irightMa);
+}
+
+void DriveInputShaper::reset() {
+  last = Power();
+}
+
+void DriveInputShaper::setLimits(const Limits ilimits) {
+  limits = ilimits;
+}
+
+const DriveInputShaper::Limits &DriveInputShaper::getLimits() const {
+  return limits;
+}
+
+int DriveInputShaper::limit(const int itarget, const int ilast, const int icurrentMa) const {
+  int target = itarget;
+
+  if (limits.currentMa > 0 && icurrentMa > limits.currentMa) {
+    // Cut the power back in proportion to how far over the current is
+    target = target * limits.currentMa / icurrentMa;
+  }
+
+  // Moving away from zero in the same direction speeds up; anything else slows down first
+  const bool speedingUp = (ilast >= 0 && target > ilast) || (ilast <= 0 && target < ilast);
+  const int step = speedingUp ? limits.accelStep : limits.decelStep;
+  return std::clamp(target, ilast - step, ilast + step);
+}
+
+DriveInputShaper::Power DriveInputShaper::apply(const int ileft,
+                                                const int iright,
+                                                const int ileftMa,
+                                                const int irightMa) {
+  last.left = limit(ileft, last.left, ileftMa);
+  last.right = limit(iright, last.right, irightMa);
+  return last;
+}
@@ -0,0 +1,141 @@
+#include "driveStateEstimator.hpp"
+#include "trace.hpp"
+#include <cmath>
+
+using namespace okapi;
+
+DriveStateEstimator::DriveStateEstimator() : DriveStateEstimator(Config()) {
+}
+
+DriveStateEstimator::DriveStateEstimator(const Config &iconfig)
+  : config(iconfig),
+    metersPerTick(1_pi * config.trackingScales.wheelDiameter.convert(meter) /
+                  config.trackingScales.tpr),
+    metersPerSecondPerRpm(1_pi * config.driveWheelDiameter.convert(meter) *
+                          config.driveGearRatio / 60),
+    filter(Filter::State(), initialCovariance()) {
+}
+
+void DriveStateEstimator::step(const QTime idt,
+                               const std::int32_t ileftTicks,
+                               const std::int32_t irightTicks,
+                               const double ileftVelocity,
+                               const double irightVelocity,
+                               const QAngularSpeed iyawRate) {
+  TRACE_SCOPE("DriveStateEstimator::step");
+  predict(idt);
+  updateTicks(ileftTicks, irightTicks);
+  updateVelocities(ileftVelocity, irightVelocity);
+  if (!std::isnan(iyawRate.getValue())) {
+    updateYawRate(iyawRate);
+  }
+}
+
+void DriveStateEstimator::predict(const QTime idt) {
+  const double dt = idt.convert(second);
+  if (dt <= 0) {
+    return;
+  }
+
+  // Constant acceleration, with the covariance white jerk builds up over dt
+  const double dt2 = dt * dt;
+  const double dt3 = dt2 * dt;
+  const double q = config.jerkNoise * config.jerkNoise;
+  const double transition[3][3] = {{1, dt, dt2 / 2}, {0, 1, dt}, {0, 0, 1}};
+  const double noise[3][3] = {{q * dt3 * dt2 / 20, q * dt2 * dt2 / 8, q * dt3 / 6},
+                              {q * dt2 * dt2 / 8, q * dt3 / 3, q * dt2 / 2},
+                              {q * dt3 / 6, q * dt2 / 2, q * dt}};
+
+  Filter::Covariance F;
+  Filter::Covariance Q;
+  for (std::size_t offset = 0; offset < states; offset += 3) {
+    for (std::size_t r = 0; r < 3; r++) {
+      for (std::size_t c = 0; c < 3; c++) {
+        F(offset + r, offset + c) = transition[r][c];
+        Q(offset + r, offset + c) = noise[r][c];
+      }
+    }
+  }
+  filter.predict(F, Q);
+}
+
+void DriveStateEstimator::updateTicks(const std::int32_t ileftTicks,
+                                      const std::int32_t irightTicks) {
+  if (!started) {
+    started = true;
+    startLeft = ileftTicks;
+    startRight = irightTicks;
+  }
+
+  FixedMatrix<2, states> H;
+  H(0, 0) = 1;
+  H(1, 3) = 1;
+  const double variance = std::pow(config.tickNoise * metersPerTick, 2);
+  filter.update(FixedVector<2>({(ileftTicks - startLeft) * metersPerTick,
+                                (irightTicks - startRight) * metersPerTick}),
+                H,
+                FixedMatrix<2, 2>({variance, 0, 0, variance}));
+}
+
+void DriveStateEstimator::updateVelocities(const double ileftVelocity,
+                                           const double irightVelocity) {
+  FixedMatrix<2, states> H;
+  H(0, 1) = 1;
+  H(1, 4) = 1;
+  const double variance = std::pow(config.velocityNoise * metersPerSecondPerRpm, 2);
+  filter.update(FixedVector<2>({ileftVelocity * metersPerSecondPerRpm,
+                                irightVelocity * metersPerSecondPerRpm}),
+                H,
+                FixedMatrix<2, 2>({variance, 0, 0, variance}));
+}
+
+void DriveStateEstimator::updateYawRate(const QAngularSpeed iyawRate) {
+  // A skid steer turns clockwise at (left - right) / track
+  const double track = config.trackingScales.wheelTrack.convert(meter);
+  FixedMatrix<1, states> H;
+  H(0, 1) = 1 / track;
+  H(0, 4) = -1 / track;
+  const double variance = std::pow((config.yawRateNoise * degree / second).convert(radps), 2);
+  filter.update(
+    FixedVector<1>({iyawRate.convert(radps)}), H, FixedMatrix<1, 1>({variance}));
+}
+
+void DriveStateEstimator::reset() {
+  started = false;
+  filter.reset(Filter::State(), initialCovariance());
+}
+
+DriveStateEstimator::SideState DriveStateEstimator::getLeft() const {
+  return side(0);
+}
+
+DriveStateEstimator::SideState DriveStateEstimator::getRight() const {
+  return side(3);
+}
+
+QAngularSpeed DriveStateEstimator::getYawRate() const {
+  const auto &state = filter.getState();
+  return (state[1] - state[4]) / config.trackingScales.wheelTrack.convert(meter) * radps;
+}
+
+const DriveStateEstimator::Config &DriveStateEstimator::getConfig() const {
+  return config;
+}
+
+DriveStateEstimator::SideState DriveStateEstimator::side(const std::size_t ioffset) const {
+  const auto &state = filter.getState();
+  return {state[ioffset] * meter,
+          state[ioffset + 1] * mps,
+          state[ioffset + 2] * mps2};
+}
+
+DriveStateEstimator::Filter::Covariance DriveStateEstimator::initialCovariance() {
+  // The position is zeroed by the first tick reading; the robot may already be moving
+  Filter::Covariance covariance;
+  for (std::size_t offset = 0; offset < states; offset += 3) {
+    covariance(offset, offset) = 1e-6;
+    covariance(offset + 1, offset + 1) = 1;
+    covariance(offset + 2, offset + 2) = 10;
+  }
+  return covariance;
+}
@@ -0,0 +1,157 @@
+#include "feedbackMotionProfileController.hpp"
+#include "loopRate.hpp"
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using namespace okapi;
+
+namespace {
+/**
+ * Wraps an angle in radians to [-pi, pi].
+ */
+double wrapAngle(const double iangle) {
+  return std::remainder(iangle, 2 * 1_pi);
+}
+
+int sign(const double ivalue) {
+  return (ivalue > 0) - (ivalue < 0);
+}
+} // namespace
+
+FeedbackMotionProfileController::FeedbackMotionProfileController(
+  const TimeUtil &itimeUtil,
+  const PathfinderLimits &ilimits,
+  const std::shared_ptr<OdomChassisController> &ichassis,
+  const Gains &igains,
+  const std::shared_ptr<Logger> &ilogger)
+  : AsyncMotionProfileController(itimeUtil,
+                                 ilimits,
+                                 ichassis->getModel(),
+                                 ichassis->getChassisScales(),
+                                 ichassis->getGearsetRatioPair(),
+                                 ilogger),
+    chassis(ichassis),
+    gains(igains) {
+}
+
+void FeedbackMotionProfileController::setGains(const Gains &igains) {
+  std::scoped_lock lock(gainsMutex);
+  gains = igains;
+}
+
+FeedbackMotionProfileController::Gains FeedbackMotionProfileController::getGains() const {
+  std::scoped_lock lock(gainsMutex);
+  return gains;
+}
+
+FeedbackMotionProfileController::TrackingError
+FeedbackMotionProfileController::getTrackingError() const {
+  std::scoped_lock lock(gainsMutex);
+  return trackingError;
+}
+
+void FeedbackMotionProfileController::executeSinglePath(const TrajectoryPair &path,
+                                                        std::unique_ptr<AbstractRate> rate) {
+  TRACE_FUNCTION();
+  const auto skidSteer = std::dynamic_pointer_cast<SkidSteerModel>(model);
+  if (!skidSteer) {
+    LOG_ERROR_S("FeedbackMotionProfileController: The chassis model is not a SkidSteerModel. "
+                "Following the path open-loop.");
+    AsyncMotionProfileController::executeSinglePath(path, std::move(rate));
+    return;
+  }
+
+  const Gains pathGains = getGains();
+  const int reversed = direction.load();
+  const bool followMirrored = mirrored.load();
+  // Mirroring swaps the sides and reversing drives them backwards; both flip the turn direction
+  const int headingSign = reversed * (followMirrored ? -1 : 1);
+
+  const auto startTicks = model->getSensorVals();
+  // Odometry headings are clockwise-positive, Pathfinder headings are counter-clockwise-positive
+  const double startTheta = chassis->getState().theta.convert(radian);
+
+  // Waits on the controller's rate, and records how closely the segments keep to their dt
+  LoopRate segmentRate("path follower", std::move(rate));
+  TrackingError error;
+  double lastLeftError = 0;
+  double lastRightError = 0;
+
+  const int pathLength = getPathLength(path);
+  for (int i = 0; i < pathLength && !isDisabled(); ++i) {
+    currentPathMutex.lock();
+    Segment left = path.left.get()[i];
+    Segment right = path.right.get()[i];
+    const double startHeading = path.left.get()[0].heading;
+    currentPathMutex.unlock();
+
+    if (followMirrored) {
+      std::swap(left, right);
+    }
+
+    {
+      TRACE_SCOPE("path segment");
+      const auto ticks = model->getSensorVals();
+      const double leftPos = (ticks[0] - startTicks[0]) / scales.straight;
+      const double rightPos = (ticks[1] - startTicks[1]) / scales.straight;
+      const double leftError = reversed * left.position - leftPos;
+      const double rightError = reversed * right.position - rightPos;
+
+      const double expectedHeading = headingSign * wrapAngle(left.heading - startHeading);
+      const double heading = -(chassis->getState().theta.convert(radian) - startTheta);
+      const double headingError = wrapAngle(expectedHeading - heading);
+
+      const double leftVel = reversed * left.velocity;
+      const double rightVel = reversed * right.velocity;
+      const double turn = pathGains.kTurn * headingError;
+
+      const double leftVolts = pathGains.kS * sign(leftVel) + pathGains.kV * leftVel +
+                               pathGains.kA * reversed * left.acceleration +
+                               pathGains.kP * leftError +
+                               pathGains.kD * (leftError - lastLeftError) / left.dt - turn;
+      const double rightVolts = pathGains.kS * sign(rightVel) + pathGains.kV * rightVel +
+                                pathGains.kA * reversed * right.acceleration +
+                                pathGains.kP * rightError +
+                                pathGains.kD * (rightError - lastRightError) / right.dt + turn;
+
+      skidSteer->getLeftSideMotor()->moveVoltage(
+        static_cast<std::int16_t>(std::clamp(leftVolts * 1000, -12000.0, 12000.0)));
+      skidSteer->getRightSideMotor()->moveVoltage(
+        static_cast<std::int16_t>(std::clamp(rightVolts * 1000, -12000.0, 12000.0)));
+
+      LOG_DEBUG("FeedbackMotionProfileController: Segment " + std::to_string(i) + " error L " +
+                std::to_string(leftError) + " m, R " + std::to_string(rightError) + " m, heading " +
+                std::to_string(headingError) + " rad");
+
+      lastLeftError = leftError;
+      lastRightError = rightError;
+      error.finalLeft = leftError;
+      error.finalRight = rightError;
+      error.finalHeading = headingError;
+      error.maxDistance =
+        std::max({error.maxDistance, std::abs(leftError), std::abs(rightError)});
+    }
+
+    segmentRate.delayUntil(left.dt * second);
+  }
+
+  // Feedback keeps the motors powered at the end of the path, so release them explicitly
+  model->stop();
+
+  {
+    std::scoped_lock lock(gainsMutex);
+    trackingError = error;
+  }
+
+  currentPathMutex.lock();
+  const std::string pathId = currentPath;
+  currentPathMutex.unlock();
+
+  LOG_INFO("FeedbackMotionProfileController: Path " + pathId + " max error " +
+           std::to_string(error.maxDistance) + " m, final error L " +
+           std::to_string(error.finalLeft) + " m, R " + std::to_string(error.finalRight) +
+           " m, heading " + std::to_string(error.finalHeading) + " rad");
+}
@@ -0,0 +1,115 @@
+#include "fixedOdometry.hpp"
+#include "trace.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+using namespace okapi;
+
+namespace {
+/**
+ * One odometry step from the tick differences of the left, right and (with three encoders)
+ * middle wheels: TwoEncoderOdometry's and ThreeEncoderOdometry's math on an array.
+ *
+ * @return The change in state, or none if a difference is out of range or the math degenerates.
+ */
+template <std::size_t N>
+OdomState odomMathStep(const std::array<std::int32_t, N> &itickDiff,
+                       const ChassisScales &iscales,
+                       const QAngle &itheta) {
+  const double track = iscales.wheelTrack.convert(meter);
+  const double deltaL = itickDiff[0] / iscales.straight;
+  const double deltaR = itickDiff[1] / iscales.straight;
+  double deltaTheta = (deltaL - deltaR) / track;
+
+  double localOffX = 0;
+  double localOffY;
+  if (deltaTheta != 0) {
+    const double chord = 2 * std::sin(deltaTheta / 2);
+    localOffY = chord * (deltaR / deltaTheta + track / 2);
+    if constexpr (N == 3) {
+      const double deltaM = itickDiff[2] / iscales.middle;
+      localOffX = chord * (deltaM / deltaTheta + iscales.middleWheelDistance.convert(meter));
+    }
+  } else {
+    localOffY = deltaR;
+    if constexpr (N == 3) {
+      localOffX = itickDiff[2] / iscales.middle;
+    }
+  }
+
+  const double avgA = itheta.convert(radian) + deltaTheta / 2;
+  const double polarR = std::sqrt(localOffX * localOffX + localOffY * localOffY);
+  const double polarA = std::atan2(localOffY, localOffX) - avgA;
+
+  double dX = std::sin(polarA) * polarR;
+  double dY = std::cos(polarA) * polarR;
+  if (std::isnan(dX)) {
+    dX = 0;
+  }
+  if (std::isnan(dY)) {
+    dY = 0;
+  }
+  if (std::isnan(deltaTheta)) {
+    deltaTheta = 0;
+  }
+
+  return OdomState{dX * meter, dY * meter, deltaTheta * radian};
+}
+
+/**
+ * Reads the sensors and advances `iostate`, like TwoEncoderOdometry::step(). Returns false,
+ * leaving the state alone, if a tick difference exceeds `imaxTickDiff`.
+ */
+template <std::size_t N>
+bool fixedStep(const FixedSensorModel<N> &isensors,
+               std::array<std::int32_t, N> &iolast,
+               const ChassisScales &iscales,
+               const std::int32_t imaxTickDiff,
+               OdomState &iostate,
+               std::int32_t &obadDiff) {
+  const std::array<std::int32_t, N> ticks = isensors.getSensorArray();
+  std::array<std::int32_t, N> tickDiff;
+  for (std::size_t i = 0; i < N; i++) {
+    tickDiff[i] = ticks[i] - iolast[i];
+  }
+  iolast = ticks;
+
+  for (const std::int32_t diff : tickDiff) {
+    if (std::abs(diff) > imaxTickDiff) {
+      obadDiff = diff;
+      return false;
+    }
+  }
+
+  const OdomState delta = odomMathStep(tickDiff, iscales, iostate.theta);
+  iostate.x += delta.x;
+  iostate.y += delta.y;
+  iostate.theta += delta.theta;
+  return true;
+}
+} // namespace
+
+void FixedTwoEncoderOdometry::step() {
+  TRACE_SCOPE("FixedTwoEncoderOdometry::step");
+  if (timer->getDt().getValue() != 0) {
+    std::int32_t badDiff;
+    if (!fixedStep(*sensors, lastSensors, chassisScales, maximumTickDiff, state, badDiff)) {
+      LOG_ERROR("FixedTwoEncoderOdometry: A tick diff (" + std::to_string(badDiff) +
+                ") was greater than the maximum allowable diff (" +
+                std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
+    }
+  }
+}
+
+void FixedThreeEncoderOdometry::step() {
+  TRACE_SCOPE("FixedThreeEncoderOdometry::step");
+  if (timer->getDt().getValue() != 0) {
+    std::int32_t badDiff;
+    if (!fixedStep(*sensors, lastSensors, chassisScales, maximumTickDiff, state, badDiff)) {
+      LOG_ERROR("FixedThreeEncoderOdometry: A tick diff (" + std::to_string(badDiff) +
+                ") was greater than the maximum allowable diff (" +
+                std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
+    }
+  }
+}
@@ -0,0 +1,14 @@
+#include "fixedSensorModel.hpp"
+
+using namespace okapi;
+
+std::array<std::int32_t, 2> FixedSkidSteerModel::getSensorArray() const {
+  return {static_cast<std::int32_t>(leftSensor->get()),
+          static_cast<std::int32_t>(rightSensor->get())};
+}
+
+std::array<std::int32_t, 3> FixedThreeEncoderSkidSteerModel::getSensorArray() const {
+  return {static_cast<std::int32_t>(leftSensor->get()),
+          static_cast<std::int32_t>(rightSensor->get()),
+          static_cast<std::int32_t>(middleSensor->get())};
+}
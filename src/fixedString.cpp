@@ -0,0 +1,76 @@
+#include "fixedString.hpp"
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+bool isSpace(const char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * Copies a field to a null-terminated buffer for strtod and strtol. Numbers longer than the
+ * buffer aren't numbers anyone writes, so they fail.
+ */
+bool terminate(const std::string_view ifield, std::array<char, 32> &obuffer) {
+  const std::string_view field = trimText(ifield);
+  if (field.empty() || field.size() >= obuffer.size()) {
+    return false;
+  }
+  field.copy(obuffer.data(), field.size());
+  obuffer[field.size()] = '\0';
+  return true;
+}
+} // namespace
+
+std::string_view trimText(std::string_view itext) {
+  while (!itext.empty() && isSpace(itext.front())) {
+    itext.remove_prefix(1);
+  }
+  while (!itext.empty() && isSpace(itext.back())) {
+    itext.remove_suffix(1);
+  }
+  return itext;
+}
+
+std::string_view nextField(std::string_view &ioline, const char idelimiter) {
+  while (!ioline.empty() && ioline.front() == idelimiter) {
+    ioline.remove_prefix(1);
+  }
+
+  const std::size_t end = ioline.find(idelimiter);
+  const std::string_view field = ioline.substr(0, end);
+  ioline.remove_prefix(end == std::string_view::npos ? ioline.size() : end + 1);
+  return field;
+}
+
+bool parseNumber(const std::string_view ifield, double &ovalue) {
+  std::array<char, 32> buffer;
+  if (!terminate(ifield, buffer)) {
+    return false;
+  }
+
+  char *end = nullptr;
+  errno = 0;
+  const double value = std::strtod(buffer.data(), &end);
+  if (*end != '\0' || errno == ERANGE) {
+    return false;
+  }
+  ovalue = value;
+  return true;
+}
+
+bool parseNumber(const std::string_view ifield, std::int32_t &ovalue) {
+  std::array<char, 32> buffer;
+  if (!terminate(ifield, buffer)) {
+    return false;
+  }
+
+  char *end = nullptr;
+  errno = 0;
+  const long value = std::strtol(buffer.data(), &end, 10);
+  if (*end != '\0' || errno == ERANGE || value < INT32_MIN || value > INT32_MAX) {
+    return false;
+  }
+  ovalue = static_cast<std::int32_t>(value);
+  return true;
+}
@@ -0,0 +1,116 @@
+#include "leastSquaresVelMath.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace okapi;
+
+LeastSquaresVelMath::LeastSquaresVelMath(const double iticksPerRev,
+                                         const std::size_t iwindow,
+                                         std::unique_ptr<AbstractTimer> iloopDtTimer,
+                                         const int iorder,
+                                         std::shared_ptr<Logger> ilogger)
+  : VelMath(iticksPerRev,
+            std::make_unique<PassthroughFilter>(),
+            0_ms,
+            std::move(iloopDtTimer),
+            std::move(ilogger)),
+    samples(iwindow),
+    window(iwindow),
+    order(iorder) {
+  if ((order != 1 && order != 2) || window < static_cast<std::size_t>(order) + 1) {
+    const std::string msg = "LeastSquaresVelMath: A window of " + std::to_string(window) +
+                            " samples can't fit a polynomial of order " + std::to_string(order) +
+                            ".";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+QAngularSpeed LeastSquaresVelMath::step(const double inewPos) {
+  return step(inewPos, loopDtTimer->millis());
+}
+
+QAngularSpeed LeastSquaresVelMath::step(const double inewPos, const QTime itimestamp) {
+  const double time = itimestamp.convert(second);
+  if (count > 0) {
+    const double newestTime = samples[newest].time;
+    if (time == newestTime) {
+      // The sensor hasn't updated since the last sample
+      return vel;
+    }
+    if (time < newestTime) {
+      // The clock went backwards, e.x. the sensor was replaced; the old samples don't fit
+      reset();
+    }
+  }
+
+  newest = (newest + 1) % window;
+  samples[newest] = {time, inewPos};
+  if (count < window) {
+    count++;
+  }
+
+  fit();
+  lastPos = inewPos;
+  return vel;
+}
+
+void LeastSquaresVelMath::reset() {
+  count = 0;
+  newest = 0;
+  vel = 0_rpm;
+  lastVel = 0_rpm;
+  accel = 0_rpm / second;
+}
+
+void LeastSquaresVelMath::fit() {
+  if (count < 2) {
+    return;
+  }
+
+  // Sums of t^k and t^k * x over the window. Times and positions are taken relative to the newest
+  // sample, which keeps the sums well conditioned and puts the point of interest at t = 0.
+  const Sample &origin = samples[newest];
+  double t[5]{};
+  double tx[3]{};
+  for (std::size_t i = 0; i < count; i++) {
+    const Sample &sample = samples[(newest + window - i) % window];
+    const double dt = sample.time - origin.time;
+    const double dx = sample.position - origin.position;
+    double power = 1;
+    for (int k = 0; k < 5; k++) {
+      t[k] += power;
+      if (k < 3) {
+        tx[k] += power * dx;
+      }
+      power *= dt;
+    }
+  }
+
+  // Solve the normal equations for x = c0 + c1 t + c2 t^2 by Cramer's rule; with too few samples
+  // for a parabola, or samples which can't tell one apart from a line, fit a line instead
+  double c1 = 0;
+  double c2 = 0;
+  const double det3 = t[0] * (t[2] * t[4] - t[3] * t[3]) - t[1] * (t[1] * t[4] - t[3] * t[2]) +
+                      t[2] * (t[1] * t[3] - t[2] * t[2]);
+  if (order == 2 && count >= 3 && std::abs(det3) > 1e-12 * t[0] * t[2] * t[4]) {
+    c1 = (t[0] * (tx[1] * t[4] - t[3] * tx[2]) - tx[0] * (t[1] * t[4] - t[3] * t[2]) +
+          t[2] * (t[1] * tx[2] - tx[1] * t[2])) /
+         det3;
+    c2 = (t[0] * (t[2] * tx[2] - tx[1] * t[3]) - t[1] * (t[1] * tx[2] - tx[1] * t[2]) +
+          tx[0] * (t[1] * t[3] - t[2] * t[2])) /
+         det3;
+  } else {
+    const double det2 = t[0] * t[2] - t[1] * t[1];
+    if (det2 <= 0) {
+      return;
+    }
+    c1 = (t[0] * tx[1] - t[1] * tx[0]) / det2;
+  }
+
+  lastVel = vel;
+  vel = c1 * (60.0 / ticksPerRev) * rpm;
+  accel = 2 * c2 * (60.0 / ticksPerRev) * rpm / second;
+}
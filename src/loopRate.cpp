@@ -0,0 +1,235 @@
+#include "loopRate.hpp"
+#include "allocationCounter.hpp"
+#include "microClock.hpp"
+#include <array>
+#include <cstring>
+#ifdef THREADS_STD
+#include <chrono>
+#include <thread>
+#else
+#include "pros/rtos.hpp"
+#endif
+
+using namespace okapi;
+
+namespace {
+// Periods more than an RTOS tick off count as late
+constexpr std::uint32_t jitterLimitUs = 1000;
+} // namespace
+
+struct LoopRate::Table {
+  CrossplatformMutex lock;
+  std::size_t used{0};
+  std::array<Stats, maxLoops> loops;
+};
+
+LoopRate::LoopRate(const char *iname, const std::uint32_t iperiodMs)
+  : LoopRate(iname, nullptr, iperiodMs) {
+}
+
+LoopRate::LoopRate(const char *iname,
+                   std::unique_ptr<AbstractRate> irate,
+                   const std::uint32_t iperiodMs)
+  : name(iname), rate(std::move(irate)), periodMs(iperiodMs), stats(&statsFor(iname, iperiodMs)) {
+}
+
+LoopRate::~LoopRate() = default;
+
+LoopRate::Table &LoopRate::table() {
+  static Table instance;
+  return instance;
+}
+
+LoopRate::Stats &LoopRate::statsFor(const char *iname, const std::uint32_t iperiodMs) {
+  auto &loops = table();
+  loops.lock.lock();
+  for (std::size_t i = 0; i < loops.used; i++) {
+    Stats &line = loops.loops[i];
+    if (line.periodMs == iperiodMs && std::strcmp(line.name, iname) == 0) {
+      loops.lock.unlock();
+      return line;
+    }
+  }
+
+  if (loops.used == maxLoops) {
+    // Full, so this loop is counted with the others past the limit
+    loops.lock.unlock();
+    return loops.loops[maxLoops - 1];
+  }
+
+  Stats &line = loops.loops[loops.used++];
+  line.name = loops.used == maxLoops ? "other loops" : iname;
+  line.periodMs = iperiodMs;
+  line.jitter = TimingStats(jitterLimitUs);
+  line.work = TimingStats(iperiodMs * 1000);
+  line.allocations = TimingStats(0);
+  loops.lock.unlock();
+  return line;
+}
+
+void LoopRate::delayUntilNext() {
+  delayUntil(periodMs);
+}
+
+void LoopRate::delay(const QFrequency ihz) {
+  delayUntil(static_cast<std::uint32_t>(1000 / ihz.convert(Hz)));
+}
+
+void LoopRate::delayUntil(const QTime itime) {
+  delayUntil(static_cast<std::uint32_t>(itime.convert(millisecond)));
+}
+
+void LoopRate::delayUntil(const uint32_t ims) {
+  const std::uint64_t asleep = microClock();
+  const bool countAllocations = AllocationCounter::isCounting();
+  if (started) {
+    const std::uint32_t allocated =
+      countAllocations ? AllocationCounter::getTaskCount() - wakeAllocations : 0;
+    stats->lock.lock();
+    stats->work.add(static_cast<std::uint32_t>(asleep - wakeUs));
+    if (countAllocations) {
+      stats->allocations.add(allocated);
+    }
+    stats->lock.unlock();
+  }
+
+  if (rate) {
+    rate->delayUntil(ims);
+  } else {
+#ifdef THREADS_STD
+    static const auto epoch = std::chrono::steady_clock::now();
+    if (!started) {
+      lastTime = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                              std::chrono::steady_clock::now() - epoch)
+                                              .count());
+    }
+    lastTime += ims;
+    std::this_thread::sleep_until(epoch + std::chrono::milliseconds(lastTime));
+#else
+    if (!started) {
+      lastTime = pros::millis();
+    }
+    pros::Task::delay_until(&lastTime, ims);
+#endif
+  }
+
+  const std::uint64_t woke = microClock();
+  if (started) {
+    const std::int64_t period = static_cast<std::int64_t>(woke - wakeUs);
+    const std::int64_t error = period - static_cast<std::int64_t>(ims) * 1000;
+    stats->lock.lock();
+    stats->jitter.add(static_cast<std::uint32_t>(error < 0 ? -error : error));
+    stats->count++;
+    stats->lock.unlock();
+  }
+  started = true;
+  wakeUs = woke;
+  if (countAllocations) {
+    wakeAllocations = AllocationCounter::getTaskCount();
+  }
+}
+
+void LoopRate::clearStats() {
+  stats->lock.lock();
+  stats->jitter.clear();
+  stats->work.clear();
+  stats->allocations.clear();
+  stats->count = 0;
+  stats->lock.unlock();
+}
+
+const char *LoopRate::getName() const {
+  return name;
+}
+
+std::uint32_t LoopRate::getCount() const {
+  return stats->count;
+}
+
+TimingStats LoopRate::getJitter() const {
+  stats->lock.lock();
+  const TimingStats out = stats->jitter;
+  stats->lock.unlock();
+  return out;
+}
+
+TimingStats LoopRate::getWork() const {
+  stats->lock.lock();
+  const TimingStats out = stats->work;
+  stats->lock.unlock();
+  return out;
+}
+
+TimingStats LoopRate::getAllocations() const {
+  stats->lock.lock();
+  const TimingStats out = stats->allocations;
+  stats->lock.unlock();
+  return out;
+}
+
+int LoopRate::format(char *obuffer, const std::size_t isize) const {
+  stats->lock.lock();
+  const unsigned long jitter99 = stats->jitter.getPercentile(0.99);
+  const unsigned long overruns = stats->work.getOverLimit();
+  const unsigned long allocating = stats->allocations.getOverLimit();
+  stats->lock.unlock();
+  if (!AllocationCounter::isCounting()) {
+    return snprintf(obuffer,
+                    isize,
+                    "%s %lums jit99 %luus %lu over",
+                    name,
+                    static_cast<unsigned long>(periodMs),
+                    jitter99,
+                    overruns);
+  }
+  return snprintf(obuffer,
+                  isize,
+                  "%s %lums jit99 %luus %lu over %lu alloc",
+                  name,
+                  static_cast<unsigned long>(periodMs),
+                  jitter99,
+                  overruns,
+                  allocating);
+}
+
+void LoopRate::printAll(FILE *ifile) {
+  auto &loops = table();
+  fprintf(ifile,
+          "%-20s %4s %8s %8s %8s %6s %8s %8s %8s %8s %9s\n",
+          "loop",
+          "ms",
+          "periods",
+          "jit p99",
+          "jit max",
+          "late",
+          "work p99",
+          "work max",
+          "overruns",
+          "it alloc",
+          "max alloc");
+  loops.lock.lock();
+  const std::size_t used = loops.used;
+  loops.lock.unlock();
+  // Lines are only ever added, so the first `used` stay where they are without the table's lock
+  for (std::size_t i = 0; i < used; i++) {
+    print(ifile, loops.loops[i]);
+  }
+}
+
+void LoopRate::print(FILE *ifile, Stats &istats) {
+  istats.lock.lock();
+  fprintf(ifile,
+          "%-20s %4lu %8lu %8lu %8lu %6lu %8lu %8lu %8lu %8lu %9lu\n",
+          istats.name,
+          static_cast<unsigned long>(istats.periodMs),
+          static_cast<unsigned long>(istats.count),
+          static_cast<unsigned long>(istats.jitter.getPercentile(0.99)),
+          static_cast<unsigned long>(istats.jitter.getMax()),
+          static_cast<unsigned long>(istats.jitter.getOverLimit()),
+          static_cast<unsigned long>(istats.work.getPercentile(0.99)),
+          static_cast<unsigned long>(istats.work.getMax()),
+          static_cast<unsigned long>(istats.work.getOverLimit()),
+          static_cast<unsigned long>(istats.allocations.getOverLimit()),
+          static_cast<unsigned long>(istats.allocations.getMax()));
+  istats.lock.unlock();
+}
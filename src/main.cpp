@@ -1,4 +1,20 @@
 #include "main.h"
+#include "allocationCounter.hpp"
+#include "asyncLogFile.hpp"
+#include "autonGraph.hpp"
+#include "autonTimeline.hpp"
+#include "characterization.hpp"
+#include "driveInput.hpp"
+#include "feedbackMotionProfileController.hpp"
+#include "fixedString.hpp"
+#include "loopRate.hpp"
+#include "motionChain.hpp"
+#include "profiledMechanism.hpp"
+#include "scriptScheduler.hpp"
+#include "sensorRecorder.hpp"
+#include "trace.hpp"
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <sys/stat.h>
 
@@ -56,13 +72,16 @@ auto chassis = ChassisControllerBuilder()
 	.withSensors(ADIEncoder{'E','F'}, ADIEncoder{'G','H',true})
 	.withDimensions(okapi::AbstractMotor::gearset::green, {{2.75_in, 5.25_in}, okapi::quadEncoderTPR})
 	.withOdometry()
-	.withLogger(
-		std::make_shared<okapi::Logger>(
+	.withLogger([] {
+		//Buffered in memory and written by a background task, so debug logging doesn't stall the control loops on the SD card
+		auto logFile = AsyncLogFile::open(okapi::TimeUtilFactory::createDefault(), "/usd/logging.txt");
+		//open() returns nullptr without an SD card; a Logger with no file logs nothing
+		return std::make_shared<okapi::Logger>(
 			okapi::TimeUtilFactory::createDefault().getTimer(),
-			"/usd/logging.txt",
+			logFile ? logFile->getFile() : nullptr,
 			okapi::Logger::LogLevel::debug
-		)
-	)
+		);
+	}())
 	.buildOdometry();
 */
 auto chassis = ChassisControllerBuilder()
@@ -81,13 +100,70 @@ auto chassis = ChassisControllerBuilder()
     .withOdometry() // use the same scales as the chassis (above)
     .buildOdometry(); // build an odometry chassis
 
-auto profile = okapi::AsyncMotionProfileControllerBuilder()
+//Closed-loop path follower. kV starts from free speed (12 V / 1.097 m/s)
+auto profile = []() {
+	auto controller = std::make_shared<FeedbackMotionProfileController>(
+		TimeUtilFactory::createDefault(),
+		PathfinderLimits{
+			1.097, //Max linear velocity, 1.15
+			4.7, //Max linear acceleration, 5.275, 6.75
+			5.75}, //Max linear jerk, 11
+		chassis,
+		FeedbackMotionProfileController::Gains{
+			20.0, //kP, V/m
+			0.0, //kD, V/(m/s)
+			10.9, //kV, V/(m/s)
+			0.0, //kA, V/(m/s^2)
+			0.0, //kS, V
+			3.0}); //kTurn, V/rad
+	controller->startThread();
+	return controller;
+}();
+
+//Records when each drive motion, mechanism and fixed delay ran in autonomous; reported in disabled()
+AutonTimeline autonTimeline(TimeUtilFactory::createDefault());
+
+//Helper tasks claim the lane whose motors they drive; the driver loop leaves a claimed lane's motors alone, since its writes every tick would otherwise win over a helper's
+std::array<std::atomic_int, AutonTimeline::laneCount> laneClaims{};
+
+struct MotorClaim {
+	explicit MotorClaim(AutonTimeline::Lane ilane) : claims(laneClaims[static_cast<std::size_t>(ilane)]) { claims++; }
+	~MotorClaim() { claims--; }
+	std::atomic_int &claims;
+};
+
+bool isClaimed(AutonTimeline::Lane ilane) {
+	return laneClaims[static_cast<std::size_t>(ilane)] > 0;
+}
+
+//Runs autonomous chassis motions with predictive settling; setChaining(true) blends them together
+MotionChain chain(chassis, TimeUtilFactory::createDefault());
+
+//Set to record the drive's sensors through autonomous to /usd/sensors.csv (replay with tools/sensorReplay)
+bool recordSensors = false;
+SensorRecorder sensorRecorder(TimeUtilFactory::createDefault(), std::static_pointer_cast<SkidSteerModel>(chassis->getModel()));
+
+//Tray and arm profiles are in motor revolutions: a 1/pi m "diameter" makes 1 m one revolution
+auto trayProfile = okapi::AsyncMotionProfileControllerBuilder()
+	.withLimits({
+		3.0, //Max velocity, rev/s (180 rpm)
+		12.0, //Max acceleration, rev/s^2
+		60.0}) //Max jerk, rev/s^3
+	.withOutput(okapi::Motor(TRAY_PORT, true, AbstractMotor::gearset::green, AbstractMotor::encoderUnits::degrees), 1_m / 1_pi, AbstractMotor::gearset::green)
+	.buildLinearMotionProfileController();
+
+auto armProfile = okapi::AsyncMotionProfileControllerBuilder()
 	.withLimits({
-		1.097, //Max linear velocity, 1.15
-		4.7, //Max linear acceleration, 5.275, 6.75
-		5.75}) //Max linear jerk, 11
-	.withOutput(chassis)
-	.buildMotionProfileController();
+		3.3, //Max velocity, rev/s (200 rpm)
+		15.0, //Max acceleration, rev/s^2
+		80.0}) //Max jerk, rev/s^3
+	.withOutput(okapi::Motor(ARM_PORT, false, AbstractMotor::gearset::green, AbstractMotor::encoderUnits::degrees), 1_m / 1_pi, AbstractMotor::gearset::green)
+	.buildLinearMotionProfileController();
+
+//Tray targets are angler readings, converted to tray motor degrees by /usd/tray.cal (see calibrateTray)
+ProfiledMechanism trayMechanism(trayProfile, [] { return (double)angler.get_value(); }, CalibrationTable());
+//Arm targets are arm motor degrees
+ProfiledMechanism armMechanism(armProfile, [] { return arm.get_position(); }, CalibrationTable::identity());
 
 int a = sqrt(6000);
 int b = 180;
@@ -107,18 +183,41 @@ int nestedTime = 400;
 int nestedDelay = 100;
 int armDelay = 0;
 //0 for L path, 1 for Z path skills, 2 for square path, 3 for mischellaneous testing, 4 for Z path auton
+//7 for drivetrain characterization (needs 1.5m clear in front, writes /usd/characterization.csv)
 int autonMode = 6;
 int sideSelector = -1;//1 for red, -1 for blue
 int stackDelay = 500;
 int stageDelay = 1000;
 int armDist = 50;
 bool toggleControl = true;
+//Driver stick response: deadband 5 and 60% cubic, power slews 12/tick speeding up and 20/tick slowing down
+//Traction limiting is off (0 mA) until a threshold is picked from measured current; the drive motors pass 2.5 A accelerating hard
+DriveInputShaper driveShaper(InputCurve::cubic(5, 0.6), {12, 20, 0});
 bool trigger = false;
 int rev = 1;
 std::ofstream logger;
 
 int logtime = 0;
 
+//Set to run autonomous modes 0-6 as step graphs (buildAutonGraph) instead of straight-line code
+bool useAutonGraph = false;
+//atDistance conditions measure the drive motors' average travel
+AutonGraph autonGraph(TimeUtilFactory::createDefault(), [] {
+	return (left_motor1.get_position() + right_motor1.get_position()) / 2 / 360 * 2 * PI * r * meter;
+});
+
+//Set to run autonomous mode 6 as scripts sharing autonomous()'s task (spawnMode6Scripts) instead of a task per mechanism
+bool useAutonScripts = false;
+ScriptScheduler autonScripts(TimeUtilFactory::createDefault(), 24);
+
+/**
+ * Returns the id of a path compiled for the current alliance color. Paths marked "sides" in
+ * tools/playbook.txt are stored once per color.
+ */
+std::string sidePath(const std::string &id) {
+	return id + (sideSelector == 1 ? "-red" : "-blue");
+}
+
 /**
  * Runs the user autonomous code. This function will be started in its own task
  * with the default priority and stack size whenever the robot is enabled via
@@ -228,21 +327,29 @@ void generateCurve(std::string s, bool t) {
 }
 
 void moveDistanceSmooth(std::string s) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::drive, s.c_str());
+	MotorClaim claim(AutonTimeline::Lane::drive);
 	left_encoder.reset();
 	right_encoder.reset();
 	pros::lcd::set_text(2, "Moving distance" + s);
-	std::ifstream input;
-	std::string read;
-	input.open(s);
-	getline(input, read);
-	timeme = stod(read);
-	getline(input, read);
-	pros::lcd::set_text(6, read);
-	while(input) {
-		getline(input, read);
-		double speed = stod(read.substr(0, read.find(" ") - 1));
-		double distance = stod(read.substr(read.find(" ") + 1));
-		double location = std::stod(read.substr(read.find(" ")));
+	//Lines are read into a fixed buffer and parsed in place, so following the curve doesn't allocate
+	FILE* input = fopen(s.c_str(), "r");
+	if(!input) {
+		return;
+	}
+	char read[64] = "";
+	fgets(read, sizeof(read), input);
+	parseNumber(read, timeme);
+	fgets(read, sizeof(read), input);
+	pros::c::lcd_set_text(6, read);
+	//Each line is 10 ms of the curve, so the follower has to hold 100 Hz
+	LoopRate rate("moveDistanceSmooth");
+	while(fgets(read, sizeof(read), input)) {
+		std::string_view fields = trimText(read);
+		double speed = 0;
+		double location = 0;
+		parseNumber(nextField(fields), speed);
+		parseNumber(nextField(fields), location);
 		/*
 		double calculatedLoc = (left_encoder.get()/360 + right_encoder.get()/360) * PI * r2;
 		double percDiff = abs((location - calculatedLoc) / location);
@@ -252,11 +359,11 @@ void moveDistanceSmooth(std::string s) {
 		left_motor2.move(speed);
 		right_motor1.move(speed);
 		right_motor2.move(speed);
-		pros::lcd::set_text(5,std::to_string(left_encoder.get()));
-		pros::lcd::set_text(5,std::to_string(right_encoder.get()));
-		pros::delay(10);
+		pros::c::lcd_set_text(5, FixedString<24>("%f", left_encoder.get()).c_str());
+		pros::c::lcd_set_text(5, FixedString<24>("%f", right_encoder.get()).c_str());
+		rate.delayUntilNext();
 	}
-	input.close();
+	fclose(input);
 	left_motor1.move(0);
 	left_motor2.move(0);
 	right_motor1.move(0);
@@ -264,13 +371,17 @@ void moveDistanceSmooth(std::string s) {
 }
 
 void forwardTask(void* param) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::drive, "forward");
+	MotorClaim claim(AutonTimeline::Lane::drive);
 	int time = pros::c::millis();
+	LoopRate rate("forwardTask");
 	while(pros::c::millis() - time <= moveTime)
 	{
 		left_motor1.move_velocity(125);
 		left_motor2.move_velocity(125);
 		right_motor1.move_velocity(125);
 		right_motor2.move_velocity(125);
+		rate.delayUntilNext();
 	}
 	left_motor1.move_velocity(0);
 	left_motor2.move_velocity(0);
@@ -279,13 +390,17 @@ void forwardTask(void* param) {
 }
 
 void backwardTask(void* param) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::drive, "backward");
+	MotorClaim claim(AutonTimeline::Lane::drive);
 	int time = pros::c::millis();
+	LoopRate rate("backwardTask");
 	while(pros::c::millis() - time <= moveTime)
 	{
 		left_motor1.move_velocity(-75);
 		left_motor2.move_velocity(-75);
 		right_motor1.move_velocity(-75);
 		right_motor2.move_velocity(-75);
+		rate.delayUntilNext();
 	}
 	left_motor1.move_velocity(0);
 	left_motor2.move_velocity(0);
@@ -294,136 +409,194 @@ void backwardTask(void* param) {
 }
 
 void outtakeTask(void* param) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::intake, "outtake");
+	MotorClaim claim(AutonTimeline::Lane::intake);
 	int time = pros::c::millis();
+	LoopRate rate("outtakeTask");
 	while(pros::c::millis() - time <= 750)
 	{
 		intake1.move_velocity(-125);
 		intake2.move_velocity(-125);
+		rate.delayUntilNext();
 	}
 	intake1.move_velocity(0);
 	intake2.move_velocity(0);
 }
 
 void trayAdjust(void* param) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::tray, "tray adjust");
+	MotorClaim claim(AutonTimeline::Lane::tray);
 	int trayPos = tray.get_position();
+	LoopRate up("trayAdjust up");
 	while(tray.get_position() < trayPos + 550)
 	{
 		tray.move_velocity(100);
+		up.delayUntilNext();
 	}
 	pros::delay(250);
 	trayPos = tray.get_position();
+	LoopRate down("trayAdjust down");
 	while(tray.get_position() > trayPos - 550)
 	{
 		tray.move_velocity(-100);
+		down.delayUntilNext();
 	}
 	tray.move_velocity(0);
 }
 
-void trayTask(void* param) {
+/**
+ * Sweeps the tray up slowly and records angler readings against tray motor degrees, then saves
+ * them to /usd/tray.cal for the profiled tray. Start with the tray all the way down.
+ */
+void calibrateTray() {
+	MotorClaim claim(AutonTimeline::Lane::tray);
+	CalibrationTable table;
+	int lastAngler = -1000;
+	tray.move_velocity(30);
+	LoopRate rate("calibrateTray");
+	while(angler.get_value() < 2500)
+	{
+		int reading = angler.get_value();
+		if(reading - lastAngler >= 10) {
+			table.addPoint(reading, tray.get_position());
+			lastAngler = reading;
+		}
+		rate.delayUntilNext();
+	}
+	tray.move_velocity(0);
+	table.save("/usd/tray.cal");
+	trayMechanism.setCalibration(table);
+	pros::lcd::set_text(3, "Tray calibrated");
+}
+
+//Raises the tray to stack; trayTask and the autonomous graphs share it
+void stackTray() {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::tray, "tray stack");
+	MotorClaim claim(AutonTimeline::Lane::tray);
 	//2475
 	//1453
 	int trayPos = 0;
-	while(angler.get_value() < trayPos + 1850)//2450, 2100
-	{
-		tray.move_velocity(200);//150
+	if(trayMechanism.getCalibration().isCalibrated()) {
+		trayMechanism.setTarget(trayPos + 2260);
+		trayMechanism.waitUntilSettled();
 	}
-	while(angler.get_value() < trayPos + 2260)//2650, 2475
-	{
-		tray.move_velocity(125);//100
-		//intake1.move_velocity(100);
-		//intake2.move_velocity(100);
+	else {
+		LoopRate rate("trayTask");
+		while(angler.get_value() < trayPos + 1850)//2450, 2100
+		{
+			tray.move_velocity(200);//150
+			rate.delayUntilNext();
+		}
+		while(angler.get_value() < trayPos + 2260)//2650, 2475
+		{
+			tray.move_velocity(125);//100
+			//intake1.move_velocity(100);
+			//intake2.move_velocity(100);
+			rate.delayUntilNext();
+		}
+		tray.move_velocity(0);
 	}
-	tray.move_velocity(0);
 	//intake1.move_velocity(0);
 	//intake2.move_velocity(0);
+}
+
+void trayTask(void* param) {
+	stackTray();
 	pros::Task outtake (outtakeTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outtake");
-	pros::delay(125);
+	autonTimeline.delay(125);
 	pros::Task backward (backwardTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Backward");
 }
 
 void trayTaskOP(void* param) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::tray, "tray stack");
+	MotorClaim claim(AutonTimeline::Lane::tray);
 	//2475
 	//1453;
 	int trayPos = 0;
+	if(trayMechanism.getCalibration().isCalibrated()) {
+		trayMechanism.setTarget(trayPos + 2240);
+		trayMechanism.waitUntilSettled();
+		return;
+	}
+	LoopRate rate("trayTaskOP");
 	while(angler.get_value() < trayPos + 1805)//1900
 	{
 		tray.move_velocity(160);//125
+		rate.delayUntilNext();
 	}
 	while(angler.get_value() < trayPos + 2240)//2650
 	{
 		tray.move_velocity(92);//75
+		rate.delayUntilNext();
 	}
 	tray.move_velocity(0);
 }
 
-void armTask(void* param) {
-	pros::delay(armDelay);
-	arm.set_zero_position(arm.get_position());
-	int armPos = arm.get_position();
-	while(arm.get_position() < armPos + armDist)
-	{
-		arm.move_velocity(200);
-	}
-	arm.move_velocity(0);
+//Moves the arm by dist degrees with its profile
+void raiseArm(int dist) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::arm, "arm");
+	MotorClaim claim(AutonTimeline::Lane::arm);
+	armMechanism.setTarget(arm.get_position() + dist);
+	armMechanism.waitUntilSettled();
 }
 
-void armFall(void* param) {
-	pros::delay(armDelay);
+//Drops the arm by up to -dist degrees, or until it reaches the lower limit switch
+void lowerArm(int dist) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::arm, "arm fall");
+	MotorClaim claim(AutonTimeline::Lane::arm);
 	arm.set_zero_position(arm.get_position());
 	int armPos = arm.get_position();
-	while(arm.get_position() > armPos + armDist && arm_lower.get_value() != 1)
+	LoopRate rate("armFall");
+	while(arm.get_position() > armPos + dist && arm_lower.get_value() != 1)
 	{
 		arm.move_velocity(-150);
+		rate.delayUntilNext();
 	}
 	arm.move_velocity(0);
 }
 
-void intake(void* param) {
-	pros::delay(runDelay);
+//Runs the intakes at speed for timeMs, or until stop returns true
+void spinIntake(const char* name, int speed, int timeMs, std::function<bool()> stop = nullptr) {
+	AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::intake, name);
+	MotorClaim claim(AutonTimeline::Lane::intake);
 	int time = pros::c::millis();
-	while(pros::c::millis() - time <= runTime)
+	LoopRate rate(name);
+	while(pros::c::millis() - time <= timeMs && !(stop && stop()))
 	{
-		pros::lcd::set_text(1,std::to_string(tray.get_position()));
-		intake1.move_velocity(runSpeed);
-		intake2.move_velocity(runSpeed);
+		pros::c::lcd_set_text(1, FixedString<24>("%f", tray.get_position()).c_str());
+		intake1.move_velocity(speed);
+		intake2.move_velocity(speed);
+		rate.delayUntilNext();
 	}
 	intake1.move_velocity(0);
 	intake2.move_velocity(0);
 }
 
+void armTask(void* param) {
+	autonTimeline.delay(armDelay);
+	raiseArm(armDist);
+}
+
+void armFall(void* param) {
+	autonTimeline.delay(armDelay);
+	lowerArm(armDist);
+}
+
+void intake(void* param) {
+	autonTimeline.delay(runDelay);
+	spinIntake("intake", runSpeed, runTime);
+}
+
 void nestedIntake(void* param) {
-	pros::delay(runDelay);
-	int time = pros::c::millis();
-	while(pros::c::millis() - time <= runTime)
-	{
-		pros::lcd::set_text(1,std::to_string(tray.get_position()));
-		intake1.move_velocity(runSpeed);
-		intake2.move_velocity(runSpeed);
-	}
-	intake1.move_velocity(0);
-	intake2.move_velocity(0);
-	pros::delay(nestedDelay);
-	time = pros::c::millis();
-	while(pros::c::millis() - time <= nestedTime)
-	{
-		intake1.move_velocity(runSpeed);
-		intake2.move_velocity(runSpeed);
-	}
-	intake1.move_velocity(0);
-	intake2.move_velocity(0);
+	autonTimeline.delay(runDelay);
+	spinIntake("intake", runSpeed, runTime);
+	autonTimeline.delay(nestedDelay);
+	spinIntake("intake nested", runSpeed, nestedTime);
 }
 
 void outtake(void* param) {
-	pros::delay(runDelay);
-	int time = pros::c::millis();
-	while(pros::c::millis() - time <= runTime)
-	{
-		pros::lcd::set_text(1,std::to_string(tray.get_position()));
-		intake1.move_velocity(-runSpeed);
-		intake2.move_velocity(-runSpeed);
-	}
-	intake1.move_velocity(0);
-	intake2.move_velocity(0);
+	autonTimeline.delay(runDelay);
+	spinIntake("outtake", -runSpeed, runTime);
 }
 
 /**
@@ -453,9 +626,13 @@ void initialize() {
 	pros::lcd::initialize();
 	pros::lcd::set_text(1, "Hello PROS User!");
 	pros::lcd::register_btn1_cb(on_center_button);
-	profile->generatePath({{0_m, 0_m, 0_deg},{0.45_m, (sideSelector)*-0.609_m, 0_deg}}, "S");
-	profile->generatePath({{0_m, 0_m, 0_deg},{0.80_m, 0_m, 0_deg}}, "A");
-	profile->generatePath({{0_m, 0_m, 0_deg},{0.60_m, 0_m, 0_deg}}, "B");
+	TRACE_START();
+	chain.setTimeline(&autonTimeline);
+	//Paths are compiled on the host from tools/playbook.txt (make -C tools paths)
+	profile->loadPath("/usd/paths", sidePath("S"));
+	profile->loadPath("/usd/paths", "A");
+	profile->loadPath("/usd/paths", "B");
+	trayMechanism.setCalibration(CalibrationTable::load("/usd/tray.cal"));
 	bool gen = false;
 	rev = -1;
 	dist = 0.40;
@@ -521,7 +698,16 @@ void initialize() {
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+	//Helper tasks can outlast autonomous(), so its timeline is closed once the period is over
+	if(autonTimeline.isRecording()) {
+		autonTimeline.stop();
+		autonTimeline.printReport();
+		autonTimeline.save("/usd/timeline.csv");
+	}
+	//Tracing is compiled in with TRACING:=1; this keeps what the match recorded
+	TRACE_SAVE("/usd/trace.json");
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -534,6 +720,372 @@ void disabled() {}
  */
 void competition_initialize() {}
 
+//Adds the tray stack with the release after it: outtake and back away, as trayTask does
+AutonGraph::StepId addStack(AutonGraph &graph, std::vector<AutonGraph::Condition> conditions) {
+	using Lane = AutonTimeline::Lane;
+	auto stack = graph.add("tray stack", Lane::tray, stackTray, std::move(conditions));
+	graph.add("release", Lane::intake, [] { outtakeTask(nullptr); }, {AutonGraph::after(stack)});
+	return graph.add("back away", Lane::drive, [] { backwardTask(nullptr); }, {AutonGraph::after(stack, 125_ms)});
+}
+
+/**
+ * Builds autonomous modes 0-6 as step graphs. Each keeps the straight-line routine's timing, but
+ * states what a step waits on instead of spawning a task and padding with a delay, and an intake
+ * run meant to last through the driving stops when that drive does.
+ */
+void buildAutonGraph(AutonGraph &graph, int mode) {
+	using Lane = AutonTimeline::Lane;
+	using A = AutonGraph;
+	graph.clear();
+	if(mode == 0)
+	{
+		auto deploy = graph.add("deploy", Lane::intake, [] { spinIntake("deploy", -200, 1000); });
+		auto nudge = graph.add("nudge", Lane::drive, [] {
+			chassis->setMaxVelocity(150);
+			chain.moveDistance(0.04_m);
+			chain.moveDistance(-0.0325_m);
+		}, {A::after(deploy, 200_ms)});
+		auto consume = graph.add("consume", Lane::intake, [] { spinIntake("consume", 200, 2150); }, {A::after(nudge)});
+		auto first = graph.add("first row", Lane::drive, [] {
+			chassis->setMaxVelocity(150);
+			chain.moveDistance(1.15_m);
+			chassis->setMaxVelocity(50);
+			chain.turnAngle((sideSelector)*-90_deg);
+		}, {A::afterStart(consume, 100_ms)});
+		auto consumeMore = graph.add("consume more", Lane::intake, [] { spinIntake("consume more", 200, 1800); }, {A::after(first, 200_ms)});
+		graph.add("consume nested", Lane::intake, [] { spinIntake("consume nested", 200, 400); }, {A::after(consumeMore, 100_ms)});
+		auto second = graph.add("second row", Lane::drive, [] {
+			chassis->setMaxVelocity(125);
+			chain.moveDistance(1.3_m);
+			chassis->setMaxVelocity(200);
+			chain.moveDistance(-1.07_m);
+			chassis->setMaxVelocity(50);
+			chain.turnAngle((sideSelector)*-135_deg);
+		}, {A::after(first, 100_ms)});
+		graph.add("outsome", Lane::intake, [] { spinIntake("outsome", -3000, 500); }, {A::after(second, 700_ms)});
+		auto corner = graph.add("to corner", Lane::drive, [] {
+			chassis->setMaxVelocity(135);
+			chain.moveDistance(0.50_m);
+		}, {A::after(second)});
+		addStack(graph, {A::after(corner, 2000_ms)});
+	}
+	else if(mode == 1)
+	{
+		auto deploy = graph.add("deploy", Lane::intake, [] { spinIntake("deploy", -200, 900); });
+		auto first = graph.add("first row", Lane::drive, [] {
+			chassis->setMaxVelocity(120);
+			chain.moveDistance(1.07_m);
+			chassis->setMaxVelocity(50);
+			chain.turnAngle((sideSelector)*40_deg);
+		}, {A::after(deploy, 200_ms)});
+		graph.add("tray adjust", Lane::tray, [] { trayAdjust(nullptr); }, {A::after(first)});
+		auto second = graph.add("second row", Lane::drive, [] {
+			chassis->setMaxVelocity(180);
+			chain.moveDistance(-0.92_m);
+			chassis->setMaxVelocity(100);
+			chain.turnAngle((sideSelector)*-40_deg);
+			chassis->setMaxVelocity(175);
+			chain.moveDistance(1.07_m);
+			chassis->setMaxVelocity(100);
+			chain.turnAngle((sideSelector)*135_deg);
+		}, {A::after(first)});
+		graph.add("consume", Lane::intake, [&graph, second] {
+			spinIntake("consume", 200, 9000, [&graph, second] { return graph.isFinished(second); });
+		}, {A::after(deploy, 100_ms)});
+		addStack(graph, {A::after(second)});
+		graph.add("outsome", Lane::intake, [] { spinIntake("outsome", -50, 700); }, {A::after(second, 500_ms)});
+		graph.add("to zone", Lane::drive, [] {
+			chassis->setMaxVelocity(150);
+			chain.moveDistance(1.0_m);
+		}, {A::after(second)});
+	}
+	else if(mode == 2)
+	{
+		auto deploy = graph.add("deploy", Lane::intake, [] { spinIntake("deploy", -200, 1000); });
+		auto row = graph.add("row", Lane::drive, [] {
+			chassis->setMaxVelocity(175);
+			chain.moveDistance(1.10_m);
+		}, {A::after(deploy, 200_ms)});
+		auto corner = graph.add("to corner", Lane::drive, [] {
+			chain.moveDistance(-0.15_m);
+			chassis->setMaxVelocity(50);
+			chain.turnAngle((sideSelector)*-137_deg);//Measured is 135°
+			chassis->setMaxVelocity(150);
+			chain.moveDistance(1.1_m);
+		}, {A::after(row, 500_ms)});
+		graph.add("insome", Lane::intake, [&graph, corner] {
+			spinIntake("insome", 200, 10000, [&graph, corner] { return graph.isFinished(corner); });
+		}, {A::after(deploy, 200_ms)});
+		graph.add("outsome", Lane::intake, [] { spinIntake("outsome", -60, 800); }, {A::after(corner)});
+		addStack(graph, {A::after(corner)});
+	}
+	else if(mode == 3)
+	{
+		graph.add("turn", Lane::drive, [] { chain.turnToAngle(45_deg); });
+	}
+	else if(mode == 4)
+	{
+		auto start = graph.add("0.20 m", Lane::drive, [] { moveDistanceSmooth("/usd/0.20m.txt"); });
+		auto deploy = graph.add("deploy", Lane::intake, [] { spinIntake("deploy", -200, 900); }, {A::after(start)});
+		auto approach = graph.add("0.15 m", Lane::drive, [] { moveDistanceSmooth("/usd/0.15m.txt"); }, {A::after(deploy, 110_ms)});
+		graph.add("arm down", Lane::arm, [] { lowerArm(-600); }, {A::after(approach)});
+		graph.add("arm up", Lane::arm, [] { raiseArm(550); }, {A::after(approach, 1160_ms)});
+		auto tower = graph.add("0.36 m", Lane::drive, [] { moveDistanceSmooth("/usd/0.36m.txt"); }, {A::after(approach, 10_ms)});
+		graph.add("arm down again", Lane::arm, [] { lowerArm(-600); }, {A::after(tower, 900_ms)});
+		auto row = graph.add("row", Lane::drive, [] {
+			moveDistanceSmooth("/usd/0.22m.txt");
+			profile->setTarget(sidePath("S"), true);
+			profile->waitUntilSettled();
+			autonTimeline.delay(10);
+			moveDistanceSmooth("/usd/GaussCurve1.31m.txt");
+			autonTimeline.delay(10);
+			moveDistanceSmooth("/usd/GaussCurve0.80m.txt");
+		}, {A::after(tower, 310_ms)});
+		graph.add("consume", Lane::intake, [&graph, row] {
+			spinIntake("consume", 200, 12000, [&graph, row] { return graph.isFinished(row); });
+		}, {A::after(approach)});
+		graph.add("outsome", Lane::intake, [] { spinIntake("outsome", -75, 500); }, {A::after(row, 500_ms)});
+		auto turn = graph.add("turn to zone", Lane::drive, [] {
+			chassis->setMaxVelocity(50);
+			chain.turnAngle((sideSelector)*125_deg);
+		}, {A::after(row)});
+		addStack(graph, {A::after(turn)});
+		graph.add("0.45 m", Lane::drive, [] { moveDistanceSmooth("/usd/0.45m.txt"); }, {A::after(turn, 10_ms)});
+	}
+	else if(mode == 5)
+	{
+		auto deploy = graph.add("deploy", Lane::intake, [] { spinIntake("deploy", -200, 700); });
+		auto row = graph.add("row", Lane::drive, [] {
+			chassis->setMaxVelocity(100);
+			chain.moveDistance(2.8_m);
+			chassis->setMaxVelocity(75);
+			chain.turnAngle((sideSelector)*45_deg);
+			chassis->setMaxVelocity(125);
+			chain.moveDistance(0.5_m);
+		}, {A::after(deploy, 200_ms)});
+		graph.add("consume", Lane::intake, [&graph, row] {
+			spinIntake("consume", 200, 6000, [&graph, row] { return graph.isFinished(row); });
+		}, {A::after(deploy, 100_ms)});
+		graph.add("insome", Lane::intake, [] { spinIntake("insome", 50, 200); }, {A::after(row)});
+		graph.add("tray stack", Lane::tray, [] { trayTaskOP(nullptr); }, {A::after(row, 250_ms)});
+	}
+	else if(mode == 6)
+	{
+		auto start = graph.add("0.18 m", Lane::drive, [] { moveDistanceSmooth("/usd/0.18m.txt"); });
+		auto deploy = graph.add("deploy", Lane::intake, [] { spinIntake("deploy", -200, 900); }, {A::after(start)});
+		auto approach = graph.add("0.13 m", Lane::drive, [] { moveDistanceSmooth("/usd/0.13m.txt"); }, {A::after(deploy, 110_ms)});
+		graph.add("arm down", Lane::arm, [] { lowerArm(-600); }, {A::after(approach)});
+		auto row = graph.add("row", Lane::drive, [] {
+			moveDistanceSmooth("/usd/0.70m.txt");
+			autonTimeline.delay(10);
+			moveDistanceSmooth("/usd/neg0.15m.txt");
+			chassis->setMaxVelocity(100);
+			chain.turnToAngle((sideSelector)*-35_deg);
+			chassis->setMaxVelocity(200);
+			autonTimeline.delay(10);
+			moveDistanceSmooth("/usd/0.17m.txt");
+			autonTimeline.delay(10);
+			moveDistanceSmooth("/usd/neg0.17m.txt");
+			autonTimeline.delay(20);
+			chassis->setMaxVelocity(100);
+			chain.turnToAngle((sideSelector)*35_deg);
+			chassis->setMaxVelocity(200);
+			autonTimeline.delay(10);
+			moveDistanceSmooth("/usd/0.46m.txt");
+		}, {A::after(approach, 10_ms)});
+		graph.add("consume", Lane::intake, [&graph, row] {
+			spinIntake("consume", 200, 5500, [&graph, row] { return graph.isFinished(row); });
+		}, {A::after(approach)});
+		graph.add("outsome", Lane::intake, [] { spinIntake("outsome", -75, 500); }, {A::after(row, 500_ms)});
+		auto zone = graph.add("to zone", Lane::drive, [] {
+			chassis->setMaxVelocity(100);
+			chain.turnToAngle((sideSelector)*125_deg);
+			moveDistanceSmooth("/usd/0.24m.txt");
+		}, {A::after(row)});
+		addStack(graph, {A::after(zone)});
+	}
+}
+
+//Stackless versions of the autonomous helpers for the script scheduler: each waits where its task would block, so they all share autonomous()'s task
+
+//Runs the intakes at speed for timeMs after delayMs
+ScriptScheduler::Body intakeScript(const char* name, int delayMs, int speed, int timeMs) {
+	return [=, span = AutonTimeline::none](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		SCRIPT_DELAY(s, delayMs);
+		span = autonTimeline.begin(AutonTimeline::Lane::intake, name);
+		intake1.move_velocity(speed);
+		intake2.move_velocity(speed);
+		SCRIPT_DELAY(s, timeMs);
+		intake1.move_velocity(0);
+		intake2.move_velocity(0);
+		autonTimeline.end(span);
+		SCRIPT_END(s);
+	};
+}
+
+//Drops the arm by up to -dist degrees, or until it reaches the lower limit switch, as lowerArm does
+ScriptScheduler::Body armFallScript(int dist) {
+	return [=, armPos = 0.0, span = AutonTimeline::none](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		span = autonTimeline.begin(AutonTimeline::Lane::arm, "arm fall");
+		arm.set_zero_position(arm.get_position());
+		armPos = arm.get_position();
+		arm.move_velocity(-150);
+		SCRIPT_AWAIT(s, arm.get_position() <= armPos + dist || arm_lower.get_value() == 1);
+		arm.move_velocity(0);
+		autonTimeline.end(span);
+		SCRIPT_END(s);
+	};
+}
+
+//Drives at rpm for moveTime, as forwardTask and backwardTask do
+ScriptScheduler::Body driveScript(const char* name, int rpm) {
+	return [=, span = AutonTimeline::none](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		span = autonTimeline.begin(AutonTimeline::Lane::drive, name);
+		left_motor1.move_velocity(rpm);
+		left_motor2.move_velocity(rpm);
+		right_motor1.move_velocity(rpm);
+		right_motor2.move_velocity(rpm);
+		SCRIPT_DELAY(s, moveTime);
+		left_motor1.move_velocity(0);
+		left_motor2.move_velocity(0);
+		right_motor1.move_velocity(0);
+		right_motor2.move_velocity(0);
+		autonTimeline.end(span);
+		SCRIPT_END(s);
+	};
+}
+
+//Follows a curve from generateCurve a line per tick, as moveDistanceSmooth does
+ScriptScheduler::Body curveScript(const char* path) {
+	return [=, input = (FILE*)nullptr, span = AutonTimeline::none](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		input = fopen(path, "r");
+		if(!input) {
+			return true;
+		}
+		span = autonTimeline.begin(AutonTimeline::Lane::drive, path);
+		{
+			char read[64] = "";
+			fgets(read, sizeof(read), input);
+			fgets(read, sizeof(read), input);
+		}
+		//Each line is 10 ms of the curve, the scheduler's tick
+		while(true) {
+			{
+				char read[64] = "";
+				if(!fgets(read, sizeof(read), input)) {
+					break;
+				}
+				std::string_view fields = trimText(read);
+				double speed = 0;
+				parseNumber(nextField(fields), speed);
+				left_motor1.move(speed);
+				left_motor2.move(speed);
+				right_motor1.move(speed);
+				right_motor2.move(speed);
+			}
+			SCRIPT_YIELD(s);
+		}
+		fclose(input);
+		left_motor1.move(0);
+		left_motor2.move(0);
+		right_motor1.move(0);
+		right_motor2.move(0);
+		autonTimeline.end(span);
+		SCRIPT_END(s);
+	};
+}
+
+//Turns to an odometry heading at maxVelocity rpm, as chain.turnToAngle does without predictive settling
+ScriptScheduler::Body turnScript(QAngle heading, double maxVelocity) {
+	return [=, span = AutonTimeline::none](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		span = autonTimeline.begin(AutonTimeline::Lane::drive, "turnToAngle");
+		chassis->setMaxVelocity(maxVelocity);
+		chassis->turnAngleAsync(std::remainder((heading - chassis->getState().theta).convert(degree), 360.0) * degree);
+		SCRIPT_AWAIT(s, chassis->isSettled());
+		//isSettled doesn't end the turn; stop does, or the PID task keeps holding the heading
+		chassis->stop();
+		chassis->setMaxVelocity(200);
+		autonTimeline.end(span);
+		SCRIPT_END(s);
+	};
+}
+
+//Raises the tray to stack, then outtakes and backs away, as trayTask does
+ScriptScheduler::Body stackScript() {
+	return [span = AutonTimeline::none](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		span = autonTimeline.begin(AutonTimeline::Lane::tray, "tray stack");
+		if(trayMechanism.getCalibration().isCalibrated()) {
+			trayMechanism.setTarget(2260);
+			SCRIPT_AWAIT(s, trayMechanism.isSettled());
+		}
+		else {
+			tray.move_velocity(200);
+			SCRIPT_AWAIT(s, angler.get_value() >= 1850);
+			tray.move_velocity(125);
+			SCRIPT_AWAIT(s, angler.get_value() >= 2260);
+			tray.move_velocity(0);
+		}
+		autonTimeline.end(span);
+		autonScripts.spawn("release", intakeScript("outtake", 0, -125, 750));
+		SCRIPT_DELAY(s, 125);
+		autonScripts.spawn("back away", driveScript("backward", -75));
+		SCRIPT_END(s);
+	};
+}
+
+/**
+ * Autonomous mode 6 as scripts on autonomous()'s own task. The straight-line version starts seven
+ * tasks with 32 KiB stacks each for its mechanisms; these are a few hundred bytes apiece.
+ */
+void spawnMode6Scripts(ScriptScheduler &scripts) {
+	scripts.spawn("mode 6", [&scripts, child = ScriptScheduler::ScriptId(0)](ScriptScheduler::Script &s) mutable {
+		SCRIPT_BEGIN(s);
+		pros::lcd::set_text(2, "Auton Version 4 (scripts)");
+		SCRIPT_DELAY(s, 10);
+		child = scripts.spawn("0.18m", curveScript("/usd/0.18m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		scripts.spawn("deploy", intakeScript("outtake", 0, -200, 900));
+		SCRIPT_DELAY(s, 1010);
+		child = scripts.spawn("0.13m", curveScript("/usd/0.13m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		scripts.spawn("arm fall", armFallScript(-600));
+		scripts.spawn("consume", intakeScript("intake", 0, 200, 5500));
+		SCRIPT_DELAY(s, 10);
+		child = scripts.spawn("0.70m", curveScript("/usd/0.70m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		SCRIPT_DELAY(s, 10);
+		child = scripts.spawn("-0.15m", curveScript("/usd/neg0.15m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		child = scripts.spawn("turn -35", turnScript((sideSelector)*-35_deg, 100));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		SCRIPT_DELAY(s, 10);
+		child = scripts.spawn("0.17m", curveScript("/usd/0.17m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		SCRIPT_DELAY(s, 10);
+		child = scripts.spawn("-0.17m", curveScript("/usd/neg0.17m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		SCRIPT_DELAY(s, 20);
+		child = scripts.spawn("turn 35", turnScript((sideSelector)*35_deg, 100));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		SCRIPT_DELAY(s, 10);
+		child = scripts.spawn("0.46m", curveScript("/usd/0.46m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		scripts.spawn("outsome", intakeScript("outtake", 500, -75, 500));
+		child = scripts.spawn("turn 125", turnScript((sideSelector)*125_deg, 100));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		child = scripts.spawn("0.24m", curveScript("/usd/0.24m.txt"));
+		SCRIPT_AWAIT(s, scripts.isFinished(child));
+		scripts.spawn("stack", stackScript());
+		SCRIPT_END(s);
+	});
+}
+
 void autonomous() {
 	pros::lcd::set_text(1, "Auton!");
 	std::cout << "auto";
@@ -546,40 +1098,57 @@ void autonomous() {
 	arm.set_brake_mode(MOTOR_BRAKE_HOLD);
 	tray.set_brake_mode(MOTOR_BRAKE_HOLD);
 	tray.set_zero_position(tray.get_position());
-	if(autonMode == 0)
+	autonTimeline.start();
+	chain.clearReport();
+	if(recordSensors)
+		sensorRecorder.start();
+	if(useAutonGraph && autonMode <= 6)
+	{
+		buildAutonGraph(autonGraph, autonMode);
+		autonGraph.run();
+		autonGraph.printReport();
+	}
+	else if(useAutonScripts && autonMode == 6)
+	{
+		autonScripts.clear();
+		spawnMode6Scripts(autonScripts);
+		autonScripts.run();
+		autonScripts.printReport();
+	}
+	else if(autonMode == 0)
 	{
 		int path0 = 0;
 		//L path: moves forward, turns 90°, moves forward again then back, turns 135° and goes to corner
 		runTime = 1000;
 		pros::Task deploy (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Deploy");
-		pros::delay(1200);
+		autonTimeline.delay(1200);
 		chassis->setMaxVelocity(150);
-		chassis->moveDistance(0.04_m);
-		chassis->moveDistance(-0.0325_m);
+		chain.moveDistance(0.04_m);
+		chain.moveDistance(-0.0325_m);
 		runTime = 2150;
 		pros::Task consume (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Consume");
-		pros::delay(100);
+		autonTimeline.delay(100);
 		chassis->setMaxVelocity(150);
-		chassis->moveDistance(1.15_m);
+		chain.moveDistance(1.15_m);
 		chassis->setMaxVelocity(50);
-		chassis->turnAngle((sideSelector)*-90_deg);
+		chain.turnAngle((sideSelector)*-90_deg);
 		runTime = 1800;
 		runDelay = 200;
 		pros::Task consumeMore (nestedIntake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Consume More");
-		pros::c::delay(100);
+		autonTimeline.delay(100);
 		chassis->setMaxVelocity(125);
-		chassis->moveDistance(1.3_m);
+		chain.moveDistance(1.3_m);
 		chassis->setMaxVelocity(200);
-		chassis->moveDistance(-1.07_m);
+		chain.moveDistance(-1.07_m);
 		chassis->setMaxVelocity(50);
-		chassis->turnAngle((sideSelector)*-135_deg);
+		chain.turnAngle((sideSelector)*-135_deg);
 		runDelay = 700;
 		runTime = 500;
 		runSpeed = 3000;
 		pros::Task outsome (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outsome");
 		chassis->setMaxVelocity(135);
-		chassis->moveDistance(0.50_m);
-		pros::c::delay(2000);
+		chain.moveDistance(0.50_m);
+		autonTimeline.delay(2000);
 		pros::Task traySome (trayTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "trayTask");
 		//Tray stack 3/4 rotation velocity 60 time 750ms
 	}
@@ -589,49 +1158,49 @@ void autonomous() {
 		//Z path: Moves forward, moves diagonally, moves forward again, returns to corner
 		runTime = 900;
 		pros::Task deploy (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Deploy");
-		pros::delay(1000);
+		autonTimeline.delay(1000);
 		runTime = 9000;
 		pros::Task consume (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Consume");
-		pros::delay(100);
+		autonTimeline.delay(100);
 		chassis->setMaxVelocity(120);
-		chassis->moveDistance(1.07_m);
+		chain.moveDistance(1.07_m);
 		chassis->setMaxVelocity(50);
-		chassis->turnAngle((sideSelector)*40_deg);
+		chain.turnAngle((sideSelector)*40_deg);
 		chassis->setMaxVelocity(120);
 		tray.set_zero_position(tray.get_position());
 		pros::Task trayAdj (trayAdjust, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "trayTask");
 		chassis->setMaxVelocity(180);
-		chassis->moveDistance(-0.92_m);
+		chain.moveDistance(-0.92_m);
 		chassis->setMaxVelocity(100);
-		chassis->turnAngle((sideSelector)*-40_deg);
+		chain.turnAngle((sideSelector)*-40_deg);
 		chassis->setMaxVelocity(175);
-		chassis->moveDistance(1.07_m);
+		chain.moveDistance(1.07_m);
 		chassis->setMaxVelocity(100);
-		chassis->turnAngle((sideSelector)*135_deg);
+		chain.turnAngle((sideSelector)*135_deg);
 		pros::Task traySome (trayTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "trayTask");
 		runDelay = 500;
 		runTime = 700;
 		runSpeed = 50;
 		pros::Task outsome (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outsome");
 		chassis->setMaxVelocity(150);
-		chassis->moveDistance(1.0_m);
+		chain.moveDistance(1.0_m);
 	}
 	else if(autonMode == 2)
 	{
 		int path2 = 0;
 		runTime = 1000;
 		pros::Task deploy (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outsome");
-		pros::delay(1200);
+		autonTimeline.delay(1200);
 		runTime = 10000;
 		pros::Task insome (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Insome");
 		chassis->setMaxVelocity(175);
-		chassis->moveDistance(1.10_m);
-		pros::delay(500);
-		chassis->moveDistance(-0.15_m);
+		chain.moveDistance(1.10_m);
+		autonTimeline.delay(500);
+		chain.moveDistance(-0.15_m);
 		chassis->setMaxVelocity(50);
-		chassis->turnAngle((sideSelector)*-137_deg);//Measured is 135°
+		chain.turnAngle((sideSelector)*-137_deg);//Measured is 135°
 		chassis->setMaxVelocity(150);
-		chassis->moveDistance(1.1_m);
+		chain.moveDistance(1.1_m);
 		runDelay = 0;
 		runTime = 800;
 		runSpeed = 60;
@@ -648,7 +1217,8 @@ void autonomous() {
 		//moveDistanceSmooth("/usd/GaussCurve1m.txt");
 		pros::lcd::set_text(3,std::to_string(left_encoder.get()));
 		pros::lcd::set_text(4,std::to_string(right_encoder.get()));
-		chassis->turnToAngle(45_deg);
+		//calibrateTray();
+		chain.turnToAngle(45_deg);
 		//chassis->moveDistance(1.0_m);
 		//profile->generatePath({{0_m, 0_m, 0_deg},{1.00_m, 0_m, 0_deg}},"A");
 		//profile->setTarget("S");
@@ -668,47 +1238,50 @@ void autonomous() {
 		int path4 = 0;
 		pros::lcd::set_text(2, "Auton Version 4");
 		//Z path: Moves forward, moves diagonally, moves forward again, returns to corner
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.20m.txt");
 		runTime = 900;
 		pros::Task deploy (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Deploy");
-		pros::delay(1000);
-		pros::delay(10);
+		autonTimeline.delay(1000);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.15m.txt");
 		armDist = -600;
 		armDelay = 0;
 		pros::Task arm0 (armFall, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Move");
 		runTime = 12000;
 		pros::Task consume (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Consume");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		armDist = 550;
 		armDelay = 1150;
 		pros::Task arm (armTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Move");
 		moveDistanceSmooth("/usd/0.36m.txt");
-		pros::delay(300);
+		autonTimeline.delay(300);
 		armDist = -600;
 		armDelay = 600;
 		pros::Task arm2 (armFall, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Move");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.22m.txt");
-		profile->setTarget("S", true);
-		profile->waitUntilSettled();
+		{
+			AutonTimeline::Scope scope(autonTimeline, AutonTimeline::Lane::drive, "profile S");
+			profile->setTarget(sidePath("S"), true);
+			profile->waitUntilSettled();
+		}
 		//chassis->setMaxVelocity(135);
 		//chassis->moveDistance(1.31_m);
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/GaussCurve1.31m.txt");
 		//chassis->setMaxVelocity(200);
 		//chassis->moveDistance(-0.80_m);
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/GaussCurve0.80m.txt");
 		runDelay = 500;
 		runTime = 500;
 		runSpeed = 75;
 		pros::Task outsome (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outsome");
 		chassis->setMaxVelocity(50);
-		chassis->turnAngle((sideSelector)*125_deg);
+		chain.turnAngle((sideSelector)*125_deg);
 		pros::Task traySome (trayTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "trayTask");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.45m.txt");
 		//chassis->setMaxVelocity(90);
 		//chassis->moveDistance(0.45_m);
@@ -717,24 +1290,24 @@ void autonomous() {
 		int path5 = 0;
 		runTime = 700;
 		pros::Task deploy (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Deploy");
-		pros::delay(800);
+		autonTimeline.delay(800);
 		runTime = 6000;
 		pros::Task consume (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Consume");
-		pros::delay(100);
+		autonTimeline.delay(100);
 		chassis->setMaxVelocity(100);
-		chassis->moveDistance(2.8_m);
+		chain.moveDistance(2.8_m);
 		chassis->setMaxVelocity(75);
-		chassis->turnAngle((sideSelector)*45_deg);
+		chain.turnAngle((sideSelector)*45_deg);
 		chassis->setMaxVelocity(125);
-		chassis->moveDistance(0.5_m);
+		chain.moveDistance(0.5_m);
 		runDelay = 0;
 		runTime = 200;
 		runSpeed = 50;
 		pros::Task insome (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "insome");
-		pros::delay(250);
+		autonTimeline.delay(250);
 		//pros::Task outsome (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outsome");
 		pros::Task traySome (trayTaskOP, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "trayTask");
-		pros::delay(1000);
+		autonTimeline.delay(1000);
 		/*
 		0.356 m back
 		-135
@@ -757,43 +1330,59 @@ void autonomous() {
 	} else if (autonMode == 6) {
 		int path6 = 0;
 		pros::lcd::set_text(2, "Auton Version 4");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.18m.txt");
 		runTime = 900;
 		pros::Task deploy (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Deploy");
-		pros::delay(1000);
-		pros::delay(10);
+		autonTimeline.delay(1000);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.13m.txt");
 		armDist = -600;
 		armDelay = 0;
 		pros::Task arm0 (armFall, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Move");
 		runTime = 5500;
 		pros::Task consume (intake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Consume");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.70m.txt");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/neg0.15m.txt");
 		chassis->setMaxVelocity(100);
-		chassis->turnToAngle((sideSelector)*-35_deg);
+		chain.turnToAngle((sideSelector)*-35_deg);
 		chassis->setMaxVelocity(200);
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.17m.txt");
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/neg0.17m.txt");
-		pros::delay(20);
+		autonTimeline.delay(20);
 		chassis->setMaxVelocity(100);
-		chassis->turnToAngle((sideSelector)*35_deg);
+		chain.turnToAngle((sideSelector)*35_deg);
 		chassis->setMaxVelocity(200);
-		pros::delay(10);
+		autonTimeline.delay(10);
 		moveDistanceSmooth("/usd/0.46m.txt");
 		runDelay = 500;
 		runTime = 500;
 		runSpeed = 75;
 		pros::Task outsome (outtake, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Some");
 		chassis->setMaxVelocity(100);
-		chassis->turnToAngle((sideSelector)*125_deg);
+		chain.turnToAngle((sideSelector)*125_deg);
 		moveDistanceSmooth("/usd/0.24m.txt");
 		pros::Task traySome (trayTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "trayTask");
+	} else if (autonMode == 7) {
+		pros::lcd::set_text(2, "Characterizing");
+		left_motor1.set_brake_mode(MOTOR_BRAKE_COAST);
+		left_motor2.set_brake_mode(MOTOR_BRAKE_COAST);
+		right_motor1.set_brake_mode(MOTOR_BRAKE_COAST);
+		right_motor2.set_brake_mode(MOTOR_BRAKE_COAST);
+		DriveCharacterizer characterizer(TimeUtilFactory::createDefault(), chassis->getModel(), chassis->getChassisScales());
+		characterizer.runAll();
+		pros::lcd::set_text(2, characterizer.save("/usd/characterization.csv") ? "Saved characterization" : "SD write failed");
+	}
+	chain.printReport();
+	LoopRate::printAll();
+	AllocationCounter::printAll();
+	if(recordSensors) {
+		sensorRecorder.stop();
+		sensorRecorder.save("/usd/sensors.csv");
 	}
 }
 
@@ -821,145 +1410,185 @@ void opcontrol() {
 	tray.set_encoder_units(MOTOR_ENCODER_DEGREES);
 	tray.set_zero_position(tray.get_position());
 	arm.set_zero_position(arm.get_position());
+	//A graph run that timed out would otherwise keep starting steps under the driver
+	autonGraph.cancel();
 	//FILE* fileWrite = fopen("/usd/test.txt", "w");
+	//Driver control holds 100 Hz; line 7 shows its jitter and overruns twice a second
+	LoopRate rate("driver");
+	char rateLine[48];
+	driveShaper.reset();
 	if(toggleControl)
 	{
 		while (true) {
-			//pros::lcd::set_text(1,std::to_string(arm.get_position()));
-			//pros::lcd::set_text(1,std::to_string(chassis->getModel()->getSensorVals()[1]));
-			pros::lcd::set_text(2,std::to_string(angler.get_value()));
-			pros::lcd::set_text(3,std::to_string(left_encoder.get()));
-			pros::lcd::set_text(4,std::to_string(right_encoder.get()));
-			left_motor1.move(master.get_analog(ANALOG_LEFT_Y));
-			left_motor2.move(master.get_analog(ANALOG_LEFT_Y));
-			right_motor1.move(master.get_analog(ANALOG_RIGHT_Y));
-			right_motor2.move(master.get_analog(ANALOG_RIGHT_Y));
-			if (master.get_digital(DIGITAL_R1) && arm_upper.get_value() != 1) {
-				arm.move_velocity(200);
-			}
-			else if (master.get_digital(DIGITAL_R2) && arm_lower.get_value() != 1) {
-				arm.move_velocity(-200);
-			}
-			else {
-				arm.move_velocity(0);
-			}
-			if (master.get_digital(DIGITAL_L1)) {
-				intake1.move_velocity(200);//Max rpm
-				intake2.move_velocity(200);
-			}
-			else if (master.get_digital(DIGITAL_L2)) {
-				intake1.move_velocity(-150);//outtake
-				intake2.move_velocity(-150);
-			}
-			else {
-				intake1.move_velocity(0);
-				intake2.move_velocity(0);
-			}
-			if(master.get_digital(DIGITAL_B) && angler.get_value() > 1190) {
-				tray.move_velocity(-200);
-			}
-			else if (master.get_digital(DIGITAL_X) && angler.get_value() < 2500) {
-				tray.move_velocity(200);
-			}
-			else if (master.get_digital(DIGITAL_A) && angler.get_value() < 2500) {
-				tray.move_velocity(50);
-			}
-			else {
-				tray.move_velocity(0);
-			}
-			if(master.get_digital(DIGITAL_Y)) {
-				intake1.move_velocity(-200);
-				intake2.move_velocity(-200);
-			}
-			if(master.get_digital(DIGITAL_DOWN))
-			{
-				pros::Task outtake (outtakeTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outtake");
-				pros::delay(250);
-				pros::Task backward (backwardTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Backward");
-			}
-			if(master.get_digital(DIGITAL_UP))
-			{
-				pros::Task trayMove (trayTaskOP, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Tray Move");
-			}
-			if(master.get_digital(DIGITAL_LEFT))
 			{
-				pros::Task armMove (armTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Arm Move");
+				TRACE_SCOPE("driver");
+				//pros::lcd::set_text(1,std::to_string(arm.get_position()));
+				//pros::lcd::set_text(1,std::to_string(chassis->getModel()->getSensorVals()[1]));
+				{
+					TRACE_SCOPE("lcd");
+					pros::c::lcd_set_text(2, FixedString<24>("%ld", static_cast<long>(angler.get_value())).c_str());
+					pros::c::lcd_set_text(3, FixedString<24>("%f", left_encoder.get()).c_str());
+					pros::c::lcd_set_text(4, FixedString<24>("%f", right_encoder.get()).c_str());
+				}
+				DriveInputShaper::Power power = driveShaper.tank(master.get_analog(ANALOG_LEFT_Y), master.get_analog(ANALOG_RIGHT_Y),
+					(left_motor1.get_current_draw() + left_motor2.get_current_draw()) / 2, (right_motor1.get_current_draw() + right_motor2.get_current_draw()) / 2);
+				if(!isClaimed(AutonTimeline::Lane::drive)) {
+					left_motor1.move(power.left);
+					left_motor2.move(power.left);
+					right_motor1.move(power.right);
+					right_motor2.move(power.right);
+				}
+				if (master.get_digital(DIGITAL_R1) && arm_upper.get_value() != 1) {
+					arm.move_velocity(200);
+				}
+				else if (master.get_digital(DIGITAL_R2) && arm_lower.get_value() != 1) {
+					arm.move_velocity(-200);
+				}
+				//Holding still is left to a helper or profiled move while one runs, so the two don't fight
+				else if(!isClaimed(AutonTimeline::Lane::arm) && armMechanism.isSettled()) {
+					arm.move_velocity(0);
+				}
+				if (master.get_digital(DIGITAL_L1)) {
+					intake1.move_velocity(200);//Max rpm
+					intake2.move_velocity(200);
+				}
+				else if (master.get_digital(DIGITAL_L2)) {
+					intake1.move_velocity(-150);//outtake
+					intake2.move_velocity(-150);
+				}
+				else if(!isClaimed(AutonTimeline::Lane::intake)) {
+					intake1.move_velocity(0);
+					intake2.move_velocity(0);
+				}
+				if(master.get_digital(DIGITAL_B) && angler.get_value() > 1190) {
+					tray.move_velocity(-200);
+				}
+				else if (master.get_digital(DIGITAL_X) && angler.get_value() < 2500) {
+					tray.move_velocity(200);
+				}
+				else if (master.get_digital(DIGITAL_A) && angler.get_value() < 2500) {
+					tray.move_velocity(50);
+				}
+				//Holding still is left to a helper or profiled move while one runs, so the two don't fight
+				else if(!isClaimed(AutonTimeline::Lane::tray) && trayMechanism.isSettled()) {
+					tray.move_velocity(0);
+				}
+				if(master.get_digital(DIGITAL_Y)) {
+					intake1.move_velocity(-200);
+					intake2.move_velocity(-200);
+				}
+				if(master.get_digital(DIGITAL_DOWN))
+				{
+					pros::Task outtake (outtakeTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outtake");
+					pros::delay(250);
+					pros::Task backward (backwardTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Backward");
+				}
+				//Once per press; holding the button would otherwise start a move every tick
+				if(master.get_digital_new_press(DIGITAL_UP))
+				{
+					pros::Task trayMove (trayTaskOP, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Tray Move");
+				}
+				//Once per press; holding the button would otherwise start a move every tick
+				if(master.get_digital_new_press(DIGITAL_LEFT))
+				{
+					pros::Task armMove (armTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Arm Move");
+				}
+				//pros::lcd::set_text(1, std::to_string(time));
+				//double leftVelocity = (left_motor1.get_actual_velocity() + left_motor2.get_actual_velocity())/2;
+				//double rightVelocity = (right_motor1.get_actual_velocity() + right_motor2.get_actual_velocity())/2;
+				//double linearVelocity = (leftVelocity+rightVelocity)/2;
+				//std::string output = std::to_string(leftVelocity) + " " + std::to_string(rightVelocity) + " " + std::to_string(linearVelocity);
+				//fputs(output.c_str(), fileWrite);
+				if(rate.getCount() % 50 == 0) {
+					rate.format(rateLine, sizeof(rateLine));
+					TRACE_SCOPE("lcd");
+					pros::c::lcd_set_text(7, rateLine);
+				}
 			}
-			//pros::lcd::set_text(1, std::to_string(time));
-			//double leftVelocity = (left_motor1.get_actual_velocity() + left_motor2.get_actual_velocity())/2;
-			//double rightVelocity = (right_motor1.get_actual_velocity() + right_motor2.get_actual_velocity())/2;
-			//double linearVelocity = (leftVelocity+rightVelocity)/2;
-			//std::string output = std::to_string(leftVelocity) + " " + std::to_string(rightVelocity) + " " + std::to_string(linearVelocity);
-			//fputs(output.c_str(), fileWrite);
-			pros::delay(10);
+			rate.delayUntilNext();
 		}
 	}
 	else {
 		while (true) {
-			pros::lcd::set_text(1,std::to_string(arm.get_position()));
-			std::cout << master.get_analog(ANALOG_LEFT_Y);
-			int power = master.get_analog(ANALOG_LEFT_Y);
-			int turn = master.get_analog(ANALOG_RIGHT_X);
-			int left = power + turn;
-			int right = power - turn;
-			left_motor1.move(left);
-			left_motor2.move(left);
-			right_motor1.move(right);
-			right_motor2.move(right);
-			if (master.get_digital(DIGITAL_R1) && arm_upper.get_value() != 1) {
-				arm.move_velocity(200);
-			}
-			else if (master.get_digital(DIGITAL_R2) && arm_lower.get_value() != 1) {
-				arm.move_velocity(-100);
-			}
-			else {
-				arm.move_velocity(0);
-			}
-			if (master.get_digital(DIGITAL_L1)) {
-				intake1.move_velocity(200);//Max rpm
-				intake2.move_velocity(200);
-			}
-			else if (master.get_digital(DIGITAL_L2)) {
-				intake1.move_velocity(-150);//outtake
-				intake2.move_velocity(-150);
-			}
-			else {
-				intake1.move_velocity(0);
-				intake2.move_velocity(0);
-			}
-			if(master.get_digital(DIGITAL_B) && button.get_value() != 1) {
-				tray.move_velocity(-200);
-			}
-			else if (master.get_digital(DIGITAL_X) && angler.get_value() < 2500) {
-				tray.move_velocity(200);
-			}
-			else if (master.get_digital(DIGITAL_A) && angler.get_value() < 2500) {
-				tray.move_velocity(50);
-			}
-			else {
-				tray.move_velocity(0);
-			}
-			if(master.get_digital(DIGITAL_DOWN))
-			{
-				pros::Task outtake (outtakeTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outtake");
-				pros::delay(250);
-				pros::Task backward (backwardTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Backward");
-			}
-			if(master.get_digital(DIGITAL_UP))
-			{
-				pros::Task trayMove (trayTaskOP, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Tray Move");
-			}
-			if(master.get_digital(DIGITAL_LEFT))
 			{
-				pros::Task armMove (armTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Arm Move");
+				TRACE_SCOPE("driver");
+				{
+					TRACE_SCOPE("lcd");
+					pros::c::lcd_set_text(1, FixedString<24>("%f", arm.get_position()).c_str());
+				}
+				std::cout << master.get_analog(ANALOG_LEFT_Y);
+				DriveInputShaper::Power power = driveShaper.arcade(master.get_analog(ANALOG_LEFT_Y), master.get_analog(ANALOG_RIGHT_X),
+					(left_motor1.get_current_draw() + left_motor2.get_current_draw()) / 2, (right_motor1.get_current_draw() + right_motor2.get_current_draw()) / 2);
+				if(!isClaimed(AutonTimeline::Lane::drive)) {
+					left_motor1.move(power.left);
+					left_motor2.move(power.left);
+					right_motor1.move(power.right);
+					right_motor2.move(power.right);
+				}
+				if (master.get_digital(DIGITAL_R1) && arm_upper.get_value() != 1) {
+					arm.move_velocity(200);
+				}
+				else if (master.get_digital(DIGITAL_R2) && arm_lower.get_value() != 1) {
+					arm.move_velocity(-100);
+				}
+				//Holding still is left to a helper or profiled move while one runs, so the two don't fight
+				else if(!isClaimed(AutonTimeline::Lane::arm) && armMechanism.isSettled()) {
+					arm.move_velocity(0);
+				}
+				if (master.get_digital(DIGITAL_L1)) {
+					intake1.move_velocity(200);//Max rpm
+					intake2.move_velocity(200);
+				}
+				else if (master.get_digital(DIGITAL_L2)) {
+					intake1.move_velocity(-150);//outtake
+					intake2.move_velocity(-150);
+				}
+				else if(!isClaimed(AutonTimeline::Lane::intake)) {
+					intake1.move_velocity(0);
+					intake2.move_velocity(0);
+				}
+				if(master.get_digital(DIGITAL_B) && button.get_value() != 1) {
+					tray.move_velocity(-200);
+				}
+				else if (master.get_digital(DIGITAL_X) && angler.get_value() < 2500) {
+					tray.move_velocity(200);
+				}
+				else if (master.get_digital(DIGITAL_A) && angler.get_value() < 2500) {
+					tray.move_velocity(50);
+				}
+				//Holding still is left to a helper or profiled move while one runs, so the two don't fight
+				else if(!isClaimed(AutonTimeline::Lane::tray) && trayMechanism.isSettled()) {
+					tray.move_velocity(0);
+				}
+				if(master.get_digital(DIGITAL_DOWN))
+				{
+					pros::Task outtake (outtakeTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Outtake");
+					pros::delay(250);
+					pros::Task backward (backwardTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Backward");
+				}
+				//Once per press; holding the button would otherwise start a move every tick
+				if(master.get_digital_new_press(DIGITAL_UP))
+				{
+					pros::Task trayMove (trayTaskOP, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Tray Move");
+				}
+				//Once per press; holding the button would otherwise start a move every tick
+				if(master.get_digital_new_press(DIGITAL_LEFT))
+				{
+					pros::Task armMove (armTask, (void*)"PROS", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Arm Move");
+				}
+				//pros::lcd::set_text(1, std::to_string(time));
+				//double leftVelocity = (left_motor1.get_actual_velocity() + left_motor2.get_actual_velocity())/2;
+				//double rightVelocity = (right_motor1.get_actual_velocity() + right_motor2.get_actual_velocity())/2;
+				//double linearVelocity = (leftVelocity+rightVelocity)/2;
+				//std::string output = std::to_string(leftVelocity) + " " + std::to_string(rightVelocity) + " " + std::to_string(linearVelocity);
+				//fputs(output.c_str(), fileWrite);
+				if(rate.getCount() % 50 == 0) {
+					rate.format(rateLine, sizeof(rateLine));
+					TRACE_SCOPE("lcd");
+					pros::c::lcd_set_text(7, rateLine);
+				}
 			}
-			//pros::lcd::set_text(1, std::to_string(time));
-			//double leftVelocity = (left_motor1.get_actual_velocity() + left_motor2.get_actual_velocity())/2;
-			//double rightVelocity = (right_motor1.get_actual_velocity() + right_motor2.get_actual_velocity())/2;
-			//double linearVelocity = (leftVelocity+rightVelocity)/2;
-			//std::string output = std::to_string(leftVelocity) + " " + std::to_string(rightVelocity) + " " + std::to_string(linearVelocity);
-			//fputs(output.c_str(), fileWrite);
-			pros::delay(10);
+			rate.delayUntilNext();
 		}
 	}
 }
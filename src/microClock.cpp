@@ -0,0 +1,18 @@
+#include "microClock.hpp"
+
+#ifdef THREADS_STD
+#include <chrono>
+
+std::uint64_t microClock() {
+  static const auto start = std::chrono::steady_clock::now();
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+}
+#else
+extern "C" std::uint64_t vexSystemHighResTimeGet(void);
+
+std::uint64_t microClock() {
+  return vexSystemHighResTimeGet();
+}
+#endif
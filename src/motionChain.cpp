@@ -0,0 +1,196 @@
+#include "motionChain.hpp"
+#include "loopRate.hpp"
+#include <cmath>
+#include <cstdio>
+
+using namespace okapi;
+
+namespace {
+// The most the error may change per 10 ms sample and still settle: 5 cm/s, or 20 deg/s
+constexpr double distanceDerivative = 0.5;
+constexpr double angleDerivative = 0.2;
+
+// Samples the error must hold still for, outside the band, for a motion to count as stalled
+constexpr std::uint32_t stallSamples = 25;
+} // namespace
+
+MotionChain::MotionChain(std::shared_ptr<OdomChassisController> ichassis,
+                         const TimeUtil &itimeUtil,
+                         const QLength idistanceBand,
+                         const QAngle iangleBand,
+                         const QTime iblendTime,
+                         const QTime itimeout)
+  : chassis(std::move(ichassis)),
+    timeUtil(itimeUtil),
+    reportTimer(itimeUtil.getTimer()),
+    distanceSettled(itimeUtil.getTimer(), idistanceBand.convert(millimeter), distanceDerivative),
+    angleSettled(itimeUtil.getTimer(), iangleBand.convert(degree), angleDerivative),
+    blendTime(iblendTime),
+    timeout(itimeout) {
+  report.reserve(reportSize);
+  reportTimer->placeMark();
+}
+
+void MotionChain::moveDistance(const QLength itarget) {
+  const double target = itarget.convert(millimeter) + carriedDistance;
+  const double error =
+    run(Kind::distance, target, "moveDistance " + std::to_string(target) + " mm");
+  // A blended motion hands its remaining distance to the next one
+  carriedDistance = report.back().blended ? error : 0;
+}
+
+void MotionChain::turnAngle(const QAngle itarget) {
+  carriedDistance = 0;
+  const double target = itarget.convert(degree);
+  run(Kind::angle, target, "turnAngle " + std::to_string(target) + " deg");
+}
+
+void MotionChain::turnToAngle(const QAngle iangle) {
+  carriedDistance = 0;
+  const double target =
+    std::remainder((iangle - chassis->getState().theta).convert(degree), 360.0);
+  run(Kind::angle,
+      target,
+      "turnToAngle " + std::to_string(iangle.convert(degree)) + " deg (" +
+        std::to_string(target) + " deg)");
+}
+
+void MotionChain::waitUntilSettled() {
+  chassis->waitUntilSettled();
+  carriedDistance = 0;
+  blending = false;
+}
+
+void MotionChain::stop() {
+  chassis->stop();
+  carriedDistance = 0;
+  blending = false;
+}
+
+void MotionChain::setChaining(const bool ichaining) {
+  chaining = ichaining;
+  if (!chaining && blending) {
+    stop();
+  }
+}
+
+void MotionChain::setTimeline(AutonTimeline *itimeline) {
+  timeline = itimeline;
+}
+
+const std::vector<MotionChain::Record> &MotionChain::getReport() const {
+  return report;
+}
+
+void MotionChain::printReport() const {
+  std::uint32_t totalSettle = 0;
+  for (const auto &record : report) {
+    printf("%6lu ms  %-40s %5lu ms total, %4lu ms settling%s\n",
+           static_cast<unsigned long>(record.startMs),
+           record.name.c_str(),
+           static_cast<unsigned long>(record.totalMs),
+           static_cast<unsigned long>(record.settleMs),
+           record.blended ? " (blended)" : record.stalled ? " (stalled)" : "");
+    totalSettle += record.settleMs;
+  }
+  printf("%zu motions, %lu ms waiting to settle\n",
+         report.size(),
+         static_cast<unsigned long>(totalSettle));
+}
+
+void MotionChain::clearReport() {
+  report.clear();
+  reportTimer->placeMark();
+}
+
+double MotionChain::run(const Kind ikind, const double itarget, std::string iname) {
+  auto &settled = ikind == Kind::distance ? distanceSettled : angleSettled;
+  settled.reset();
+  const double stillDerivative = ikind == Kind::distance ? distanceDerivative : angleDerivative;
+
+  const auto start = chassis->getModel()->getSensorVals();
+  const QTime moveStart = reportTimer->getDtFromMark();
+  QTime arrival = moveStart;
+  bool arrived = false;
+
+  Record record;
+  record.name = std::move(iname);
+  record.startMs = static_cast<std::uint32_t>(moveStart.convert(millisecond));
+  const std::size_t span = timeline
+                             ? timeline->begin(AutonTimeline::Lane::drive, record.name.c_str())
+                             : AutonTimeline::none;
+
+  if (ikind == Kind::distance) {
+    chassis->moveDistanceAsync(itarget * millimeter);
+  } else {
+    chassis->turnAngleAsync(itarget * degree);
+  }
+
+  LoopRate rate("MotionChain", timeUtil.getRate());
+  double error = itarget;
+  bool moving = false;
+  std::uint32_t stillCount = 0;
+  while (true) {
+    rate.delayUntilNext();
+
+    const auto [distance, angle] = travelled(start);
+    const double lastError = error;
+    error = itarget - (ikind == Kind::distance ? distance : angle);
+    const bool isSettled = settled.isSettled(error);
+
+    // Holding still only counts once the robot has got going, so the motors spinning up isn't
+    // taken for a stall; a robot which never moves runs into the timeout instead
+    if (std::abs(error - lastError) > stillDerivative) {
+      moving = true;
+      stillCount = 0;
+    } else if (moving) {
+      stillCount++;
+    }
+    const QTime predictedArrival = settled.getPredictedArrival();
+
+    if (!arrived && predictedArrival == 0_ms) {
+      arrived = true;
+      arrival = reportTimer->getDtFromMark();
+    }
+
+    if (isSettled) {
+      // Otherwise the chassis' PID task keeps driving the motors toward this target
+      chassis->stop();
+      break;
+    }
+
+    if (chaining && predictedArrival <= blendTime) {
+      record.blended = true;
+      break;
+    }
+
+    if (stillCount >= stallSamples || reportTimer->getDtFromMark() - moveStart >= timeout) {
+      chassis->stop();
+      record.stalled = true;
+      break;
+    }
+  }
+
+  // The next motion's async call retargets the chassis' controllers without stopping them
+  blending = record.blended;
+  const QTime end = reportTimer->getDtFromMark();
+  record.totalMs = static_cast<std::uint32_t>((end - moveStart).convert(millisecond));
+  record.settleMs = arrived ? static_cast<std::uint32_t>((end - arrival).convert(millisecond)) : 0;
+  if (timeline) {
+    timeline->end(span);
+  }
+  if (report.size() >= reportSize) {
+    report.erase(report.begin());
+  }
+  report.push_back(std::move(record));
+  return error;
+}
+
+std::pair<double, double>
+MotionChain::travelled(const std::valarray<std::int32_t> &istart) const {
+  const auto ticks = chassis->getModel()->getSensorVals();
+  const double left = ticks[0] - istart[0];
+  const double right = ticks[1] - istart[1];
+  const auto scales = chassis->getChassisScales();
+  return {(left + right) / 2.0 / scales.straight * 1000.0, (left - right) / 2.0 / scales.turn};
+}
@@ -0,0 +1,59 @@
+#include "predictiveSettledUtil.hpp"
+#include <cmath>
+#include <limits>
+
+using namespace okapi;
+
+PredictiveSettledUtil::PredictiveSettledUtil(std::unique_ptr<AbstractTimer> iatTargetTimer,
+                                             const double iatTargetError,
+                                             const double iatTargetDerivative,
+                                             const QTime iatTargetTime,
+                                             const QTime isamplePeriod,
+                                             const std::size_t iconfirmSamples,
+                                             const double ihorizon)
+  : SettledUtil(std::move(iatTargetTimer), iatTargetError, iatTargetDerivative, iatTargetTime),
+    samplePeriod(isamplePeriod),
+    confirmSamples(iconfirmSamples),
+    horizon(ihorizon) {
+}
+
+bool PredictiveSettledUtil::isSettled(const double ierror) {
+  // The base class keeps its dwell timer up to date on every sample
+  const bool dwellSettled = SettledUtil::isSettled(ierror);
+
+  lastDerivative = haveSample ? ierror - lastSample : 0;
+  lastSample = ierror;
+  haveSample = true;
+
+  const double projected = ierror + lastDerivative * horizon;
+  if (std::abs(ierror) < atTargetError && std::abs(projected) < atTargetError &&
+      std::abs(lastDerivative) < atTargetDerivative) {
+    predictedCount++;
+  } else {
+    predictedCount = 0;
+  }
+
+  return dwellSettled || predictedCount >= confirmSamples;
+}
+
+void PredictiveSettledUtil::reset() {
+  SettledUtil::reset();
+  predictedCount = 0;
+  lastDerivative = 0;
+  haveSample = false;
+}
+
+QTime PredictiveSettledUtil::getPredictedArrival() const {
+  const double distance = std::abs(lastSample) - atTargetError;
+  if (!haveSample || distance <= 0) {
+    return 0_ms;
+  }
+
+  // Only an error moving towards zero arrives
+  const double closing = lastSample > 0 ? -lastDerivative : lastDerivative;
+  if (closing <= 0) {
+    return std::numeric_limits<double>::infinity() * second;
+  }
+
+  return samplePeriod * (distance / closing);
+}
@@ -0,0 +1,163 @@
+#include "profiledMechanism.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#ifdef THREADS_STD
+#include <chrono>
+#include <thread>
+#else
+#include "pros/rtos.hpp"
+#endif
+
+using namespace okapi;
+
+namespace {
+void delayMs(const std::uint32_t ims) {
+#ifdef THREADS_STD
+  std::this_thread::sleep_for(std::chrono::milliseconds(ims));
+#else
+  pros::delay(ims);
+#endif
+}
+} // namespace
+
+CalibrationTable::CalibrationTable(std::vector<std::pair<double, double>> ipoints)
+  : points(std::move(ipoints)) {
+  std::sort(points.begin(), points.end());
+}
+
+CalibrationTable CalibrationTable::identity() {
+  return CalibrationTable({{0, 0}, {1, 1}});
+}
+
+CalibrationTable CalibrationTable::load(const std::string &ifileName) {
+  CalibrationTable table;
+  FILE *file = fopen(ifileName.c_str(), "r");
+  if (!file) {
+    return table;
+  }
+
+  double sensorVal, degrees;
+  while (fscanf(file, "%lf %lf", &sensorVal, &degrees) == 2) {
+    table.addPoint(sensorVal, degrees);
+  }
+  fclose(file);
+  return table;
+}
+
+bool CalibrationTable::save(const std::string &ifileName) const {
+  FILE *file = fopen(ifileName.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  for (const auto &point : points) {
+    fprintf(file, "%f %f\n", point.first, point.second);
+  }
+  fclose(file);
+  return true;
+}
+
+void CalibrationTable::addPoint(const double isensor, const double idegrees) {
+  const auto pos =
+    std::lower_bound(points.begin(), points.end(), std::make_pair(isensor, idegrees));
+  if (pos != points.end() && pos->first == isensor) {
+    return;
+  }
+  points.insert(pos, {isensor, idegrees});
+}
+
+bool CalibrationTable::isCalibrated() const {
+  return points.size() >= 2;
+}
+
+double CalibrationTable::toDegrees(const double isensor) const {
+  if (!isCalibrated()) {
+    return isensor;
+  }
+
+  // Find the segment containing the reading, clamping to the end segments to extrapolate
+  auto upper = std::upper_bound(points.begin(),
+                                points.end(),
+                                isensor,
+                                [](double value, const auto &point) { return value < point.first; });
+  if (upper == points.begin()) {
+    upper++;
+  } else if (upper == points.end()) {
+    upper--;
+  }
+  const auto lower = upper - 1;
+
+  const double slope = (upper->second - lower->second) / (upper->first - lower->first);
+  return lower->second + (isensor - lower->first) * slope;
+}
+
+ProfiledMechanism::ProfiledMechanism(std::shared_ptr<AsyncLinearMotionProfileController> icontroller,
+                                     std::function<double()> isensor,
+                                     CalibrationTable itable,
+                                     const double ideadband)
+  : controller(std::move(icontroller)),
+    sensor(std::move(isensor)),
+    table(std::move(itable)),
+    deadband(ideadband) {
+}
+
+void ProfiledMechanism::setTarget(const double itarget) {
+  moveLock.lock();
+  target = itarget;
+  // The controller ignores a target set while it follows a path, so the old move has to end first
+  stop();
+
+  const double travel = table.toDegrees(itarget) - table.toDegrees(sensor());
+  if (std::abs(travel) < deadband) {
+    moveLock.unlock();
+    return;
+  }
+
+  // The controller's diameter makes one meter equal one motor revolution
+  const std::string &pathId = pathIds[nextPath];
+  nextPath = 1 - nextPath;
+  controller->generatePath({0_m, std::abs(travel) / 360.0 * meter}, pathId);
+  controller->setTarget(pathId, travel < 0);
+  // The other path's move is over, so it can go
+  controller->removePath(pathIds[nextPath]);
+  moveLock.unlock();
+}
+
+void ProfiledMechanism::stop() {
+  if (controller->isSettled()) {
+    return;
+  }
+
+  // A disabled controller leaves its path at the next step of it, within a loop or two. It reads
+  // as settled while disabled, so only once it is enabled again does isSettled() say whether its
+  // task has actually finished with the path.
+  controller->flipDisable(true);
+  delayMs(20);
+  controller->flipDisable(false);
+  while (!controller->isSettled()) {
+    delayMs(10);
+  }
+}
+
+void ProfiledMechanism::waitUntilSettled() {
+  controller->waitUntilSettled();
+}
+
+bool ProfiledMechanism::isSettled() {
+  return controller->isSettled();
+}
+
+double ProfiledMechanism::getTarget() const {
+  return target;
+}
+
+void ProfiledMechanism::setCalibration(CalibrationTable itable) {
+  moveLock.lock();
+  table = std::move(itable);
+  moveLock.unlock();
+}
+
+const CalibrationTable &ProfiledMechanism::getCalibration() const {
+  return table;
+}
@@ -0,0 +1,104 @@
+#include "scriptScheduler.hpp"
+#include "loopRate.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+using namespace okapi;
+
+ScriptScheduler::ScriptScheduler(const TimeUtil &itimeUtil, const std::size_t icapacity)
+  : timeUtil(itimeUtil), timer(itimeUtil.getTimer()), capacity(icapacity) {
+  scripts.reserve(capacity);
+  timer->placeMark();
+}
+
+ScriptScheduler::ScriptId ScriptScheduler::spawn(const char *iname, Body ibody) {
+  // Growing the buffer would move the script calling spawn() out from under itself
+  if (scripts.size() >= capacity) {
+    throw std::length_error("ScriptScheduler: No room to spawn " + std::string(iname) + ".");
+  }
+
+  Script script;
+  script.name = iname;
+  script.body = std::move(ibody);
+  script.startMs = now();
+  scripts.push_back(std::move(script));
+  return scripts.size() - 1;
+}
+
+bool ScriptScheduler::isFinished(const ScriptId iscript) const {
+  return iscript < scripts.size() && scripts[iscript].finished;
+}
+
+bool ScriptScheduler::isDone() const {
+  return std::all_of(
+    scripts.begin(), scripts.end(), [](const Script &script) { return script.finished; });
+}
+
+void ScriptScheduler::step() {
+  const std::uint32_t time = now();
+  // By index, since scripts spawned on the way are appended and run this tick too
+  for (std::size_t i = 0; i < scripts.size(); i++) {
+    Script &script = scripts[i];
+    if (script.finished) {
+      continue;
+    }
+
+    script.now = time;
+    script.resumes++;
+    if (script.body(script)) {
+      script.finished = true;
+      script.endMs = time;
+      // Its captures, e.x. an open file, go now rather than at clear()
+      script.body = nullptr;
+    }
+  }
+}
+
+bool ScriptScheduler::run(const QTime itimeout) {
+  const std::uint32_t timeout = now() + static_cast<std::uint32_t>(itimeout.convert(millisecond));
+  LoopRate rate("ScriptScheduler", timeUtil.getRate());
+  while (true) {
+    step();
+    if (isDone()) {
+      return true;
+    }
+    if (now() >= timeout) {
+      return false;
+    }
+    rate.delayUntilNext();
+  }
+}
+
+void ScriptScheduler::clear() {
+  scripts.clear();
+  timer->placeMark();
+}
+
+const std::vector<ScriptScheduler::Script> &ScriptScheduler::getScripts() const {
+  return scripts;
+}
+
+void ScriptScheduler::printReport() const {
+  printf("%-24s %8s %8s %8s\n", "script", "start", "end", "resumes");
+  for (const auto &script : scripts) {
+    if (script.finished) {
+      printf("%-24s %8lu %8lu %8lu\n",
+             script.name,
+             static_cast<unsigned long>(script.startMs),
+             static_cast<unsigned long>(script.endMs),
+             static_cast<unsigned long>(script.resumes));
+    } else {
+      printf("%-24s %8lu %8s %8lu (running)\n",
+             script.name,
+             static_cast<unsigned long>(script.startMs),
+             "-",
+             static_cast<unsigned long>(script.resumes));
+    }
+  }
+}
+
+std::uint32_t ScriptScheduler::now() const {
+  return static_cast<std::uint32_t>(timer->getDtFromMark().convert(millisecond));
+}
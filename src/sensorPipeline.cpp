@@ -0,0 +1,226 @@
+#include "sensorPipeline.hpp"
+#include "trace.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace okapi;
+
+namespace {
+/**
+ * Reads the timestamp of the sample being processed, so timing never depends on when the
+ * pipeline runs.
+ */
+class SampleTimer : public AbstractTimer {
+  public:
+  explicit SampleTimer(std::shared_ptr<const std::uint32_t> inow)
+    : AbstractTimer(*inow * millisecond), now(std::move(inow)) {
+  }
+
+  QTime millis() const override {
+    return *now * millisecond;
+  }
+
+  protected:
+  std::shared_ptr<const std::uint32_t> now;
+};
+
+/**
+ * The pipeline is stepped once per sample and never waits.
+ */
+class SampleRate : public AbstractRate {
+  public:
+  void delay(QFrequency) override {
+  }
+
+  void delayUntil(QTime) override {
+  }
+
+  void delayUntil(uint32_t) override {
+  }
+};
+
+const char *const header = "time_ms,left_ticks,right_ticks,left_position,right_position,"
+                           "left_rpm,right_rpm,heading_deg,x_m,y_m,theta_deg,left_filtered_rpm,"
+                           "right_filtered_rpm,angle_out,heading_out";
+} // namespace
+
+/**
+ * The tracking wheels of the current sample, relative to the first one.
+ */
+class SensorPipeline::SampleModel : public ReadOnlyChassisModel, public FixedSensorModel<2> {
+  public:
+  std::valarray<std::int32_t> getSensorVals() const override {
+    return {left, right};
+  }
+
+  std::array<std::int32_t, 2> getSensorArray() const override {
+    return {left, right};
+  }
+
+  std::int32_t left{0};
+  std::int32_t right{0};
+};
+
+SensorPipeline::SensorPipeline() : SensorPipeline(Config()) {
+}
+
+SensorPipeline::SensorPipeline(const Config &iconfig)
+  : config(iconfig),
+    now(std::make_shared<std::uint32_t>(0)),
+    model(std::make_shared<SampleModel>()) {
+}
+
+void SensorPipeline::reset() {
+  odometry.reset();
+  leftFilter.reset();
+  rightFilter.reset();
+  angleController.reset();
+  headingController.reset();
+  started = false;
+  output = PipelineOutput{};
+}
+
+const PipelineOutput &SensorPipeline::step(const SensorSample &isample) {
+  TRACE_SCOPE("SensorPipeline::step");
+  stepOdometry(isample);
+  stepFilters(isample);
+  stepControllers(isample);
+  return output;
+}
+
+void SensorPipeline::stepOdometry(const SensorSample &isample) {
+  TRACE_SCOPE("SensorPipeline::stepOdometry");
+  *now = isample.time;
+
+  if (!started) {
+    // Every stage is built at the first sample's time, so their timers start there
+    started = true;
+    startLeft = isample.leftTicks;
+    startRight = isample.rightTicks;
+
+    std::shared_ptr<const std::uint32_t> sampleTime = now;
+    auto timer = [=]() { return std::make_unique<SampleTimer>(sampleTime); };
+    const TimeUtil timeUtil(
+      Supplier<std::unique_ptr<AbstractTimer>>(timer),
+      Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<SampleRate>(); }),
+      Supplier<std::unique_ptr<SettledUtil>>(
+        [=]() { return std::make_unique<SettledUtil>(timer()); }));
+
+    odometry = std::make_unique<FixedTwoEncoderOdometry>(timeUtil, model, config.scales);
+    leftFilter = config.velocityFilter.get();
+    rightFilter = config.velocityFilter.get();
+    angleController = std::make_unique<IterativePosPIDController>(config.angleGains, timeUtil);
+    headingController = std::make_unique<IterativePosPIDController>(config.headingGains, timeUtil);
+    angleController->setTarget(0);
+    headingController->setTarget(std::isnan(isample.heading) ? 0 : isample.heading);
+  }
+
+  model->left = isample.leftTicks - startLeft;
+  model->right = isample.rightTicks - startRight;
+  odometry->step();
+
+  const OdomState state = odometry->getState();
+  output.x = state.x.convert(meter);
+  output.y = state.y.convert(meter);
+  output.theta = state.theta.convert(degree);
+}
+
+void SensorPipeline::stepFilters(const SensorSample &isample) {
+  TRACE_SCOPE("SensorPipeline::stepFilters");
+  output.leftVelocity = leftFilter->filter(isample.leftVelocity);
+  output.rightVelocity = rightFilter->filter(isample.rightVelocity);
+}
+
+void SensorPipeline::stepControllers(const SensorSample &isample) {
+  TRACE_SCOPE("SensorPipeline::stepControllers");
+  // ChassisControllerPID's angle controller: keep the tracking wheels' difference at zero
+  output.angle = angleController->step(model->left - model->right);
+  output.heading = std::isnan(isample.heading) ? 0 : headingController->step(isample.heading);
+}
+
+const PipelineOutput &SensorPipeline::getOutput() const {
+  return output;
+}
+
+const SensorPipeline::Config &SensorPipeline::getConfig() const {
+  return config;
+}
+
+bool SensorLog::save(const std::string &ifileName, const std::vector<SensorRecord> &irecords) {
+  FILE *file = fopen(ifileName.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "%s\n", header);
+  for (const auto &record : irecords) {
+    const SensorSample &s = record.sample;
+    const PipelineOutput &o = record.output;
+    fprintf(file,
+            "%lu,%ld,%ld,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+            static_cast<unsigned long>(s.time),
+            static_cast<long>(s.leftTicks),
+            static_cast<long>(s.rightTicks),
+            s.leftPosition,
+            s.rightPosition,
+            s.leftVelocity,
+            s.rightVelocity,
+            s.heading,
+            o.x,
+            o.y,
+            o.theta,
+            o.leftVelocity,
+            o.rightVelocity,
+            o.angle,
+            o.heading);
+  }
+  fclose(file);
+  return true;
+}
+
+std::vector<SensorRecord> SensorLog::load(const std::string &ifileName) {
+  std::vector<SensorRecord> records;
+  FILE *file = fopen(ifileName.c_str(), "r");
+  if (!file) {
+    return records;
+  }
+
+  char line[512];
+  while (fgets(line, sizeof(line), file)) {
+    // Fields are parsed one by one with strtod, which reads back the "nan" of a missing IMU
+    char *cursor = line;
+    auto next = [&cursor]() {
+      char *end;
+      const double value = std::strtod(cursor, &end);
+      const bool ok = end != cursor;
+      cursor = *end == ',' ? end + 1 : end;
+      return ok ? value : NAN;
+    };
+
+    const double time = next();
+    if (std::isnan(time)) {
+      continue; // the header
+    }
+
+    SensorRecord r;
+    r.sample.time = static_cast<std::uint32_t>(time);
+    r.sample.leftTicks = static_cast<std::int32_t>(next());
+    r.sample.rightTicks = static_cast<std::int32_t>(next());
+    r.sample.leftPosition = next();
+    r.sample.rightPosition = next();
+    r.sample.leftVelocity = next();
+    r.sample.rightVelocity = next();
+    r.sample.heading = next();
+    r.output.x = next();
+    r.output.y = next();
+    r.output.theta = next();
+    r.output.leftVelocity = next();
+    r.output.rightVelocity = next();
+    r.output.angle = next();
+    r.output.heading = next();
+    records.push_back(r);
+  }
+  fclose(file);
+  return records;
+}
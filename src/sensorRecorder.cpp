@@ -0,0 +1,120 @@
+#include "sensorRecorder.hpp"
+#include "loopRate.hpp"
+#include <cmath>
+
+using namespace okapi;
+
+SensorRecorder::SensorRecorder(const TimeUtil &itimeUtil,
+                               std::shared_ptr<SkidSteerModel> imodel,
+                               std::function<double()> iheading,
+                               const std::size_t icapacity)
+  : timeUtil(itimeUtil),
+    model(std::move(imodel)),
+    fixedModel(dynamic_cast<const FixedSensorModel<2> *>(model.get())),
+    heading(std::move(iheading)),
+    capacity(icapacity),
+    timer(timeUtil.getTimer()),
+    startTime(timer->millis()) {
+  records.reserve(capacity);
+}
+
+SensorRecorder::~SensorRecorder() {
+  dying = true;
+  if (task) {
+    // Deleting the task while it holds recordsLock would leave the lock taken
+    auto rate = timeUtil.getRate();
+    while (!finished) {
+      rate->delayUntil(1_ms);
+    }
+    delete task;
+  }
+}
+
+void SensorRecorder::start() {
+  recordsLock.lock();
+  records.clear();
+  pipeline.reset();
+  startTime = timer->millis();
+  recording = true;
+  recordsLock.unlock();
+
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "SensorRecorder");
+  }
+}
+
+void SensorRecorder::stop() {
+  // Taking the lock waits out a sample in progress
+  recordsLock.lock();
+  recording = false;
+  recordsLock.unlock();
+}
+
+bool SensorRecorder::isRecording() const {
+  return recording;
+}
+
+void SensorRecorder::record() {
+  recordsLock.lock();
+  recordLocked();
+  recordsLock.unlock();
+}
+
+void SensorRecorder::recordLocked() {
+  if (records.size() >= capacity) {
+    return;
+  }
+
+  SensorRecord r;
+  if (fixedModel) {
+    const auto ticks = fixedModel->getSensorArray();
+    r.sample.leftTicks = ticks[0];
+    r.sample.rightTicks = ticks[1];
+  } else {
+    const auto ticks = model->getSensorVals();
+    r.sample.leftTicks = ticks[0];
+    r.sample.rightTicks = ticks[1];
+  }
+
+  const auto left = model->getLeftSideMotor();
+  const auto right = model->getRightSideMotor();
+  r.sample.time = static_cast<std::uint32_t>((timer->millis() - startTime).convert(millisecond));
+  r.sample.leftPosition = left->getPosition();
+  r.sample.rightPosition = right->getPosition();
+  r.sample.leftVelocity = left->getActualVelocity();
+  r.sample.rightVelocity = right->getActualVelocity();
+  r.sample.heading = heading ? heading() : NAN;
+  r.output = pipeline.step(r.sample);
+  records.push_back(r);
+}
+
+bool SensorRecorder::save(const std::string &ifileName) const {
+  recordsLock.lock();
+  const bool saved = SensorLog::save(ifileName, records);
+  recordsLock.unlock();
+  return saved;
+}
+
+const std::vector<SensorRecord> &SensorRecorder::getRecords() const {
+  return records;
+}
+
+void SensorRecorder::trampoline(void *icontext) {
+  if (icontext) {
+    static_cast<SensorRecorder *>(icontext)->loop();
+  }
+}
+
+void SensorRecorder::loop() {
+  LoopRate rate("SensorRecorder", timeUtil.getRate());
+  while (!dying) {
+    // Checked under the lock, so no sample is taken after `stop()` returns
+    recordsLock.lock();
+    if (recording) {
+      recordLocked();
+    }
+    recordsLock.unlock();
+    rate.delayUntilNext();
+  }
+  finished = true;
+}
@@ -0,0 +1,482 @@
+#include "skidSteerSimulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using namespace okapi;
+
+namespace {
+constexpr double gravity = 9.80665;
+constexpr double pi = 3.14159265358979323846;
+constexpr double radToDeg = 180 / pi;
+constexpr double radPerSecToRpm = 60 / (2 * pi);
+} // namespace
+
+SkidSteerSimulator::SkidSteerSimulator(const AbstractMotor::gearset igearset,
+                                       const std::size_t imotorsPerSide,
+                                       const double imass,
+                                       const double iinertia,
+                                       const double iwheelDiameter,
+                                       const double iwheelTrack,
+                                       const double itimestep)
+  : gearset(igearset),
+    motorsPerSide(static_cast<double>(imotorsPerSide)),
+    mass(imass),
+    inertia(iinertia),
+    wheelDiameter(iwheelDiameter),
+    wheelTrack(iwheelTrack),
+    timestep(std::max(itimestep, minTimestep)) {
+  // The cartridges trade speed for torque at the same motor power
+  const double rpm = static_cast<double>(static_cast<std::int32_t>(igearset));
+  freeSpeed = rpm / radPerSecToRpm;
+  stallTorque = 2.1 * 100 / rpm;
+}
+
+SkidSteerSimulator::~SkidSteerSimulator() = default;
+
+void SkidSteerSimulator::step() {
+  std::scoped_lock lock(mutex);
+  stepImpl();
+}
+
+void SkidSteerSimulator::stepFor(const double iseconds) {
+  std::scoped_lock lock(mutex);
+  const double end = time + iseconds - timestep / 2;
+  while (time < end) {
+    stepImpl();
+  }
+}
+
+double SkidSteerSimulator::controlVoltage(const SideState &iside) const {
+  double targetRpm = 0;
+  switch (iside.control) {
+  case Control::voltage:
+    return iside.target;
+
+  case Control::position:
+    targetRpm = std::clamp(positionKp * (iside.target - iside.angle * radToDeg),
+                           -iside.maxRpm,
+                           iside.maxRpm);
+    break;
+
+  case Control::velocity:
+    targetRpm = iside.target;
+    break;
+  }
+
+  // The motor's velocity loop: feed-forward on the free speed plus proportional feedback
+  const double freeRpm = freeSpeed * radPerSecToRpm;
+  return nominalVoltage * targetRpm / freeRpm +
+         velocityKp * (targetRpm - iside.omega * radPerSecToRpm);
+}
+
+void SkidSteerSimulator::stepImpl() {
+  const double radius = wheelDiameter / 2;
+  const double sideWeight = mass * gravity / 2;
+  const double torqueLimit = stallTorque * currentLimit / stallCurrent;
+
+  double totalCurrent = 0;
+  std::array<double, 2> force{};
+  for (std::size_t i = 0; i < 2; i++) {
+    auto &side = sides[i];
+    side.volts = std::clamp(controlVoltage(side), -batteryVoltage, batteryVoltage);
+
+    if (side.volts == 0 && !side.brake) {
+      side.torque = 0;
+    } else {
+      side.torque = std::clamp(
+        stallTorque * (side.volts / nominalVoltage - side.omega / freeSpeed), -torqueLimit, torqueLimit);
+    }
+    side.torque *= side.torqueScale;
+    side.current = std::abs(side.torque) / stallTorque * stallCurrent;
+    totalCurrent += side.current * motorsPerSide;
+
+    // Traction grows with slip between the wheel surface and the ground, up to the friction limit
+    const double groundSpeed = velocity + (i == left ? -1 : 1) * yawRate * wheelTrack / 2;
+    const double slip = side.omega * radius - groundSpeed;
+    force[i] = std::clamp(slipStiffness * slip, -traction * sideWeight, traction * sideWeight);
+
+    side.omega += (side.torque * motorsPerSide - force[i] * radius) / wheelInertia * timestep;
+    side.angle += side.omega * timestep;
+  }
+
+  const double rollingForce = rolling * mass * gravity * std::tanh(velocity / 0.01);
+  const double accel = (force[left] + force[right] - rollingForce) / mass;
+  const double yawAccel =
+    ((force[right] - force[left]) * wheelTrack / 2 - yawScrub * yawRate) / inertia;
+
+  velocity += accel * timestep;
+  yawRate += yawAccel * timestep;
+
+  pose.theta += yawRate * timestep;
+  pose.x += velocity * std::cos(pose.theta) * timestep;
+  pose.y += velocity * std::sin(pose.theta) * timestep;
+
+  sides[left].tracking += (velocity - yawRate * trackingTrack / 2) * timestep;
+  sides[right].tracking += (velocity + yawRate * trackingTrack / 2) * timestep;
+
+  batteryVoltage = std::max(0.0, openCircuitVoltage - internalResistance * totalCurrent);
+  time += timestep;
+}
+
+void SkidSteerSimulator::setVoltage(const Side iside, const double ivolts) {
+  std::scoped_lock lock(mutex);
+  sides[iside].control = Control::voltage;
+  sides[iside].target = ivolts;
+}
+
+void SkidSteerSimulator::setVelocity(const Side iside, const double irpm) {
+  std::scoped_lock lock(mutex);
+  sides[iside].control = Control::velocity;
+  sides[iside].target = irpm;
+}
+
+void SkidSteerSimulator::setPosition(const Side iside, const double idegrees, const double imaxRpm) {
+  std::scoped_lock lock(mutex);
+  sides[iside].control = Control::position;
+  sides[iside].target = idegrees;
+  sides[iside].maxRpm = std::abs(imaxRpm);
+}
+
+void SkidSteerSimulator::setBrake(const Side iside, const bool ibrake) {
+  std::scoped_lock lock(mutex);
+  sides[iside].brake = ibrake;
+}
+
+void SkidSteerSimulator::setCurrentLimit(const double ilimit) {
+  std::scoped_lock lock(mutex);
+  currentLimit = ilimit / 1000;
+}
+
+void SkidSteerSimulator::setBattery(const double iopenCircuitVoltage,
+                                    const double iinternalResistance) {
+  std::scoped_lock lock(mutex);
+  openCircuitVoltage = iopenCircuitVoltage;
+  internalResistance = iinternalResistance;
+  batteryVoltage = iopenCircuitVoltage;
+}
+
+void SkidSteerSimulator::setFriction(const double itraction, const double irolling) {
+  std::scoped_lock lock(mutex);
+  traction = itraction;
+  rolling = irolling;
+}
+
+void SkidSteerSimulator::setTorqueScale(const Side iside, const double iscale) {
+  std::scoped_lock lock(mutex);
+  sides[iside].torqueScale = iscale;
+}
+
+void SkidSteerSimulator::setTrackingWheels(const double idiameter,
+                                           const double itrack,
+                                           const double itpr) {
+  std::scoped_lock lock(mutex);
+  trackingDiameter = idiameter;
+  trackingTrack = itrack;
+  trackingTpr = itpr;
+}
+
+void SkidSteerSimulator::setMass(const double imass) {
+  std::scoped_lock lock(mutex);
+  mass = imass;
+}
+
+void SkidSteerSimulator::setInertia(const double iinertia) {
+  std::scoped_lock lock(mutex);
+  inertia = iinertia;
+}
+
+void SkidSteerSimulator::setWheelDiameter(const double idiameter) {
+  std::scoped_lock lock(mutex);
+  wheelDiameter = idiameter;
+}
+
+void SkidSteerSimulator::setWheelTrack(const double itrack) {
+  std::scoped_lock lock(mutex);
+  wheelTrack = itrack;
+}
+
+void SkidSteerSimulator::setTimestep(const double itimestep) {
+  std::scoped_lock lock(mutex);
+  timestep = std::max(itimestep, minTimestep);
+}
+
+void SkidSteerSimulator::setPose(const Pose &ipose) {
+  std::scoped_lock lock(mutex);
+  pose = ipose;
+}
+
+SkidSteerSimulator::Pose SkidSteerSimulator::getPose() const {
+  std::scoped_lock lock(mutex);
+  return pose;
+}
+
+double SkidSteerSimulator::getTime() const {
+  std::scoped_lock lock(mutex);
+  return time;
+}
+
+double SkidSteerSimulator::getVelocity() const {
+  std::scoped_lock lock(mutex);
+  return velocity;
+}
+
+double SkidSteerSimulator::getYawRate() const {
+  std::scoped_lock lock(mutex);
+  return yawRate;
+}
+
+double SkidSteerSimulator::getWheelPosition(const Side iside) const {
+  std::scoped_lock lock(mutex);
+  return sides[iside].angle * radToDeg;
+}
+
+double SkidSteerSimulator::getWheelVelocity(const Side iside) const {
+  std::scoped_lock lock(mutex);
+  return sides[iside].omega * radPerSecToRpm;
+}
+
+std::int32_t SkidSteerSimulator::getTrackingTicks(const Side iside) const {
+  std::scoped_lock lock(mutex);
+  return static_cast<std::int32_t>(
+    std::floor(sides[iside].tracking / (trackingDiameter * pi) * trackingTpr));
+}
+
+double SkidSteerSimulator::getCurrent(const Side iside) const {
+  std::scoped_lock lock(mutex);
+  return sides[iside].current * 1000;
+}
+
+double SkidSteerSimulator::getTorque(const Side iside) const {
+  std::scoped_lock lock(mutex);
+  return sides[iside].torque;
+}
+
+double SkidSteerSimulator::getAppliedVoltage(const Side iside) const {
+  std::scoped_lock lock(mutex);
+  return sides[iside].volts;
+}
+
+double SkidSteerSimulator::getBatteryVoltage() const {
+  std::scoped_lock lock(mutex);
+  return batteryVoltage;
+}
+
+AbstractMotor::gearset SkidSteerSimulator::getGearset() const {
+  return gearset;
+}
+
+std::shared_ptr<SkidSteerModel>
+SkidSteerSimulator::makeChassisModel(const std::shared_ptr<SkidSteerSimulator> &isim,
+                                     const bool itrackingWheels) {
+  return std::make_shared<SkidSteerModel>(
+    std::make_shared<SimulatedMotor>(isim, left),
+    std::make_shared<SimulatedMotor>(isim, right),
+    std::make_shared<SimulatedEncoder>(isim, left, itrackingWheels),
+    std::make_shared<SimulatedEncoder>(isim, right, itrackingWheels),
+    static_cast<double>(static_cast<std::int32_t>(isim->getGearset())),
+    12000);
+}
+
+SimulatedMotor::SimulatedMotor(std::shared_ptr<SkidSteerSimulator> isim,
+                               const SkidSteerSimulator::Side iside)
+  : sim(std::move(isim)), side(iside) {
+}
+
+std::int32_t SimulatedMotor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  targetPosition = iposition * unitScale();
+  sim->setPosition(side, targetPosition + zero, ivelocity);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  return moveAbsolute(getPosition() + iposition, ivelocity);
+}
+
+std::int32_t SimulatedMotor::moveVelocity(const std::int16_t ivelocity) {
+  targetVelocity = ivelocity;
+  sim->setVelocity(side, ivelocity);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::moveVoltage(const std::int16_t ivoltage) {
+  sim->setVoltage(side, ivoltage / 1000.0);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  sim->setPosition(side, targetPosition + zero, ivelocity);
+  return 1;
+}
+
+double SimulatedMotor::getTargetPosition() {
+  return targetPosition / unitScale();
+}
+
+double SimulatedMotor::getPosition() {
+  return (sim->getWheelPosition(side) - zero) / unitScale();
+}
+
+std::int32_t SimulatedMotor::tarePosition() {
+  zero = sim->getWheelPosition(side);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::getTargetVelocity() {
+  return targetVelocity;
+}
+
+double SimulatedMotor::getActualVelocity() {
+  return sim->getWheelVelocity(side);
+}
+
+std::int32_t SimulatedMotor::getCurrentDraw() {
+  return static_cast<std::int32_t>(sim->getCurrent(side));
+}
+
+std::int32_t SimulatedMotor::getDirection() {
+  return getActualVelocity() < 0 ? -1 : 1;
+}
+
+double SimulatedMotor::getEfficiency() {
+  const double power = getPower();
+  return power > 0 ? 100 * getTorque() * std::abs(getActualVelocity()) / radPerSecToRpm / power : 0;
+}
+
+std::int32_t SimulatedMotor::isOverCurrent() {
+  return sim->getCurrent(side) >= currentLimit;
+}
+
+std::int32_t SimulatedMotor::isOverTemp() {
+  return 0;
+}
+
+std::int32_t SimulatedMotor::isStopped() {
+  return std::abs(getActualVelocity()) < 1;
+}
+
+std::int32_t SimulatedMotor::getZeroPositionFlag() {
+  return std::abs(getPosition()) < 1;
+}
+
+uint32_t SimulatedMotor::getFaults() {
+  return 0;
+}
+
+uint32_t SimulatedMotor::getFlags() {
+  return 0;
+}
+
+std::int32_t SimulatedMotor::getRawPosition(std::uint32_t *timestamp) {
+  if (timestamp) {
+    *timestamp = static_cast<std::uint32_t>(sim->getTime() * 1000);
+  }
+  // Counts per revolution are 1800, 900 and 300 for the red, green and blue cartridges
+  const double countsPerRev = 180000.0 / static_cast<std::int32_t>(sim->getGearset());
+  return static_cast<std::int32_t>(sim->getWheelPosition(side) / 360 * countsPerRev);
+}
+
+double SimulatedMotor::getPower() {
+  return std::abs(sim->getAppliedVoltage(side)) * sim->getCurrent(side) / 1000;
+}
+
+double SimulatedMotor::getTemperature() {
+  return 25;
+}
+
+double SimulatedMotor::getTorque() {
+  return std::abs(sim->getTorque(side));
+}
+
+std::int32_t SimulatedMotor::getVoltage() {
+  return static_cast<std::int32_t>(sim->getAppliedVoltage(side) * 1000);
+}
+
+std::int32_t SimulatedMotor::setBrakeMode(const AbstractMotor::brakeMode imode) {
+  brake = imode;
+  sim->setBrake(side, imode != brakeMode::coast);
+  return 1;
+}
+
+AbstractMotor::brakeMode SimulatedMotor::getBrakeMode() {
+  return brake;
+}
+
+std::int32_t SimulatedMotor::setCurrentLimit(const std::int32_t ilimit) {
+  currentLimit = ilimit;
+  sim->setCurrentLimit(ilimit);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::getCurrentLimit() {
+  return currentLimit;
+}
+
+std::int32_t SimulatedMotor::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+  units = iunits;
+  return 1;
+}
+
+AbstractMotor::encoderUnits SimulatedMotor::getEncoderUnits() {
+  return units;
+}
+
+std::int32_t SimulatedMotor::setGearing(const AbstractMotor::gearset) {
+  // The cartridge is part of the simulation's construction
+  return 1;
+}
+
+AbstractMotor::gearset SimulatedMotor::getGearing() {
+  return sim->getGearset();
+}
+
+std::int32_t SimulatedMotor::setReversed(const bool) {
+  // The simulated sides always run forward on positive commands
+  return 1;
+}
+
+std::int32_t SimulatedMotor::setVoltageLimit(const std::int32_t) {
+  return 1;
+}
+
+std::shared_ptr<ContinuousRotarySensor> SimulatedMotor::getEncoder() {
+  return std::make_shared<SimulatedEncoder>(sim, side, false);
+}
+
+void SimulatedMotor::controllerSet(const double ivalue) {
+  moveVelocity(static_cast<std::int16_t>(ivalue * static_cast<std::int32_t>(sim->getGearset())));
+}
+
+double SimulatedMotor::unitScale() const {
+  switch (units) {
+  case encoderUnits::rotations:
+    return 360;
+  case encoderUnits::counts:
+    return 360 * static_cast<std::int32_t>(sim->getGearset()) / 180000.0;
+  default:
+    return 1;
+  }
+}
+
+SimulatedEncoder::SimulatedEncoder(std::shared_ptr<SkidSteerSimulator> isim,
+                                   const SkidSteerSimulator::Side iside,
+                                   const bool itrackingWheel)
+  : sim(std::move(isim)), side(iside), trackingWheel(itrackingWheel) {
+}
+
+double SimulatedEncoder::get() const {
+  return raw() - zero;
+}
+
+std::int32_t SimulatedEncoder::reset() {
+  zero = raw();
+  return 1;
+}
+
+double SimulatedEncoder::controllerGet() {
+  return get();
+}
+
+double SimulatedEncoder::raw() const {
+  return trackingWheel ? sim->getTrackingTicks(side) : sim->getWheelPosition(side);
+}
@@ -0,0 +1,97 @@
+#include "timingStats.hpp"
+#include <cmath>
+
+TimingStats::TimingStats(const std::uint32_t ilimit) : limit(ilimit) {
+}
+
+void TimingStats::add(const std::uint32_t ius) {
+  count++;
+  sum += ius;
+  if (ius < min) {
+    min = ius;
+  }
+  if (ius > max) {
+    max = ius;
+  }
+  if (ius > limit) {
+    overLimit++;
+  }
+  buckets[bucketOf(ius)]++;
+}
+
+void TimingStats::clear() {
+  count = 0;
+  overLimit = 0;
+  sum = 0;
+  min = std::numeric_limits<std::uint32_t>::max();
+  max = 0;
+  buckets.fill(0);
+}
+
+std::uint32_t TimingStats::getCount() const {
+  return count;
+}
+
+std::uint32_t TimingStats::getOverLimit() const {
+  return overLimit;
+}
+
+std::uint32_t TimingStats::getLimit() const {
+  return limit;
+}
+
+double TimingStats::getMean() const {
+  return count == 0 ? 0 : static_cast<double>(sum) / count;
+}
+
+std::uint32_t TimingStats::getMin() const {
+  return count == 0 ? 0 : min;
+}
+
+std::uint32_t TimingStats::getMax() const {
+  return max;
+}
+
+std::uint32_t TimingStats::getPercentile(const double ifraction) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  const auto rank = static_cast<std::uint32_t>(std::ceil(ifraction * count));
+  std::uint32_t seen = 0;
+  for (std::size_t i = 0; i < bucketCount; i++) {
+    seen += buckets[i];
+    if (seen >= rank && seen > 0) {
+      std::uint32_t lower, upper;
+      getBucket(i, lower, upper);
+      return upper < max ? upper : max;
+    }
+  }
+  return max;
+}
+
+std::uint32_t TimingStats::getBucket(const std::size_t ibucket,
+                                     std::uint32_t &olower,
+                                     std::uint32_t &oupper) const {
+  if (ibucket < subBuckets) {
+    olower = oupper = static_cast<std::uint32_t>(ibucket);
+  } else {
+    // Bucket 8 + 8 * k + s covers (8 + s) << k up to the next one
+    const std::size_t shift = (ibucket - subBuckets) / subBuckets;
+    const std::size_t sub = (ibucket - subBuckets) % subBuckets;
+    const std::uint64_t lower = static_cast<std::uint64_t>(subBuckets + sub) << shift;
+    olower = static_cast<std::uint32_t>(lower);
+    oupper = static_cast<std::uint32_t>(lower + (std::uint64_t{1} << shift) - 1);
+  }
+  return buckets[ibucket];
+}
+
+std::size_t TimingStats::bucketOf(const std::uint32_t ius) {
+  if (ius < subBuckets) {
+    return ius;
+  }
+
+  // The top four bits pick the bucket: the leading one's position and the three below it
+  const std::size_t shift = static_cast<std::size_t>(31 - __builtin_clz(ius)) - 3;
+  return subBuckets + shift * subBuckets + ((ius >> shift) - subBuckets);
+}
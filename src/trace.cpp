@@ -0,0 +1,205 @@
+#include "trace.hpp"
+
+#ifdef ENABLE_TRACING
+
+#include "microClock.hpp"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#ifdef THREADS_STD
+#include <thread>
+#else
+#include "pros/rtos.h"
+#endif
+
+namespace {
+struct Event {
+  const char *name;
+  std::uint32_t start;
+  std::uint32_t duration;
+};
+
+/**
+ * One task's events. Only that task writes, so it publishes each event by moving `head` on and
+ * needs no lock.
+ */
+struct Ring {
+  std::atomic<const void *> task{nullptr};
+  std::atomic_bool claimed{false};
+  char name[32]{};
+  std::unique_ptr<Event[]> events;
+  std::atomic<std::uint32_t> head{0}; // free-running, masked into `events`
+};
+
+static_assert((Trace::eventsPerTask & (Trace::eventsPerTask - 1)) == 0,
+              "eventsPerTask must be a power of two");
+
+std::array<Ring, Trace::maxTasks> rings;
+std::atomic_bool recording{false};
+// record() calls between checking `recording` and finishing their write, for save() to wait out
+std::atomic<std::uint32_t> writers{0};
+std::atomic<std::uint32_t> droppedTasks{0};
+
+const void *currentTask() {
+#ifdef THREADS_STD
+  thread_local const char self = 0;
+  return &self;
+#else
+  return pros::c::task_get_current();
+#endif
+}
+
+void nameRing(Ring &ioring, const void *itask) {
+#ifdef THREADS_STD
+  (void)itask;
+  std::snprintf(ioring.name,
+                sizeof(ioring.name),
+                "thread %u",
+                static_cast<unsigned>(&ioring - &rings[0]));
+#else
+  const char *name =
+    itask ? pros::c::task_get_name(static_cast<pros::task_t>(const_cast<void *>(itask))) : nullptr;
+  std::strncpy(ioring.name, name ? name : "(startup)", sizeof(ioring.name) - 1);
+#endif
+}
+
+/**
+ * Finds the calling task's ring, claiming one the first time. Returns null once all are taken.
+ */
+Ring *ringOf(const void *itask) {
+  for (auto &ring : rings) {
+    if (!ring.claimed.load(std::memory_order_acquire)) {
+      bool expected = false;
+      if (!ring.claimed.compare_exchange_strong(expected, true)) {
+        continue;
+      }
+      ring.events.reset(new (std::nothrow) Event[Trace::eventsPerTask]);
+      nameRing(ring, itask);
+      ring.task.store(itask, std::memory_order_release);
+      return ring.events ? &ring : nullptr;
+    }
+    if (ring.task.load(std::memory_order_acquire) == itask && ring.name[0] != '\0') {
+      return ring.events ? &ring : nullptr;
+    }
+  }
+  droppedTasks.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+}
+
+/**
+ * Writes a name as a JSON string, escaping what JSON needs escaped.
+ */
+void writeString(FILE *ifile, const char *itext) {
+  fputc('"', ifile);
+  for (const char *c = itext; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', ifile);
+      fputc(*c, ifile);
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      fprintf(ifile, "\\u%04x", static_cast<unsigned>(*c));
+    } else {
+      fputc(*c, ifile);
+    }
+  }
+  fputc('"', ifile);
+}
+} // namespace
+
+void Trace::start() {
+  recording = true;
+}
+
+void Trace::stop() {
+  recording = false;
+}
+
+bool Trace::isRecording() {
+  return recording;
+}
+
+std::uint32_t Trace::now() {
+  return static_cast<std::uint32_t>(microClock());
+}
+
+void Trace::record(const char *iname,
+                   const std::uint32_t istartUs,
+                   const std::uint32_t idurationUs) {
+  // Counted before checking the flag, and save() clears the flag before reading the count, so
+  // either this sees recording off or save() sees this write in flight
+  writers.fetch_add(1);
+  if (!recording.load()) {
+    writers.fetch_sub(1, std::memory_order_release);
+    return;
+  }
+
+  Ring *ring = ringOf(currentTask());
+  if (ring) {
+    const std::uint32_t head = ring->head.load(std::memory_order_relaxed);
+    ring->events[head & (eventsPerTask - 1)] = Event{iname, istartUs, idurationUs};
+    ring->head.store(head + 1, std::memory_order_release);
+  }
+  writers.fetch_sub(1, std::memory_order_release);
+}
+
+bool Trace::save(const char *ifileName) {
+  FILE *file = fopen(ifileName, "w");
+  if (!file) {
+    return false;
+  }
+
+  // A scope closing while this reads its ring could be half written, so hold recording off and
+  // wait for writes already past the check to finish
+  const bool wasRecording = recording.exchange(false);
+  while (writers.load(std::memory_order_acquire) != 0) {
+    // Sleep rather than spin, so a lower-priority task mid-write gets to finish it
+#ifdef THREADS_STD
+    std::this_thread::yield();
+#else
+    pros::c::delay(1);
+#endif
+  }
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool first = true;
+  for (std::size_t tid = 0; tid < rings.size(); tid++) {
+    const Ring &ring = rings[tid];
+    if (!ring.events || ring.name[0] == '\0') {
+      continue;
+    }
+
+    fprintf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+            first ? "" : ",\n",
+            static_cast<unsigned>(tid));
+    writeString(file, ring.name);
+    fprintf(file, "}}");
+    first = false;
+
+    const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+    const std::uint32_t count = head < eventsPerTask ? head : eventsPerTask;
+    for (std::uint32_t i = head - count; i != head; i++) {
+      const Event &event = ring.events[i & (eventsPerTask - 1)];
+      fprintf(file, ",\n{\"name\":");
+      writeString(file, event.name);
+      fprintf(file,
+              ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lu,\"dur\":%lu}",
+              static_cast<unsigned>(tid),
+              static_cast<unsigned long>(event.start),
+              static_cast<unsigned long>(event.duration));
+    }
+  }
+  fprintf(file, "\n]}\n");
+  fclose(file);
+
+  if (droppedTasks.load(std::memory_order_relaxed) > 0) {
+    printf("Trace: more than %u tasks traced, the rest weren't recorded\n",
+           static_cast<unsigned>(maxTasks));
+  }
+
+  recording = wasRecording;
+  return true;
+}
+
+#endif
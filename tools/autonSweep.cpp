@@ -0,0 +1,387 @@
+/*
+ * Monte Carlo robustness sweep of an autonomous routine.
+ *
+ * Links main.cpp and the rest of src/ against the host PROS shims, runs initialize() once, then
+ * runs autonomous() through a full 15 s autonomous period for every sample of randomized robot
+ * parameters: drive wheel radius around main.cpp's `r`, battery voltage, traction, encoder noise
+ * and start pose. Sample 0 is the nominal robot, and every other sample's final pose is compared
+ * against it.
+ *
+ * Each sample runs in a forked copy of the process, since the robot code's globals and the clock
+ * are process-wide; up to one sample per core runs at a time. A sample which crashes, e.x. on an
+ * uncaught exception, is counted as a crash instead of ending the sweep.
+ *
+ * Usage: autonSweep [--runs 1000] [--mode <autonMode>] [--side <1 red, -1 blue>] [--jobs <cores>]
+ *                   [--graph 0] [--seed 1] [--usd sd] [--csv samples.csv] [--radius-sd 0.01]
+ *                   [--battery-min 11.8] [--battery-max 12.9] [--traction-min 0.7]
+ *                   [--traction-max 1.1] [--noise 0.5] [--pose-sd 0.01] [--heading-sd 1]
+ *
+ * --graph 1 runs the mode as its step graph (main.cpp's buildAutonGraph) instead of the
+ * straight-line routine, to compare the two.
+ *
+ * --usd is the host directory standing in for the SD card; initialize() generates its motion
+ * curves there if they are missing. --radius-sd is a fraction of the radius, --noise is tracking
+ * wheel ticks, --pose-sd is m and --heading-sd is degrees, all standard deviations.
+ */
+#include "main.h"
+#include "sdCard.hpp"
+#include "simulatedRobot.hpp"
+#include "virtualClock.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// main.cpp's globals
+extern int autonMode;
+extern bool useAutonGraph;
+extern int sideSelector;
+extern double r;
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+constexpr std::uint32_t autonomousPeriod = 15000; // ms
+
+enum class Status : int { completed, timedOut, crashed };
+
+struct Result {
+  Status status{Status::crashed};
+  double durationMs{0};
+  SkidSteerSimulator::Pose pose;
+};
+
+struct Sample {
+  SimulatedRobot::Params params;
+  Result result;
+};
+
+/**
+ * Wires the simulated robot to main.cpp's ports.
+ */
+void wireRobot(SimulatedRobot &irobot) {
+  irobot.attachDrive(SkidSteerSimulator::left, 1);
+  irobot.attachDrive(SkidSteerSimulator::left, 2);
+  irobot.attachDrive(SkidSteerSimulator::right, 9);
+  irobot.attachDrive(SkidSteerSimulator::right, 10);
+  irobot.attachTrackingWheel(SkidSteerSimulator::left, 'E' - 'A' + 1);
+  irobot.attachTrackingWheel(SkidSteerSimulator::right, 'G' - 'A' + 1);
+
+  // The angler potentiometer reads 1453 with the tray down and rises a count per tray degree
+  irobot.setAnalogInput(2, [&irobot]() {
+    return static_cast<std::int32_t>(std::clamp(1453 - irobot.getPosition(5), 0.0, 4095.0));
+  });
+}
+
+/**
+ * Runs one sample's autonomous period. Only called in a forked child.
+ */
+Result runSample(const SimulatedRobot::Params &iparams) {
+  SimulatedRobot::get().configure(iparams);
+  auto &clock = VirtualClock::get();
+
+  Result result;
+  const auto run = clock.run([]() { autonomous(); }, autonomousPeriod);
+  result.status = run.completed ? Status::completed : Status::timedOut;
+  result.durationMs = run.durationMs;
+
+  // Tasks the routine started keep moving the robot until the period ends
+  if (const double remaining = autonomousPeriod - run.durationMs; run.completed && remaining > 0) {
+    clock.run([remaining]() { pros::delay(static_cast<std::uint32_t>(remaining)); },
+              static_cast<std::uint32_t>(remaining) + 1,
+              "Period");
+  }
+  result.pose = SimulatedRobot::get().getSimulator()->getPose();
+  return result;
+}
+
+/**
+ * Runs samples in forked children, at most `ijobs` at a time.
+ */
+void runAll(std::vector<Sample> &isamples, const unsigned ijobs) {
+  struct Child {
+    std::size_t index;
+    int pipe;
+  };
+  std::map<pid_t, Child> children;
+  std::size_t next = 0;
+  std::size_t done = 0;
+
+  while (done < isamples.size()) {
+    while (next < isamples.size() && children.size() < ijobs) {
+      int fds[2];
+      if (pipe(fds) != 0) {
+        perror("pipe");
+        exit(1);
+      }
+
+      std::fflush(stdout);
+      const pid_t pid = fork();
+      if (pid == 0) {
+        close(fds[0]);
+        const Result result = runSample(isamples[next].params);
+        // Well under PIPE_BUF, so the write is atomic and never blocks
+        const ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? 0 : 1);
+      } else if (pid < 0) {
+        perror("fork");
+        exit(1);
+      }
+
+      close(fds[1]);
+      children[pid] = {next++, fds[0]};
+    }
+
+    int status;
+    const pid_t pid = wait(&status);
+    if (pid < 0) {
+      perror("wait");
+      exit(1);
+    }
+    const auto child = children.find(pid);
+    if (child == children.end()) {
+      continue;
+    }
+
+    Result result;
+    if (!(WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+          read(child->second.pipe, &result, sizeof(result)) == sizeof(result))) {
+      result = Result();
+    }
+    close(child->second.pipe);
+    isamples[child->second.index].result = result;
+    children.erase(child);
+
+    if (++done % 100 == 0) {
+      fprintf(stderr, "%zu/%zu\n", done, isamples.size());
+    }
+  }
+}
+
+struct Summary {
+  double mean{0};
+  double sd{0};
+  double p5{0};
+  double p50{0};
+  double p95{0};
+  double max{0};
+};
+
+Summary summarize(std::vector<double> ivalues) {
+  Summary out;
+  if (ivalues.empty()) {
+    return out;
+  }
+
+  std::sort(ivalues.begin(), ivalues.end());
+  const auto percentile = [&](const double ip) {
+    return ivalues[static_cast<std::size_t>(ip * (ivalues.size() - 1) + 0.5)];
+  };
+  for (const double value : ivalues) {
+    out.mean += value / ivalues.size();
+  }
+  for (const double value : ivalues) {
+    out.sd += (value - out.mean) * (value - out.mean) / ivalues.size();
+  }
+  out.sd = std::sqrt(out.sd);
+  out.p5 = percentile(0.05);
+  out.p50 = percentile(0.5);
+  out.p95 = percentile(0.95);
+  out.max = ivalues.back();
+  return out;
+}
+
+double correlation(const std::vector<double> &ix, const std::vector<double> &iy) {
+  const double n = ix.size();
+  double mx = 0, my = 0;
+  for (std::size_t i = 0; i < ix.size(); i++) {
+    mx += ix[i] / n;
+    my += iy[i] / n;
+  }
+  double sxy = 0, sxx = 0, syy = 0;
+  for (std::size_t i = 0; i < ix.size(); i++) {
+    sxy += (ix[i] - mx) * (iy[i] - my);
+    sxx += (ix[i] - mx) * (ix[i] - mx);
+    syy += (iy[i] - my) * (iy[i] - my);
+  }
+  return sxx > 0 && syy > 0 ? sxy / std::sqrt(sxx * syy) : 0;
+}
+
+void printSummary(const char *iname, const char *iunit, const Summary &isummary) {
+  printf("%-16s %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f  %s\n",
+         iname,
+         isummary.mean,
+         isummary.sd,
+         isummary.p5,
+         isummary.p50,
+         isummary.p95,
+         isummary.max,
+         iunit);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::map<std::string, std::string> options{{"--runs", "1000"},
+                                             {"--mode", std::to_string(autonMode)},
+                                             {"--side", std::to_string(sideSelector)},
+                                             {"--jobs", std::to_string(cores)},
+                                             {"--graph", "0"},
+                                             {"--seed", "1"},
+                                             {"--usd", "sd"},
+                                             {"--csv", ""},
+                                             {"--radius-sd", "0.01"},
+                                             {"--battery-min", "11.8"},
+                                             {"--battery-max", "12.9"},
+                                             {"--traction-min", "0.7"},
+                                             {"--traction-max", "1.1"},
+                                             {"--noise", "0.5"},
+                                             {"--pose-sd", "0.01"},
+                                             {"--heading-sd", "1"}};
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!options.count(argv[i])) {
+      fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+    options[argv[i]] = argv[i + 1];
+  }
+  const auto number = [&](const char *iname) { return std::stod(options[iname]); };
+
+  autonMode = std::stoi(options["--mode"]);
+  useAutonGraph = std::stoi(options["--graph"]) != 0;
+  sideSelector = std::stoi(options["--side"]);
+  mkdir(options["--usd"].c_str(), 0755);
+  SdCard::mount(options["--usd"]);
+  auto &robot = SimulatedRobot::get();
+  wireRobot(robot);
+
+  SimulatedRobot::Params nominal;
+  nominal.wheelRadius = r;
+  robot.configure(nominal);
+  if (!VirtualClock::get().run([]() { initialize(); }, 30000, "Initialize").completed) {
+    fprintf(stderr, "initialize() did not finish\n");
+    return 1;
+  }
+
+  // Samples are drawn up front, so a sweep is the same for any number of jobs
+  std::mt19937 random(static_cast<std::uint32_t>(number("--seed")));
+  std::normal_distribution<double> normal(0, 1);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  const auto between = [&](const char *imin, const char *imax) {
+    return number(imin) + (number(imax) - number(imin)) * uniform(random);
+  };
+
+  std::vector<Sample> samples(std::max(2, std::stoi(options["--runs"]) + 1));
+  samples[0].params = nominal;
+  for (std::size_t i = 1; i < samples.size(); i++) {
+    auto &params = samples[i].params;
+    params = nominal;
+    params.wheelRadius = r * (1 + number("--radius-sd") * normal(random));
+    params.batteryVoltage = between("--battery-min", "--battery-max");
+    params.traction = between("--traction-min", "--traction-max");
+    params.encoderNoise = number("--noise");
+    params.startPose = {number("--pose-sd") * normal(random),
+                        number("--pose-sd") * normal(random),
+                        number("--heading-sd") * pi / 180 * normal(random)};
+    params.seed = static_cast<std::uint32_t>(random());
+  }
+
+  const unsigned jobs = std::max(1, std::stoi(options["--jobs"]));
+  runAll(samples, jobs);
+
+  const Result &reference = samples[0].result;
+  if (reference.status == Status::crashed) {
+    fprintf(stderr, "The nominal run crashed\n");
+    return 1;
+  }
+
+  std::vector<double> positionError, headingError, duration;
+  std::vector<double> radius, battery, traction, startOffset;
+  int completed = 0, timedOut = 0, crashed = 0;
+  for (std::size_t i = 1; i < samples.size(); i++) {
+    const auto &sample = samples[i];
+    if (sample.result.status == Status::crashed) {
+      crashed++;
+      continue;
+    }
+    (sample.result.status == Status::completed ? completed : timedOut)++;
+
+    const auto &pose = sample.result.pose;
+    positionError.push_back(
+      std::hypot(pose.x - reference.pose.x, pose.y - reference.pose.y) * 100);
+    headingError.push_back(
+      std::abs(std::remainder(pose.theta - reference.pose.theta, 2 * pi)) * 180 / pi);
+    duration.push_back(sample.result.durationMs / 1000);
+    radius.push_back(sample.params.wheelRadius);
+    battery.push_back(sample.params.batteryVoltage);
+    traction.push_back(sample.params.traction);
+    startOffset.push_back(std::hypot(sample.params.startPose.x, sample.params.startPose.y));
+  }
+
+  printf("autonMode %d, side %d: %zu samples on %u jobs\n",
+         autonMode,
+         sideSelector,
+         samples.size() - 1,
+         jobs);
+  printf("nominal: %s in %.3f s, final pose (%.3f m, %.3f m, %.1f deg)\n",
+         reference.status == Status::completed ? "completed" : "timed out",
+         reference.durationMs / 1000,
+         reference.pose.x,
+         reference.pose.y,
+         reference.pose.theta * 180 / pi);
+  printf("%d completed, %d timed out, %d crashed\n\n", completed, timedOut, crashed);
+
+  printf("%-16s %8s %8s %8s %8s %8s %8s\n", "", "mean", "sd", "p5", "p50", "p95", "max");
+  printSummary("position error", "cm from nominal", summarize(positionError));
+  printSummary("heading error", "deg from nominal", summarize(headingError));
+  printSummary("completion time", "s", summarize(duration));
+
+  if (positionError.size() > 2) {
+    printf("\ncorrelation with position error: radius %+.2f, battery %+.2f, traction %+.2f, "
+           "start offset %+.2f\n",
+           correlation(radius, positionError),
+           correlation(battery, positionError),
+           correlation(traction, positionError),
+           correlation(startOffset, positionError));
+  }
+
+  if (!options["--csv"].empty()) {
+    FILE *file = fopen(options["--csv"].c_str(), "w");
+    if (!file) {
+      perror(options["--csv"].c_str());
+      return 1;
+    }
+    fprintf(file, "sample,radius,battery,traction,noise,start_x,start_y,start_theta,status,"
+                  "duration,x,y,theta\n");
+    for (std::size_t i = 0; i < samples.size(); i++) {
+      const auto &params = samples[i].params;
+      const auto &result = samples[i].result;
+      fprintf(file,
+              "%zu,%.6f,%.3f,%.3f,%.3f,%.4f,%.4f,%.4f,%s,%.3f,%.4f,%.4f,%.4f\n",
+              i,
+              params.wheelRadius,
+              params.batteryVoltage,
+              params.traction,
+              params.encoderNoise,
+              params.startPose.x,
+              params.startPose.y,
+              params.startPose.theta,
+              result.status == Status::completed ? "completed"
+              : result.status == Status::timedOut ? "timed out"
+                                                  : "crashed",
+              result.durationMs / 1000,
+              result.pose.x,
+              result.pose.y,
+              result.pose.theta);
+    }
+    fclose(file);
+  }
+  return 0;
+}
@@ -0,0 +1,433 @@
+/*
+ * Host-side PID autotuner for ChassisControllerPID.
+ *
+ * Runs the same particle swarm as okapi::PIDTuner (inertia 0.5, self confidence 1.1, swarm
+ * confidence 1.2, cost = kSettle * settle time + kITAE * ITAE), but scores each particle against a
+ * SkidSteerSimulator instead of a physical move. Particles of one iteration are scored in parallel
+ * on a pool of worker threads, so swarms of hundreds of particles over dozens of iterations finish
+ * in seconds.
+ *
+ * The distance and angle controllers are tuned together on straight moves, since the angle
+ * controller only acts while driving straight. The turn controller is tuned on point turns. The
+ * result is printed as a `ChassisControllerBuilder::withGains` call.
+ *
+ * Usage: autotune [particles] [iterations] [max velocity rpm] [threads]
+ */
+#include "okapi/api/control/util/pidTuner.hpp"
+#include "skidSteerSimulator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using Output = okapi::PIDTuner::Output;
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double loopDelta = 0.010; // s, ChassisControllerPID's sample time
+
+/**
+ * The robot in main.cpp: 2.75 in tracking wheels 5.25 in apart with 360 tick encoders, on a
+ * simulated drive whose right side is slightly weaker than its left.
+ */
+constexpr double trackingDiameter = 0.06985; // m
+constexpr double trackingTrack = 0.13335;    // m
+constexpr double tpr = 360;
+constexpr double ticksPerMeter = tpr / (trackingDiameter * pi);
+constexpr double ticksPerDegree = trackingTrack / trackingDiameter * tpr / 360;
+
+void setupSim(SkidSteerSimulator &isim) {
+  isim.setTrackingWheels(trackingDiameter, trackingTrack, tpr);
+  isim.setTorqueScale(SkidSteerSimulator::right, 0.97);
+}
+
+/**
+ * SkidSteerModel::driveVector with velocity control.
+ */
+void driveVector(SkidSteerSimulator &isim, const double iforward, const double iyaw, const double imaxRpm) {
+  double left = iforward + iyaw;
+  double right = iforward - iyaw;
+  if (const double mag = std::max(std::abs(left), std::abs(right)); mag > 1) {
+    left /= mag;
+    right /= mag;
+  }
+  isim.setVelocity(SkidSteerSimulator::left, left * imaxRpm);
+  isim.setVelocity(SkidSteerSimulator::right, right * imaxRpm);
+}
+
+/**
+ * IterativePosPIDController's position form: integral and derivative gains are scaled by the
+ * sample time, the derivative acts on the measurement, and the integral resets when the error
+ * changes sign.
+ */
+class Pid {
+  public:
+  Pid(const Output &igains, const double itarget)
+    : kP(igains.kP), kI(igains.kI * loopDelta), kD(igains.kD / loopDelta), target(itarget) {
+  }
+
+  double step(const double ireading) {
+    const double error = target - ireading;
+    integral += kI * error;
+    if (std::copysign(1.0, error) != std::copysign(1.0, lastError)) {
+      integral = 0;
+    }
+    integral = std::clamp(integral, -1.0, 1.0);
+    const double derivative = first ? 0 : ireading - lastReading;
+    first = false;
+    lastReading = ireading;
+    lastError = error;
+    return std::clamp(kP * error + integral - kD * derivative, -1.0, 1.0);
+  }
+
+  protected:
+  double kP, kI, kD;
+  double target;
+  double integral{0};
+  double lastReading{0};
+  double lastError{0};
+  bool first{true};
+};
+
+/**
+ * SettledUtil's default rule: error within 50 ticks and changing by less than 5 ticks per sample
+ * for 250 ms.
+ */
+class Settled {
+  public:
+  bool isSettled(const double ierror, const double itime) {
+    const bool inBand = std::abs(ierror) < 50 && std::abs(ierror - lastError) < 5;
+    lastError = ierror;
+    if (!inBand) {
+      enteredAt = -1;
+      return false;
+    }
+    if (enteredAt < 0) {
+      enteredAt = itime;
+    }
+    return itime - enteredAt >= 0.250;
+  }
+
+  protected:
+  double lastError{0};
+  double enteredAt{-1};
+};
+
+struct Scoring {
+  double kSettle{1};
+  double kITAE{2};
+  double timeout{4.0}; // s
+};
+
+/**
+ * The cost of one move: the weighted sum of its settle time in s and its ITAE, the time-weighted
+ * absolute error the caller integrated as a fraction of the target. The callers pass twice the
+ * timeout as the settle time of a move which never settles.
+ */
+double moveCost(const Scoring &iscoring, const double isettleTime, const double iitae) {
+  return iscoring.kSettle * isettleTime + iscoring.kITAE * iitae;
+}
+
+double scoreDistance(const Scoring &iscoring,
+                     const double imaxRpm,
+                     const Output &idistance,
+                     const Output &iangle,
+                     const double imeters) {
+  SkidSteerSimulator sim;
+  setupSim(sim);
+  const double target = imeters * ticksPerMeter;
+  Pid distancePid(idistance, target);
+  Pid anglePid(iangle, 0);
+  Settled distanceSettled, angleSettled;
+
+  double itae = 0;
+  for (double t = 0; t < iscoring.timeout; t += loopDelta) {
+    const double left = sim.getTrackingTicks(SkidSteerSimulator::left);
+    const double right = sim.getTrackingTicks(SkidSteerSimulator::right);
+    const double distance = (left + right) / 2;
+    const double angle = left - right;
+    driveVector(sim, distancePid.step(distance), anglePid.step(angle), imaxRpm);
+
+    // Heading drift counts against the move as well
+    const double error = std::abs(target - distance) + std::abs(angle);
+    itae += t * error / std::abs(target) * loopDelta;
+
+    const bool distanceDone = distanceSettled.isSettled(target - distance, t);
+    const bool angleDone = angleSettled.isSettled(-angle, t);
+    if (distanceDone && angleDone) {
+      return moveCost(iscoring, t, itae);
+    }
+
+    sim.stepFor(loopDelta);
+  }
+  return moveCost(iscoring, 2 * iscoring.timeout, itae);
+}
+
+double scoreTurn(const Scoring &iscoring,
+                 const double imaxRpm,
+                 const Output &iturn,
+                 const double idegrees) {
+  SkidSteerSimulator sim;
+  setupSim(sim);
+  const double target = idegrees * ticksPerDegree;
+  Pid turnPid(iturn, target);
+  Settled settled;
+
+  double itae = 0;
+  for (double t = 0; t < iscoring.timeout; t += loopDelta) {
+    const double angle = (sim.getTrackingTicks(SkidSteerSimulator::left) -
+                          sim.getTrackingTicks(SkidSteerSimulator::right)) /
+                         2.0;
+    driveVector(sim, 0, turnPid.step(angle), imaxRpm);
+
+    itae += t * std::abs(target - angle) / std::abs(target) * loopDelta;
+
+    if (settled.isSettled(target - angle, t)) {
+      return moveCost(iscoring, t, itae);
+    }
+
+    sim.stepFor(loopDelta);
+  }
+  return moveCost(iscoring, 2 * iscoring.timeout, itae);
+}
+
+/**
+ * okapi::PIDTuner's particle swarm over any number of gain sets at once, with the particles of
+ * each iteration scored in parallel. Each particle is seeded independently, so results do not
+ * depend on the number of threads.
+ */
+class ParallelPIDTuner {
+  public:
+  struct Bounds {
+    Output min, max;
+  };
+
+  using CostFunction = std::function<double(const std::vector<Output> &)>;
+
+  ParallelPIDTuner(std::vector<Bounds> ibounds,
+                   CostFunction icost,
+                   const std::size_t inumIterations,
+                   const std::size_t inumParticles,
+                   const std::size_t inumThreads,
+                   const unsigned iseed = 1)
+    : bounds(std::move(ibounds)),
+      cost(std::move(icost)),
+      numIterations(inumIterations),
+      numParticles(inumParticles),
+      numThreads(std::max<std::size_t>(1, inumThreads)),
+      seed(iseed) {
+  }
+
+  /**
+   * Runs the swarm and returns the best gain sets found, in the order of the bounds.
+   */
+  std::vector<Output> autotune() {
+    const std::size_t dims = bounds.size() * 3;
+    std::vector<double> lower, upper;
+    for (const auto &bound : bounds) {
+      lower.insert(lower.end(), {bound.min.kP, bound.min.kI, bound.min.kD});
+      upper.insert(upper.end(), {bound.max.kP, bound.max.kI, bound.max.kD});
+    }
+
+    std::vector<Particle> particles(numParticles);
+    for (std::size_t i = 0; i < numParticles; i++) {
+      auto &particle = particles[i];
+      particle.rng.seed(seed * 7919 + i);
+      std::uniform_real_distribution<double> unit(0, 1);
+      particle.pos.resize(dims);
+      particle.vel.assign(dims, 0);
+      for (std::size_t d = 0; d < dims; d++) {
+        particle.pos[d] = lower[d] + unit(particle.rng) * (upper[d] - lower[d]);
+      }
+      particle.best = particle.pos;
+    }
+
+    std::vector<double> globalBest = particles[0].pos;
+    double globalBestCost = std::numeric_limits<double>::infinity();
+
+    for (std::size_t iteration = 0; iteration < numIterations; iteration++) {
+      scoreAll(particles);
+
+      for (auto &particle : particles) {
+        if (particle.cost < particle.bestCost) {
+          particle.bestCost = particle.cost;
+          particle.best = particle.pos;
+        }
+        if (particle.cost < globalBestCost) {
+          globalBestCost = particle.cost;
+          globalBest = particle.pos;
+        }
+      }
+
+      printf("iteration %2zu/%zu  best cost %.4f\n", iteration + 1, numIterations, globalBestCost);
+
+      for (auto &particle : particles) {
+        std::uniform_real_distribution<double> unit(0, 1);
+        for (std::size_t d = 0; d < dims; d++) {
+          particle.vel[d] = inertia * particle.vel[d] +
+                            confSelf * unit(particle.rng) * (particle.best[d] - particle.pos[d]) +
+                            confSwarm * unit(particle.rng) * (globalBest[d] - particle.pos[d]);
+          particle.pos[d] = std::clamp(particle.pos[d] + particle.vel[d], lower[d], upper[d]);
+        }
+      }
+    }
+
+    bestCost = globalBestCost;
+    return toGains(globalBest);
+  }
+
+  /**
+   * @return The cost of the gains returned by the last call to `autotune()`.
+   */
+  double getBestCost() const {
+    return bestCost;
+  }
+
+  protected:
+  static constexpr double inertia = 0.5;
+  static constexpr double confSelf = 1.1;
+  static constexpr double confSwarm = 1.2;
+
+  struct Particle {
+    std::vector<double> pos, vel, best;
+    double cost{0};
+    double bestCost{std::numeric_limits<double>::infinity()};
+    std::mt19937 rng;
+  };
+
+  std::vector<Bounds> bounds;
+  CostFunction cost;
+  std::size_t numIterations;
+  std::size_t numParticles;
+  std::size_t numThreads;
+  unsigned seed;
+  double bestCost{0};
+
+  std::vector<Output> toGains(const std::vector<double> &ipos) const {
+    std::vector<Output> gains;
+    for (std::size_t i = 0; i < bounds.size(); i++) {
+      gains.push_back({ipos[i * 3], ipos[i * 3 + 1], ipos[i * 3 + 2]});
+    }
+    return gains;
+  }
+
+  void scoreAll(std::vector<Particle> &iparticles) const {
+    std::atomic_size_t next{0};
+    auto worker = [&]() {
+      for (std::size_t i = next++; i < iparticles.size(); i = next++) {
+        iparticles[i].cost = cost(toGains(iparticles[i].pos));
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < numThreads; i++) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : pool) {
+      thread.join();
+    }
+  }
+};
+
+/**
+ * Reads argument iindex into iovalue, which holds the default for when it wasn't passed.
+ *
+ * @param iwhole Whether the argument must be a whole number, e.x. a count.
+ * @return Whether the argument was a positive number, with nothing after it.
+ */
+bool readArg(const int argc, char *argv[], const int iindex, const bool iwhole, double &iovalue) {
+  if (argc <= iindex) {
+    return true;
+  }
+  std::size_t used = 0;
+  try {
+    iovalue = std::stod(argv[iindex], &used);
+  } catch (const std::logic_error &) {
+    // std::invalid_argument for no number, std::out_of_range for one too large
+    return false;
+  }
+  return argv[iindex][used] == '\0' && iovalue > 0 && (!iwhole || iovalue == std::floor(iovalue));
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  double particleArg = 256;
+  double iterationArg = 30;
+  double maxRpm = 200;
+  double threadArg = std::max(1u, std::thread::hardware_concurrency());
+  if (!readArg(argc, argv, 1, true, particleArg) || !readArg(argc, argv, 2, true, iterationArg) ||
+      !readArg(argc, argv, 3, false, maxRpm) || !readArg(argc, argv, 4, true, threadArg)) {
+    fprintf(stderr, "particles, iterations and threads must be whole numbers above 0, and max ");
+    fprintf(stderr, "velocity a number above 0\n");
+    fprintf(stderr, "usage: %s [particles] [iterations] [max velocity rpm] [threads]\n", argv[0]);
+    return 2;
+  }
+  const auto particles = static_cast<std::size_t>(particleArg);
+  const auto iterations = static_cast<std::size_t>(iterationArg);
+  const auto threads = static_cast<std::size_t>(threadArg);
+
+  const Scoring scoring;
+  const std::vector<double> distances{0.3, 0.6, 1.2};
+  const std::vector<double> angles{45, 90, 180};
+
+  printf("distance and angle controllers, %zu particles x %zu iterations on %zu threads\n",
+         particles,
+         iterations,
+         threads);
+  ParallelPIDTuner straight(
+    {{{0, 0, 0}, {0.02, 0.0005, 0.002}}, {{0, 0, 0}, {0.01, 0.0005, 0.001}}},
+    [&](const std::vector<Output> &igains) {
+      double total = 0;
+      for (const double meters : distances) {
+        total += scoreDistance(scoring, maxRpm, igains[0], igains[1], meters);
+      }
+      return total / distances.size();
+    },
+    iterations,
+    particles,
+    threads);
+  const auto straightGains = straight.autotune();
+
+  printf("\nturn controller\n");
+  ParallelPIDTuner turn(
+    {{{0, 0, 0}, {0.04, 0.001, 0.004}}},
+    [&](const std::vector<Output> &igains) {
+      double total = 0;
+      for (const double degrees : angles) {
+        total += scoreTurn(scoring, maxRpm, igains[0], degrees);
+      }
+      return total / angles.size();
+    },
+    iterations,
+    particles,
+    threads);
+  const auto turnGains = turn.autotune();
+
+  const Output &distance = straightGains[0];
+  const Output &angle = straightGains[1];
+  const Output &turnOut = turnGains[0];
+  printf("\ncost: straight %.4f, turn %.4f\n", straight.getBestCost(), turn.getBestCost());
+  printf("\n.withGains(\n"
+         "    {%.6g, %.6g, %.6g}, // distance controller gains\n"
+         "    {%.6g, %.6g, %.6g}, // turn controller gains\n"
+         "    {%.6g, %.6g, %.6g}  // angle controller gains (helps drive straight)\n"
+         ")\n",
+         distance.kP,
+         distance.kI,
+         distance.kD,
+         turnOut.kP,
+         turnOut.kI,
+         turnOut.kD,
+         angle.kP,
+         angle.kI,
+         angle.kD);
+  return 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * Host-side fitter for drivetrain characterization logs.
+ *
+ * Reads the CSV written by DriveCharacterizer::save (`time_ms,test,volts,left_m,right_m`),
+ * differentiates each side's position into velocity and acceleration, and fits
+ *
+ *   volts = kS * sgn(v) + kV * v + kA * a
+ *
+ * per side with ordinary least squares over all tests. The constants are printed in the units
+ * FeedbackMotionProfileController::Gains uses (V, V/(m/s), V/(m/s^2)).
+ *
+ * Usage: characterize <characterization.csv> [min velocity m/s]
+ */
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+struct Row {
+  double time;
+  std::string test;
+  double volts;
+  std::array<double, 2> pos;
+};
+
+struct Fit {
+  double kS{0};
+  double kV{0};
+  double kA{0};
+  double rSquared{0};
+  std::size_t samples{0};
+};
+
+std::vector<Row> readLog(std::istream &input) {
+  std::vector<Row> rows;
+  std::string line;
+  std::getline(input, line); // header
+  for (std::size_t lineNumber = 2; std::getline(input, line); lineNumber++) {
+    std::istringstream fields(line);
+    std::string time, test, volts, left, right;
+    if (std::getline(fields, time, ',') && std::getline(fields, test, ',') &&
+        std::getline(fields, volts, ',') && std::getline(fields, left, ',') &&
+        std::getline(fields, right)) {
+      try {
+        rows.push_back(
+          {std::stod(time) / 1000.0, test, std::stod(volts), {std::stod(left), std::stod(right)}});
+      } catch (const std::logic_error &) {
+        // e.x. a second header from logs joined together
+        std::cerr << "line " << lineNumber << ": skipped, not a sample: " << line << std::endl;
+      }
+    }
+  }
+  return rows;
+}
+
+/**
+ * Solves the 3x3 system `a * x = b` by Gaussian elimination with partial pivoting. Returns false
+ * if the system is singular (e.x. no step test, so acceleration is never excited).
+ */
+bool solve3(std::array<std::array<double, 3>, 3> a, std::array<double, 3> b, std::array<double, 3> &x) {
+  for (int col = 0; col < 3; col++) {
+    int pivot = col;
+    for (int row = col + 1; row < 3; row++) {
+      if (std::abs(a[row][col]) > std::abs(a[pivot][col])) {
+        pivot = row;
+      }
+    }
+    if (std::abs(a[pivot][col]) < 1e-12) {
+      return false;
+    }
+    std::swap(a[col], a[pivot]);
+    std::swap(b[col], b[pivot]);
+    for (int row = col + 1; row < 3; row++) {
+      const double factor = a[row][col] / a[col][col];
+      for (int k = col; k < 3; k++) {
+        a[row][k] -= factor * a[col][k];
+      }
+      b[row] -= factor * b[col];
+    }
+  }
+  for (int row = 2; row >= 0; row--) {
+    double sum = b[row];
+    for (int k = row + 1; k < 3; k++) {
+      sum -= a[row][k] * x[k];
+    }
+    x[row] = sum / a[row][row];
+  }
+  return true;
+}
+
+/**
+ * Fits one side. Velocity and acceleration come from central differences within each test, so
+ * the first and last two samples of every test are skipped.
+ */
+bool fitSide(const std::vector<Row> &rows, const int side, const double minVel, Fit &fit) {
+  std::array<std::array<double, 3>, 3> ata{};
+  std::array<double, 3> atb{};
+  std::vector<std::array<double, 4>> used; // sgn, v, a, volts
+
+  for (std::size_t i = 2; i + 2 < rows.size(); i++) {
+    if (rows[i - 2].test != rows[i].test || rows[i + 2].test != rows[i].test) {
+      continue;
+    }
+
+    const double dtV = rows[i + 1].time - rows[i - 1].time;
+    const double dtA = (rows[i + 2].time - rows[i - 2].time) / 2;
+    if (dtV <= 0 || dtA <= 0) {
+      continue;
+    }
+
+    const double vel = (rows[i + 1].pos[side] - rows[i - 1].pos[side]) / dtV;
+    const double velAhead = (rows[i + 2].pos[side] - rows[i].pos[side]) /
+                            (rows[i + 2].time - rows[i].time);
+    const double velBehind = (rows[i].pos[side] - rows[i - 2].pos[side]) /
+                             (rows[i].time - rows[i - 2].time);
+    const double accel = (velAhead - velBehind) / dtA;
+
+    // Samples at rest only say the voltage was below kS
+    if (std::abs(vel) < minVel) {
+      continue;
+    }
+
+    const std::array<double, 3> features{vel > 0 ? 1.0 : -1.0, vel, accel};
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) {
+        ata[r][c] += features[r] * features[c];
+      }
+      atb[r] += features[r] * rows[i].volts;
+    }
+    used.push_back({features[0], features[1], features[2], rows[i].volts});
+  }
+
+  std::array<double, 3> x{};
+  if (used.size() < 3 || !solve3(ata, atb, x)) {
+    return false;
+  }
+
+  double mean = 0;
+  for (const auto &sample : used) {
+    mean += sample[3];
+  }
+  mean /= used.size();
+
+  double residual = 0, total = 0;
+  for (const auto &sample : used) {
+    const double predicted = x[0] * sample[0] + x[1] * sample[1] + x[2] * sample[2];
+    residual += (sample[3] - predicted) * (sample[3] - predicted);
+    total += (sample[3] - mean) * (sample[3] - mean);
+  }
+
+  fit.kS = x[0];
+  fit.kV = x[1];
+  fit.kA = x[2];
+  fit.rSquared = total > 0 ? 1 - residual / total : 0;
+  fit.samples = used.size();
+  return true;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <characterization.csv> [min velocity m/s]" << std::endl;
+    return 2;
+  }
+
+  std::ifstream input(argv[1]);
+  if (!input) {
+    std::cerr << "cannot open " << argv[1] << std::endl;
+    return 2;
+  }
+
+  double minVel = 0.02;
+  if (argc > 2) {
+    try {
+      minVel = std::stod(argv[2]);
+    } catch (const std::logic_error &) {
+      // std::invalid_argument for no number, std::out_of_range for one too large
+      std::cerr << "min velocity must be a number, not " << argv[2] << std::endl;
+      std::cerr << "usage: " << argv[0] << " <characterization.csv> [min velocity m/s]" << std::endl;
+      return 2;
+    }
+  }
+  const auto rows = readLog(input);
+
+  const char *const sides[] = {"left", "right"};
+  std::array<Fit, 2> fits;
+  for (int side = 0; side < 2; side++) {
+    if (!fitSide(rows, side, minVel, fits[side])) {
+      std::cerr << sides[side]
+                << ": not enough moving samples to fit (run both quasi-static and step tests)"
+                << std::endl;
+      return 1;
+    }
+    printf("%-5s kS %.4f V  kV %.4f V/(m/s)  kA %.4f V/(m/s^2)  r^2 %.4f  (%zu samples)\n",
+           sides[side],
+           fits[side].kS,
+           fits[side].kV,
+           fits[side].kA,
+           fits[side].rSquared,
+           fits[side].samples);
+  }
+
+  printf("\nFeedbackMotionProfileController::Gains, both sides averaged:\n"
+         "  kS %.4f, kV %.4f, kA %.4f\n",
+         (fits[0].kS + fits[1].kS) / 2,
+         (fits[0].kV + fits[1].kV) / 2,
+         (fits[0].kA + fits[1].kA) / 2);
+  return 0;
+}
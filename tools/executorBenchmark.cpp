@@ -0,0 +1,273 @@
+/*
+ * Measures how long a sensor reading takes to reach the motors through odometry and a controller,
+ * run two ways:
+ *  - a task per stage, as okapi runs them: an odometry task and a controller task, each on a 10 ms
+ *    loop of its own started at an unrelated time, passing the pose between them under a lock,
+ *  - a ControllerExecutor running sense, estimate, control and actuate steps in order on one
+ *    10 ms tick.
+ *
+ * The sensor publishes a reading every 10 ms at a phase of its own, as a V5 motor does. Latency is
+ * from a reading being published to the motor write computed from it, so it includes the time the
+ * reading waited to be read. What the task-per-stage design pays depends on how the tasks' phases
+ * fall, so each trial starts every loop at a new random phase. The stages' own work is a few
+ * multiplications; the difference is the waiting between them.
+ *
+ * Usage: executorBenchmark [trials] [ms per trial]
+ */
+#include "controllerExecutor.hpp"
+#include "microClock.hpp"
+#include "timingStats.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace okapi;
+
+namespace {
+constexpr std::uint64_t periodUs = 10000;
+
+class SteadyTimer : public AbstractTimer {
+  public:
+  SteadyTimer() : AbstractTimer(now()) {
+  }
+
+  QTime millis() const override {
+    return now();
+  }
+
+  static QTime now() {
+    return microClock() / 1000.0 * millisecond;
+  }
+};
+
+/**
+ * Wakes on a fixed schedule, as `Task::delay_until` does.
+ */
+class SteadyRate : public AbstractRate {
+  public:
+  void delay(const QFrequency ihz) override {
+    delayUntil(static_cast<std::uint32_t>(1000 / ihz.convert(Hz)));
+  }
+
+  void delayUntil(const QTime itime) override {
+    delayUntil(static_cast<std::uint32_t>(itime.convert(millisecond)));
+  }
+
+  void delayUntil(const uint32_t ims) override {
+    last += std::chrono::milliseconds(ims);
+    std::this_thread::sleep_until(last);
+  }
+
+  protected:
+  std::chrono::steady_clock::time_point last{std::chrono::steady_clock::now()};
+};
+
+void sleepUntilUs(const std::uint64_t ius) {
+  const std::uint64_t now = microClock();
+  if (ius > now) {
+    std::this_thread::sleep_for(std::chrono::microseconds(ius - now));
+  }
+}
+
+/**
+ * Runs the body every 10 ms from `istartUs` until `idone` is set.
+ */
+template <typename F>
+void every10ms(const std::uint64_t istartUs, const std::atomic_bool &idone, F ibody) {
+  for (std::uint64_t wake = istartUs; !idone; wake += periodUs) {
+    sleepUntilUs(wake);
+    ibody();
+  }
+}
+
+struct Reading {
+  double value{0};
+  std::uint64_t publishedUs{0};
+};
+
+/**
+ * A sensor which publishes a new reading every 10 ms.
+ */
+class Sensor {
+  public:
+  void run(const std::uint64_t istartUs, const std::atomic_bool &idone) {
+    double value = 0;
+    every10ms(istartUs, idone, [&] {
+      value += 1;
+      std::lock_guard<std::mutex> guard(lock);
+      latest = Reading{value, microClock()};
+    });
+  }
+
+  Reading read() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return latest;
+  }
+
+  protected:
+  mutable std::mutex lock;
+  Reading latest;
+};
+
+/**
+ * The odometry stage: integrates readings into a position, carrying the newest reading's time.
+ */
+struct Odometry {
+  double position{0};
+  std::uint64_t publishedUs{0};
+
+  void step(const Reading &ireading) {
+    position = 0.9 * position + 0.1 * ireading.value;
+    publishedUs = ireading.publishedUs;
+  }
+};
+
+double control(const double iposition) {
+  return 0.5 * (1000 - iposition);
+}
+
+/**
+ * The motor write, which records how old the reading behind it is.
+ */
+void actuate(TimingStats &olatency,
+             volatile double &omotor,
+             const double ioutput,
+             const std::uint64_t ipublishedUs) {
+  omotor = ioutput;
+  if (ipublishedUs != 0) {
+    olatency.add(static_cast<std::uint32_t>(microClock() - ipublishedUs));
+  }
+}
+
+void taskPerStage(const std::uint64_t itrialMs, std::mt19937 &irandom, TimingStats &olatency) {
+  std::uniform_int_distribution<std::uint64_t> phase(0, periodUs - 1);
+  Sensor sensor;
+  std::mutex poseLock;
+  Odometry odometry;
+  volatile double motor = 0;
+  std::atomic_bool done{false};
+
+  const std::uint64_t start = microClock() + 2000;
+  const std::uint64_t odometryStart = start + phase(irandom);
+  const std::uint64_t controllerStart = start + phase(irandom);
+  std::thread sensorTask([&] { sensor.run(start, done); });
+  std::thread odometryTask([&] {
+    every10ms(odometryStart, done, [&] {
+      const Reading reading = sensor.read();
+      std::lock_guard<std::mutex> guard(poseLock);
+      odometry.step(reading);
+    });
+  });
+  std::thread controllerTask([&] {
+    every10ms(controllerStart, done, [&] {
+      Odometry pose;
+      {
+        std::lock_guard<std::mutex> guard(poseLock);
+        pose = odometry;
+      }
+      actuate(olatency, motor, control(pose.position), pose.publishedUs);
+    });
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(itrialMs));
+  done = true;
+  sensorTask.join();
+  odometryTask.join();
+  controllerTask.join();
+}
+
+void executor(const TimeUtil &itimeUtil,
+              const std::uint64_t itrialMs,
+              std::mt19937 &irandom,
+              TimingStats &olatency) {
+  std::uniform_int_distribution<std::uint64_t> phase(0, periodUs - 1);
+  Sensor sensor;
+  Reading reading;
+  Odometry odometry;
+  double output = 0;
+  volatile double motor = 0;
+  std::atomic_bool done{false};
+
+  ControllerExecutor steps(itimeUtil);
+  steps.add("sensor", ControllerExecutor::Stage::sense, 10_ms, [&] { reading = sensor.read(); });
+  steps.add("odometry", ControllerExecutor::Stage::estimate, 10_ms, [&] {
+    odometry.step(reading);
+  });
+  steps.add("controller", ControllerExecutor::Stage::control, 10_ms, [&] {
+    output = control(odometry.position);
+  });
+  steps.add("motor", ControllerExecutor::Stage::actuate, 10_ms, [&] {
+    actuate(olatency, motor, output, odometry.publishedUs);
+  });
+
+  const std::uint64_t start = microClock() + 2000;
+  std::thread sensorTask([&] { sensor.run(start, done); });
+  sleepUntilUs(start + phase(irandom));
+  const std::uint64_t began = microClock();
+  steps.start();
+
+  sleepUntilUs(began + itrialMs * 1000);
+  steps.stop();
+  done = true;
+  sensorTask.join();
+}
+
+void printRow(const char *iname, const TimingStats &istats) {
+  printf("  %-16s %8.0f %8lu %8lu %10lu\n",
+         iname,
+         istats.getMean(),
+         static_cast<unsigned long>(istats.getPercentile(0.99)),
+         static_cast<unsigned long>(istats.getMax()),
+         static_cast<unsigned long>(istats.getOverLimit()));
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::size_t trials = 10;
+  std::uint64_t trialMs = 500;
+  try {
+    if (argc > 1) {
+      trials = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+      trialMs = std::stoul(argv[2]);
+    }
+  } catch (const std::logic_error &) {
+    // std::invalid_argument for no number, std::out_of_range for one too large
+    fprintf(stderr, "trials and ms per trial must be numbers\n");
+    fprintf(stderr, "usage: %s [trials] [ms per trial]\n", argv[0]);
+    return 2;
+  }
+
+  const TimeUtil timeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<SteadyTimer>(); }),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<SteadyRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>(
+      []() { return std::make_unique<SettledUtil>(std::make_unique<SteadyTimer>()); }));
+
+  std::mt19937 random(1);
+  TimingStats tasks(periodUs);
+  TimingStats executed(periodUs);
+  for (std::size_t trial = 0; trial < trials; trial++) {
+    taskPerStage(trialMs, random, tasks);
+    executor(timeUtil, trialMs, random, executed);
+  }
+
+  printf("%zu trials of %lu ms, a reading every 10 ms\n",
+         trials,
+         static_cast<unsigned long>(trialMs));
+  printf("sensor to motor:   mean us   p99 us   max us  over 10 ms\n");
+  printRow("task per stage", tasks);
+  printRow("executor", executed);
+  printf("The executor saves %.0f us on average; both wait up to a period for the reading.\n",
+         tasks.getMean() - executed.getMean());
+
+  const bool ok = tasks.getCount() > 0 && executed.getCount() > 0;
+  printf("%s\n", ok ? "OK" : "FAILED: a design never reached the motor");
+  return ok ? 0 : 1;
+}
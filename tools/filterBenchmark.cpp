@@ -0,0 +1,206 @@
+/*
+ * Benchmarks the project's filters against okapi's on a noisy potentiometer-like signal (a slow
+ * sine with Gaussian noise and occasional spikes), and checks that they produce the same output.
+ *
+ *  - median: okapi::MedianFilter<n> against SlidingMedianFilter<n>, for windows of 5 to 101
+ *  - average: okapi::AverageFilter<n> against RunningAverageFilter<n>, for windows of 5 to 101
+ *  - batch: 8 channels through 8 okapi filters, one virtual call each, against one batch filter.
+ *    The batch filters run in single precision, so their outputs are compared within a tolerance.
+ *
+ * Usage: filterBenchmark [readings]
+ */
+#include "batchFilter.hpp"
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/demaFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "runningAverageFilter.hpp"
+#include "slidingMedianFilter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+std::vector<double> makeSignal(const std::size_t icount) {
+  std::mt19937 random(1);
+  std::normal_distribution<double> noise(0, 8);
+  std::uniform_real_distribution<double> spike(0, 1);
+  std::vector<double> signal(icount);
+  for (std::size_t i = 0; i < icount; i++) {
+    signal[i] = 1500 + 400 * std::sin(i * 0.002) + noise(random);
+    if (spike(random) < 0.01) {
+      signal[i] += 600;
+    }
+  }
+  return signal;
+}
+
+/**
+ * Runs the signal through a fresh filter.
+ *
+ * @return ns per reading
+ */
+template <typename F>
+double time(const std::vector<double> &isignal, std::vector<double> &ooutput) {
+  F filter;
+  ooutput.resize(isignal.size());
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < isignal.size(); i++) {
+    ooutput[i] = filter.filter(isignal[i]);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / isignal.size();
+}
+
+template <std::size_t n> bool benchmarkMedian(const std::vector<double> &isignal) {
+  std::vector<double> okapiOut, slidingOut;
+  const double okapiNs = time<MedianFilter<n>>(isignal, okapiOut);
+  const double slidingNs = time<SlidingMedianFilter<n>>(isignal, slidingOut);
+  const bool same = okapiOut == slidingOut;
+  printf("  %4zu %12.1f %12.1f %8.1fx  %s\n",
+         n,
+         okapiNs,
+         slidingNs,
+         okapiNs / slidingNs,
+         same ? "same" : "DIFFERENT");
+  return same;
+}
+
+template <std::size_t n> bool benchmarkAverage(const std::vector<double> &isignal) {
+  std::vector<double> okapiOut, runningOut;
+  const double okapiNs = time<AverageFilter<n>>(isignal, okapiOut);
+  const double runningNs = time<RunningAverageFilter<n>>(isignal, runningOut);
+  double worst = 0;
+  for (std::size_t i = 0; i < isignal.size(); i++) {
+    worst = std::max(worst, std::abs(okapiOut[i] - runningOut[i]));
+  }
+  const bool same = worst < 1e-9;
+  printf("  %4zu %12.1f %12.1f %8.1fx  max difference %.2g\n",
+         n,
+         okapiNs,
+         runningNs,
+         okapiNs / runningNs,
+         worst);
+  return same;
+}
+
+constexpr std::size_t channels = 8;
+constexpr double signalScale = 2000; // roughly the signal's largest reading
+
+/**
+ * Runs every channel (the signal, offset by 37 readings per channel) through one okapi filter
+ * each, then through a batch filter.
+ *
+ * @return whether they agreed to within `itolerance` of the signal's scale
+ */
+template <typename B>
+bool benchmarkBatch(const char *iname,
+                    const std::vector<double> &isignal,
+                    const std::function<std::unique_ptr<Filter>()> &imakeFilter,
+                    B ibatch,
+                    const double itolerance) {
+  const std::size_t ticks = isignal.size() - channels * 37;
+  std::vector<std::unique_ptr<Filter>> filters;
+  for (std::size_t c = 0; c < channels; c++) {
+    filters.push_back(imakeFilter());
+  }
+
+  std::vector<double> okapiOut(ticks * channels);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t t = 0; t < ticks; t++) {
+    for (std::size_t c = 0; c < channels; c++) {
+      okapiOut[t * channels + c] = filters[c]->filter(isignal[t + c * 37]);
+    }
+  }
+  const double okapiNs =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<float> batchOut(ticks * channels);
+  ChannelArray<channels> readings;
+  start = std::chrono::steady_clock::now();
+  for (std::size_t t = 0; t < ticks; t++) {
+    for (std::size_t c = 0; c < channels; c++) {
+      readings[c] = static_cast<float>(isignal[t + c * 37]);
+    }
+    const auto &out = ibatch.filter(readings);
+    std::copy(out.begin(), out.end(), batchOut.begin() + t * channels);
+  }
+  const double batchNs =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  double worst = 0;
+  for (std::size_t i = 0; i < okapiOut.size(); i++) {
+    worst = std::max(worst, std::abs(okapiOut[i] - batchOut[i]) / signalScale);
+  }
+  printf("  %-12s %12.1f %12.1f %8.1fx  max relative difference %.2g\n",
+         iname,
+         okapiNs / ticks,
+         batchNs / ticks,
+         okapiNs / batchNs,
+         worst);
+  return worst < itolerance;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const std::size_t readings = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  const auto signal = makeSignal(readings);
+  printf("%zu readings, ns per reading\n", readings);
+
+  printf("\nMedian\n  %4s %12s %12s %9s\n", "n", "okapi", "sliding", "speedup");
+  bool ok = benchmarkMedian<5>(signal);
+  ok &= benchmarkMedian<11>(signal);
+  ok &= benchmarkMedian<21>(signal);
+  ok &= benchmarkMedian<31>(signal);
+  ok &= benchmarkMedian<51>(signal);
+  ok &= benchmarkMedian<75>(signal);
+  ok &= benchmarkMedian<101>(signal);
+
+  printf("\nAverage\n  %4s %12s %12s %9s\n", "n", "okapi", "running", "speedup");
+  ok &= benchmarkAverage<5>(signal);
+  ok &= benchmarkAverage<11>(signal);
+  ok &= benchmarkAverage<21>(signal);
+  ok &= benchmarkAverage<51>(signal);
+  ok &= benchmarkAverage<101>(signal);
+
+  printf("\nBatch of %zu channels, ns per tick\n  %-12s %12s %12s %9s\n",
+         channels,
+         "filter",
+         "okapi",
+         "batch",
+         "speedup");
+  ok &= benchmarkBatch(
+    "ema",
+    signal,
+    [] { return std::make_unique<EmaFilter>(0.3); },
+    BatchEmaFilter<channels>(0.3f),
+    1e-5);
+  ok &= benchmarkBatch(
+    "dema",
+    signal,
+    [] { return std::make_unique<DemaFilter>(0.3, 0.1); },
+    BatchDemaFilter<channels>(0.3f, 0.1f),
+    1e-5);
+  ok &= benchmarkBatch(
+    "average<9>",
+    signal,
+    [] { return std::make_unique<AverageFilter<9>>(); },
+    BatchAverageFilter<channels, 9>(),
+    1e-5);
+  ok &= benchmarkBatch(
+    "median<5>",
+    signal,
+    [] { return std::make_unique<MedianFilter<5>>(); },
+    BatchMedianFilter<channels, 5>(),
+    1e-5);
+
+  return ok ? 0 : 1;
+}
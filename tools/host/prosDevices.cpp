@@ -0,0 +1,1231 @@
+/*
+ * Host implementation of the PROS device API (pros/motors.h, pros/adi.h, pros/misc.h,
+ * pros/llemu.h and their C++ classes) on SimulatedRobot. Ports keep the state the V5 keeps for
+ * them, such as reversal, encoder units and zero positions, and every call counts as a poll of
+ * VirtualClock, so busy-waits on a sensor cost simulated time as they do on the robot.
+ *
+ * No field is simulated: controllers read as idle and ultrasonics see nothing in range.
+ */
+#include "pros/adi.hpp"
+#include "pros/llemu.hpp"
+#include "pros/misc.hpp"
+#include "pros/motors.hpp"
+#include "sdCard.hpp"
+#include "simulatedRobot.hpp"
+#include "virtualClock.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+namespace {
+using namespace pros;
+
+constexpr std::uint8_t motorPorts = 21;
+constexpr std::uint8_t adiPorts = 8;
+
+struct MotorPort {
+  bool reversed{false};
+  motor_gearset_e_t gearset{E_MOTOR_GEARSET_18};
+  motor_encoder_units_e_t units{E_MOTOR_ENCODER_DEGREES};
+  motor_brake_mode_e_t brake{E_MOTOR_BRAKE_COAST};
+  double zero{0};           // degrees
+  double targetPosition{0}; // degrees from zero
+  std::int32_t targetVelocity{0};
+  std::int32_t currentLimit{2500};
+  std::int32_t voltageLimit{0};
+  motor_pid_full_s_t posPid{};
+  motor_pid_full_s_t velPid{};
+};
+
+struct AdiPort {
+  adi_port_config_e_t config{E_ADI_TYPE_UNDEFINED};
+  std::int32_t value{0}; // outputs
+  std::int32_t calibration{0};
+  bool lastPressed{false};
+  bool reversed{false};  // encoders
+  double zero{0};        // encoder ticks or gyro degrees
+  double multiplier{1};  // gyros
+};
+
+std::array<MotorPort, motorPorts + 1> motors;
+std::array<AdiPort, adiPorts + 1> adi;
+std::array<std::string, 8> lcdLines;
+bool lcdInitialized = false;
+
+SimulatedRobot &robot() {
+  VirtualClock::get().poll();
+  return SimulatedRobot::get();
+}
+
+bool isMotorPort(const std::uint8_t iport) {
+  if (iport < 1 || iport > motorPorts) {
+    errno = ENXIO;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @return An ADI port from 1 to 8, given 1 to 8, 'a' to 'h' or 'A' to 'H', or 0.
+ */
+std::uint8_t toAdiPort(const std::uint8_t iport) {
+  std::uint8_t port = iport;
+  if (iport >= 'a' && iport <= 'h') {
+    port = iport - 'a' + 1;
+  } else if (iport >= 'A' && iport <= 'H') {
+    port = iport - 'A' + 1;
+  }
+  if (port < 1 || port > adiPorts) {
+    errno = ENXIO;
+    return 0;
+  }
+  return port;
+}
+
+double sign(const std::uint8_t iport) {
+  return motors[iport].reversed ? -1 : 1;
+}
+
+double maxRpm(const std::uint8_t iport) {
+  switch (motors[iport].gearset) {
+  case E_MOTOR_GEARSET_36:
+    return 100;
+  case E_MOTOR_GEARSET_06:
+    return 600;
+  default:
+    return 200;
+  }
+}
+
+/**
+ * @return Degrees per encoder unit.
+ */
+double unitScale(const std::uint8_t iport) {
+  switch (motors[iport].units) {
+  case E_MOTOR_ENCODER_ROTATIONS:
+    return 360;
+  case E_MOTOR_ENCODER_COUNTS:
+    return 360 / (maxRpm(iport) == 100 ? 1800.0 : maxRpm(iport) == 600 ? 300.0 : 900.0);
+  default:
+    return 1;
+  }
+}
+
+/**
+ * @return The position in degrees after reversal, before the zero position.
+ */
+double rawDegrees(const std::uint8_t iport) {
+  return sign(iport) * robot().getPosition(iport);
+}
+
+double limitVolts(const std::uint8_t iport, const double ivolts) {
+  const double limit = motors[iport].voltageLimit > 0 ? motors[iport].voltageLimit / 1000.0 : 12;
+  return std::clamp(ivolts, -limit, limit);
+}
+} // namespace
+
+namespace pros {
+namespace c {
+std::int32_t motor_move(std::uint8_t port, std::int32_t voltage) {
+  return motor_move_voltage(port, std::clamp(voltage, -127, 127) * 12000 / 127);
+}
+
+std::int32_t motor_move_absolute(std::uint8_t port, const double position, const std::int32_t velocity) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  auto &motor = motors[port];
+  motor.targetPosition = position * unitScale(port);
+  motor.targetVelocity = velocity;
+  robot().setPosition(port,
+                      sign(port) * (motor.targetPosition + motor.zero),
+                      std::min<double>(std::abs(velocity), maxRpm(port)));
+  return 1;
+}
+
+std::int32_t motor_move_relative(std::uint8_t port, const double position, const std::int32_t velocity) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return motor_move_absolute(
+    port, motors[port].targetPosition / unitScale(port) + position, velocity);
+}
+
+std::int32_t motor_move_velocity(std::uint8_t port, const std::int32_t velocity) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].targetVelocity = velocity;
+  robot().setVelocity(port, sign(port) * std::clamp<double>(velocity, -maxRpm(port), maxRpm(port)));
+  return 1;
+}
+
+std::int32_t motor_move_voltage(std::uint8_t port, const std::int32_t voltage) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].targetVelocity = 0;
+  robot().setVoltage(port, sign(port) * limitVolts(port, voltage / 1000.0));
+  return 1;
+}
+
+std::int32_t motor_modify_profiled_velocity(std::uint8_t port, const std::int32_t velocity) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return motor_move_absolute(port, motors[port].targetPosition / unitScale(port), velocity);
+}
+
+double motor_get_target_position(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR_F;
+  }
+  return motors[port].targetPosition / unitScale(port);
+}
+
+std::int32_t motor_get_target_velocity(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return motors[port].targetVelocity;
+}
+
+double motor_get_actual_velocity(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR_F;
+  }
+  return sign(port) * robot().getVelocity(port);
+}
+
+std::int32_t motor_get_current_draw(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return static_cast<std::int32_t>(robot().getCurrent(port));
+}
+
+std::int32_t motor_get_direction(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return motor_get_actual_velocity(port) < 0 ? -1 : 1;
+}
+
+double motor_get_efficiency(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR_F;
+  }
+  return motor_is_stopped(port) ? 0 : 100;
+}
+
+std::int32_t motor_is_over_current(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return robot().getCurrent(port) >= motors[port].currentLimit;
+}
+
+std::int32_t motor_is_over_temp(std::uint8_t port) {
+  return isMotorPort(port) ? 0 : PROS_ERR;
+}
+
+std::int32_t motor_is_stopped(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return std::abs(robot().getVelocity(port)) < 1;
+}
+
+std::int32_t motor_get_zero_position_flag(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return std::abs(rawDegrees(port) - motors[port].zero) < 1;
+}
+
+std::uint32_t motor_get_faults(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return motor_is_over_current(port) ? E_MOTOR_FAULT_OVER_CURRENT : E_MOTOR_FAULT_NO_FAULTS;
+}
+
+std::uint32_t motor_get_flags(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return (motor_is_stopped(port) ? E_MOTOR_FLAGS_ZERO_VELOCITY : 0) |
+         (motor_get_zero_position_flag(port) ? E_MOTOR_FLAGS_ZERO_POSITION : 0);
+}
+
+std::int32_t motor_get_raw_position(std::uint8_t port, std::uint32_t *const timestamp) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  const double degrees = rawDegrees(port);
+  if (timestamp) {
+    *timestamp = static_cast<std::uint32_t>(VirtualClock::get().micros() / 1000);
+  }
+  return static_cast<std::int32_t>(std::lround(degrees / unitScale(port)));
+}
+
+double motor_get_position(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR_F;
+  }
+  return (rawDegrees(port) - motors[port].zero) / unitScale(port);
+}
+
+double motor_get_power(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR_F;
+  }
+  return std::abs(robot().getVoltage(port) * robot().getCurrent(port) / 1000);
+}
+
+double motor_get_temperature(std::uint8_t port) {
+  return isMotorPort(port) ? 25 : PROS_ERR_F;
+}
+
+double motor_get_torque(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR_F;
+  }
+  return robot().getTorque(port);
+}
+
+std::int32_t motor_get_voltage(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  return static_cast<std::int32_t>(sign(port) * robot().getVoltage(port) * 1000);
+}
+
+std::int32_t motor_set_zero_position(std::uint8_t port, const double position) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].zero += position * unitScale(port);
+  return 1;
+}
+
+std::int32_t motor_tare_position(std::uint8_t port) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].zero = rawDegrees(port);
+  return 1;
+}
+
+std::int32_t motor_set_brake_mode(std::uint8_t port, const motor_brake_mode_e_t mode) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].brake = mode;
+  robot().setBrake(port, mode != E_MOTOR_BRAKE_COAST);
+  return 1;
+}
+
+std::int32_t motor_set_current_limit(std::uint8_t port, const std::int32_t limit) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].currentLimit = limit;
+  return 1;
+}
+
+std::int32_t motor_set_encoder_units(std::uint8_t port, const motor_encoder_units_e_t units) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].units = units;
+  return 1;
+}
+
+std::int32_t motor_set_gearing(std::uint8_t port, const motor_gearset_e_t gearset) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].gearset = gearset;
+  robot().setFreeSpeed(port, maxRpm(port));
+  return 1;
+}
+
+motor_pid_s_t motor_convert_pid(double kf, double kp, double ki, double kd) {
+  return {static_cast<std::uint8_t>(kf * 16),
+          static_cast<std::uint8_t>(kp * 16),
+          static_cast<std::uint8_t>(ki * 16),
+          static_cast<std::uint8_t>(kd * 16)};
+}
+
+motor_pid_full_s_t motor_convert_pid_full(double kf,
+                                          double kp,
+                                          double ki,
+                                          double kd,
+                                          double filter,
+                                          double limit,
+                                          double threshold,
+                                          double loopspeed) {
+  return {static_cast<std::uint8_t>(kf * 16),
+          static_cast<std::uint8_t>(kp * 16),
+          static_cast<std::uint8_t>(ki * 16),
+          static_cast<std::uint8_t>(kd * 16),
+          static_cast<std::uint8_t>(filter * 16),
+          static_cast<std::uint16_t>(limit),
+          static_cast<std::uint8_t>(threshold),
+          static_cast<std::uint8_t>(loopspeed)};
+}
+
+/*
+ * The simulated motors keep their own loops; gains are stored so they read back.
+ */
+std::int32_t motor_set_pos_pid(std::uint8_t port, const motor_pid_s_t pid) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  auto &full = motors[port].posPid;
+  full.kf = pid.kf;
+  full.kp = pid.kp;
+  full.ki = pid.ki;
+  full.kd = pid.kd;
+  return 1;
+}
+
+std::int32_t motor_set_pos_pid_full(std::uint8_t port, const motor_pid_full_s_t pid) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].posPid = pid;
+  return 1;
+}
+
+std::int32_t motor_set_vel_pid(std::uint8_t port, const motor_pid_s_t pid) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  auto &full = motors[port].velPid;
+  full.kf = pid.kf;
+  full.kp = pid.kp;
+  full.ki = pid.ki;
+  full.kd = pid.kd;
+  return 1;
+}
+
+std::int32_t motor_set_vel_pid_full(std::uint8_t port, const motor_pid_full_s_t pid) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].velPid = pid;
+  return 1;
+}
+
+std::int32_t motor_set_reversed(std::uint8_t port, const bool reverse) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].reversed = reverse;
+  return 1;
+}
+
+std::int32_t motor_set_voltage_limit(std::uint8_t port, const std::int32_t limit) {
+  if (!isMotorPort(port)) {
+    return PROS_ERR;
+  }
+  motors[port].voltageLimit = limit;
+  return 1;
+}
+
+motor_brake_mode_e_t motor_get_brake_mode(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].brake : E_MOTOR_BRAKE_INVALID;
+}
+
+std::int32_t motor_get_current_limit(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].currentLimit : PROS_ERR;
+}
+
+motor_encoder_units_e_t motor_get_encoder_units(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].units : E_MOTOR_ENCODER_INVALID;
+}
+
+motor_gearset_e_t motor_get_gearing(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].gearset : E_MOTOR_GEARSET_INVALID;
+}
+
+motor_pid_full_s_t motor_get_pos_pid(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].posPid : motor_pid_full_s_t{};
+}
+
+motor_pid_full_s_t motor_get_vel_pid(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].velPid : motor_pid_full_s_t{};
+}
+
+std::int32_t motor_is_reversed(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].reversed : PROS_ERR;
+}
+
+std::int32_t motor_get_voltage_limit(std::uint8_t port) {
+  return isMotorPort(port) ? motors[port].voltageLimit : PROS_ERR;
+}
+
+adi_port_config_e_t adi_port_get_config(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  return p ? adi[p].config : E_ADI_ERR;
+}
+
+std::int32_t adi_port_get_value(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  if (!p) {
+    return PROS_ERR;
+  }
+  switch (adi[p].config) {
+  case E_ADI_ANALOG_IN:
+    return robot().getAnalog(p);
+  case E_ADI_DIGITAL_IN:
+    return robot().getDigital(p);
+  default:
+    return adi[p].value;
+  }
+}
+
+std::int32_t adi_port_set_config(std::uint8_t port, adi_port_config_e_t type) {
+  const std::uint8_t p = toAdiPort(port);
+  if (!p) {
+    return PROS_ERR;
+  }
+  adi[p].config = type;
+  return 1;
+}
+
+std::int32_t adi_port_set_value(std::uint8_t port, std::int32_t value) {
+  const std::uint8_t p = toAdiPort(port);
+  if (!p) {
+    return PROS_ERR;
+  }
+  adi[p].value = value;
+  return 1;
+}
+
+std::int32_t adi_analog_calibrate(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  if (!p) {
+    return PROS_ERR;
+  }
+  adi[p].calibration = robot().getAnalog(p);
+  return adi[p].calibration;
+}
+
+std::int32_t adi_analog_read(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  return p ? robot().getAnalog(p) : PROS_ERR;
+}
+
+std::int32_t adi_analog_read_calibrated(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  return p ? robot().getAnalog(p) - adi[p].calibration : PROS_ERR;
+}
+
+std::int32_t adi_analog_read_calibrated_HR(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  return p ? 16 * (robot().getAnalog(p) - adi[p].calibration) : PROS_ERR;
+}
+
+std::int32_t adi_digital_read(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  return p ? robot().getDigital(p) : PROS_ERR;
+}
+
+std::int32_t adi_digital_get_new_press(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  if (!p) {
+    return PROS_ERR;
+  }
+  const bool pressed = robot().getDigital(p);
+  const bool newPress = pressed && !adi[p].lastPressed;
+  adi[p].lastPressed = pressed;
+  return newPress;
+}
+
+std::int32_t adi_digital_write(std::uint8_t port, const bool value) {
+  return adi_port_set_value(port, value);
+}
+
+std::int32_t adi_pin_mode(std::uint8_t port, std::uint8_t mode) {
+  return adi_port_set_config(port, static_cast<adi_port_config_e_t>(mode));
+}
+
+std::int32_t adi_motor_set(std::uint8_t port, std::int8_t speed) {
+  return adi_port_set_value(port, speed);
+}
+
+std::int32_t adi_motor_get(std::uint8_t port) {
+  const std::uint8_t p = toAdiPort(port);
+  return p ? adi[p].value : PROS_ERR;
+}
+
+std::int32_t adi_motor_stop(std::uint8_t port) {
+  return adi_port_set_value(port, 0);
+}
+
+std::int32_t adi_encoder_get(adi_encoder_t enc) {
+  const std::uint8_t p = toAdiPort(enc);
+  if (!p) {
+    return PROS_ERR;
+  }
+  const std::int32_t ticks = robot().getEncoder(p) - static_cast<std::int32_t>(adi[p].zero);
+  return adi[p].reversed ? -ticks : ticks;
+}
+
+adi_encoder_t adi_encoder_init(std::uint8_t port_top, std::uint8_t port_bottom, const bool reverse) {
+  const std::uint8_t top = toAdiPort(port_top);
+  const std::uint8_t bottom = toAdiPort(port_bottom);
+  if (!top || !bottom) {
+    return PROS_ERR;
+  }
+  adi[top].config = adi[bottom].config = E_ADI_LEGACY_ENCODER;
+  adi[top].reversed = reverse;
+  adi[top].zero = robot().getEncoder(top);
+  return top;
+}
+
+std::int32_t adi_encoder_reset(adi_encoder_t enc) {
+  const std::uint8_t p = toAdiPort(enc);
+  if (!p) {
+    return PROS_ERR;
+  }
+  adi[p].zero = robot().getEncoder(p);
+  return 1;
+}
+
+std::int32_t adi_encoder_shutdown(adi_encoder_t enc) {
+  return adi_port_set_config(enc, E_ADI_TYPE_UNDEFINED);
+}
+
+std::int32_t adi_ultrasonic_get(adi_ultrasonic_t ult) {
+  return toAdiPort(ult) ? 0 : PROS_ERR;
+}
+
+adi_ultrasonic_t adi_ultrasonic_init(std::uint8_t port_ping, std::uint8_t port_echo) {
+  const std::uint8_t ping = toAdiPort(port_ping);
+  const std::uint8_t echo = toAdiPort(port_echo);
+  if (!ping || !echo) {
+    return PROS_ERR;
+  }
+  adi[ping].config = adi[echo].config = E_ADI_LEGACY_ULTRASONIC;
+  return ping;
+}
+
+std::int32_t adi_ultrasonic_shutdown(adi_ultrasonic_t ult) {
+  return adi_port_set_config(ult, E_ADI_TYPE_UNDEFINED);
+}
+
+double adi_gyro_get(adi_gyro_t gyro) {
+  const std::uint8_t p = toAdiPort(gyro);
+  if (!p) {
+    return PROS_ERR_F;
+  }
+  // Tenths of a degree
+  return 10 * adi[p].multiplier * (robot().getHeading() - adi[p].zero);
+}
+
+adi_gyro_t adi_gyro_init(std::uint8_t port, double multiplier) {
+  const std::uint8_t p = toAdiPort(port);
+  if (!p) {
+    return PROS_ERR;
+  }
+  adi[p].config = E_ADI_LEGACY_GYRO;
+  adi[p].multiplier = multiplier;
+  adi[p].zero = robot().getHeading();
+  return p;
+}
+
+std::int32_t adi_gyro_reset(adi_gyro_t gyro) {
+  const std::uint8_t p = toAdiPort(gyro);
+  if (!p) {
+    return PROS_ERR;
+  }
+  adi[p].zero = robot().getHeading();
+  return 1;
+}
+
+std::int32_t adi_gyro_shutdown(adi_gyro_t gyro) {
+  return adi_port_set_config(gyro, E_ADI_TYPE_UNDEFINED);
+}
+
+std::uint8_t competition_get_status(void) {
+  return COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED;
+}
+
+std::int32_t controller_is_connected(controller_id_e_t id) {
+  return id == E_CONTROLLER_MASTER;
+}
+
+std::int32_t controller_get_analog(controller_id_e_t, controller_analog_e_t) {
+  robot();
+  return 0;
+}
+
+std::int32_t controller_get_battery_capacity(controller_id_e_t) {
+  return 100;
+}
+
+std::int32_t controller_get_battery_level(controller_id_e_t) {
+  return 100;
+}
+
+std::int32_t controller_get_digital(controller_id_e_t, controller_digital_e_t) {
+  robot();
+  return 0;
+}
+
+std::int32_t controller_get_digital_new_press(controller_id_e_t, controller_digital_e_t) {
+  robot();
+  return 0;
+}
+
+std::int32_t controller_print(controller_id_e_t, std::uint8_t, std::uint8_t, const char *, ...) {
+  return 1;
+}
+
+std::int32_t controller_set_text(controller_id_e_t, std::uint8_t, std::uint8_t, const char *) {
+  return 1;
+}
+
+std::int32_t controller_clear_line(controller_id_e_t, std::uint8_t) {
+  return 1;
+}
+
+std::int32_t controller_clear(controller_id_e_t) {
+  return 1;
+}
+
+std::int32_t controller_rumble(controller_id_e_t, const char *) {
+  return 1;
+}
+
+std::int32_t battery_get_voltage(void) {
+  return static_cast<std::int32_t>(robot().getBatteryVoltage() * 1000);
+}
+
+std::int32_t battery_get_current(void) {
+  auto &r = robot();
+  return static_cast<std::int32_t>((r.getParams().batteryVoltage - r.getBatteryVoltage()) / 0.1 *
+                                   1000);
+}
+
+double battery_get_temperature(void) {
+  return 25;
+}
+
+double battery_get_capacity(void) {
+  return 100;
+}
+
+std::int32_t usd_is_installed(void) {
+  return SdCard::isMounted();
+}
+
+bool lcd_is_initialized(void) {
+  return lcdInitialized;
+}
+
+bool lcd_initialize(void) {
+  lcdInitialized = true;
+  return true;
+}
+
+bool lcd_shutdown(void) {
+  lcdInitialized = false;
+  return true;
+}
+
+bool lcd_print(std::int16_t line, const char *fmt, ...) {
+  if (!lcdInitialized || line < 0 || line >= static_cast<std::int16_t>(lcdLines.size())) {
+    return false;
+  }
+  char buffer[64];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  lcdLines[line] = buffer;
+  return true;
+}
+
+bool lcd_set_text(std::int16_t line, const char *text) {
+  if (!lcdInitialized || line < 0 || line >= static_cast<std::int16_t>(lcdLines.size())) {
+    return false;
+  }
+  lcdLines[line] = text;
+  return true;
+}
+
+bool lcd_clear(void) {
+  lcdLines.fill("");
+  return lcdInitialized;
+}
+
+bool lcd_clear_line(std::int16_t line) {
+  return lcd_set_text(line, "");
+}
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t) {
+  return lcdInitialized;
+}
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t) {
+  return lcdInitialized;
+}
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t) {
+  return lcdInitialized;
+}
+
+std::uint8_t lcd_read_buttons(void) {
+  return 0;
+}
+} // namespace c
+
+Motor::Motor(const std::uint8_t port,
+             const motor_gearset_e_t gearset,
+             const bool reverse,
+             const motor_encoder_units_e_t encoder_units)
+  : _port(port) {
+  set_gearing(gearset);
+  set_reversed(reverse);
+  set_encoder_units(encoder_units);
+}
+
+Motor::Motor(const std::uint8_t port, const motor_gearset_e_t gearset, const bool reverse)
+  : _port(port) {
+  set_gearing(gearset);
+  set_reversed(reverse);
+}
+
+Motor::Motor(const std::uint8_t port, const motor_gearset_e_t gearset) : _port(port) {
+  set_gearing(gearset);
+}
+
+Motor::Motor(const std::uint8_t port, const bool reverse) : _port(port) {
+  set_reversed(reverse);
+}
+
+Motor::Motor(const std::uint8_t port) : _port(port) {
+}
+
+std::int32_t Motor::operator=(std::int32_t voltage) const {
+  return c::motor_move(_port, voltage);
+}
+
+std::int32_t Motor::move(std::int32_t voltage) const {
+  return c::motor_move(_port, voltage);
+}
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+  return c::motor_move_absolute(_port, position, velocity);
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+  return c::motor_move_relative(_port, position, velocity);
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+  return c::motor_move_velocity(_port, velocity);
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const {
+  return c::motor_move_voltage(_port, voltage);
+}
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+  return c::motor_modify_profiled_velocity(_port, velocity);
+}
+
+double Motor::get_target_position(void) const {
+  return c::motor_get_target_position(_port);
+}
+
+std::int32_t Motor::get_target_velocity(void) const {
+  return c::motor_get_target_velocity(_port);
+}
+
+double Motor::get_actual_velocity(void) const {
+  return c::motor_get_actual_velocity(_port);
+}
+
+std::int32_t Motor::get_current_draw(void) const {
+  return c::motor_get_current_draw(_port);
+}
+
+std::int32_t Motor::get_direction(void) const {
+  return c::motor_get_direction(_port);
+}
+
+double Motor::get_efficiency(void) const {
+  return c::motor_get_efficiency(_port);
+}
+
+std::int32_t Motor::is_over_current(void) const {
+  return c::motor_is_over_current(_port);
+}
+
+std::int32_t Motor::is_stopped(void) const {
+  return c::motor_is_stopped(_port);
+}
+
+std::int32_t Motor::get_zero_position_flag(void) const {
+  return c::motor_get_zero_position_flag(_port);
+}
+
+std::uint32_t Motor::get_faults(void) const {
+  return c::motor_get_faults(_port);
+}
+
+std::uint32_t Motor::get_flags(void) const {
+  return c::motor_get_flags(_port);
+}
+
+std::int32_t Motor::get_raw_position(std::uint32_t *const timestamp) const {
+  return c::motor_get_raw_position(_port, timestamp);
+}
+
+std::int32_t Motor::is_over_temp(void) const {
+  return c::motor_is_over_temp(_port);
+}
+
+double Motor::get_position(void) const {
+  return c::motor_get_position(_port);
+}
+
+double Motor::get_power(void) const {
+  return c::motor_get_power(_port);
+}
+
+double Motor::get_temperature(void) const {
+  return c::motor_get_temperature(_port);
+}
+
+double Motor::get_torque(void) const {
+  return c::motor_get_torque(_port);
+}
+
+std::int32_t Motor::get_voltage(void) const {
+  return c::motor_get_voltage(_port);
+}
+
+std::int32_t Motor::set_zero_position(const double position) const {
+  return c::motor_set_zero_position(_port, position);
+}
+
+std::int32_t Motor::tare_position(void) const {
+  return c::motor_tare_position(_port);
+}
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode) const {
+  return c::motor_set_brake_mode(_port, mode);
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit) const {
+  return c::motor_set_current_limit(_port, limit);
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units) const {
+  return c::motor_set_encoder_units(_port, units);
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset) const {
+  return c::motor_set_gearing(_port, gearset);
+}
+
+motor_pid_s_t Motor::convert_pid(double kf, double kp, double ki, double kd) {
+  return c::motor_convert_pid(kf, kp, ki, kd);
+}
+
+motor_pid_full_s_t Motor::convert_pid_full(double kf,
+                                           double kp,
+                                           double ki,
+                                           double kd,
+                                           double filter,
+                                           double limit,
+                                           double threshold,
+                                           double loopspeed) {
+  return c::motor_convert_pid_full(kf, kp, ki, kd, filter, limit, threshold, loopspeed);
+}
+
+std::int32_t Motor::set_pos_pid(const motor_pid_s_t pid) const {
+  return c::motor_set_pos_pid(_port, pid);
+}
+
+std::int32_t Motor::set_pos_pid_full(const motor_pid_full_s_t pid) const {
+  return c::motor_set_pos_pid_full(_port, pid);
+}
+
+std::int32_t Motor::set_vel_pid(const motor_pid_s_t pid) const {
+  return c::motor_set_vel_pid(_port, pid);
+}
+
+std::int32_t Motor::set_vel_pid_full(const motor_pid_full_s_t pid) const {
+  return c::motor_set_vel_pid_full(_port, pid);
+}
+
+std::int32_t Motor::set_reversed(const bool reverse) const {
+  return c::motor_set_reversed(_port, reverse);
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit) const {
+  return c::motor_set_voltage_limit(_port, limit);
+}
+
+motor_brake_mode_e_t Motor::get_brake_mode(void) const {
+  return c::motor_get_brake_mode(_port);
+}
+
+std::int32_t Motor::get_current_limit(void) const {
+  return c::motor_get_current_limit(_port);
+}
+
+motor_encoder_units_e_t Motor::get_encoder_units(void) const {
+  return c::motor_get_encoder_units(_port);
+}
+
+motor_gearset_e_t Motor::get_gearing(void) const {
+  return c::motor_get_gearing(_port);
+}
+
+motor_pid_full_s_t Motor::get_pos_pid(void) const {
+  return c::motor_get_pos_pid(_port);
+}
+
+motor_pid_full_s_t Motor::get_vel_pid(void) const {
+  return c::motor_get_vel_pid(_port);
+}
+
+std::int32_t Motor::is_reversed(void) const {
+  return c::motor_is_reversed(_port);
+}
+
+std::int32_t Motor::get_voltage_limit(void) const {
+  return c::motor_get_voltage_limit(_port);
+}
+
+std::uint8_t Motor::get_port(void) const {
+  return _port;
+}
+
+ADIPort::ADIPort(std::uint8_t port, adi_port_config_e_t type) : _port(port) {
+  c::adi_port_set_config(_port, type);
+}
+
+ADIPort::ADIPort(void) : _port(0) {
+}
+
+std::int32_t ADIPort::get_config(void) const {
+  return c::adi_port_get_config(_port);
+}
+
+std::int32_t ADIPort::get_value(void) const {
+  return c::adi_port_get_value(_port);
+}
+
+std::int32_t ADIPort::set_config(adi_port_config_e_t type) const {
+  return c::adi_port_set_config(_port, type);
+}
+
+std::int32_t ADIPort::set_value(std::int32_t value) const {
+  return c::adi_port_set_value(_port, value);
+}
+
+ADIAnalogIn::ADIAnalogIn(std::uint8_t port) : ADIPort(port, E_ADI_ANALOG_IN) {
+}
+
+std::int32_t ADIAnalogIn::calibrate(void) const {
+  return c::adi_analog_calibrate(_port);
+}
+
+std::int32_t ADIAnalogIn::get_value_calibrated(void) const {
+  return c::adi_analog_read_calibrated(_port);
+}
+
+std::int32_t ADIAnalogIn::get_value_calibrated_HR(void) const {
+  return c::adi_analog_read_calibrated_HR(_port);
+}
+
+ADIAnalogOut::ADIAnalogOut(std::uint8_t port) : ADIPort(port, E_ADI_ANALOG_OUT) {
+}
+
+ADIDigitalOut::ADIDigitalOut(std::uint8_t port, bool init_state) : ADIPort(port, E_ADI_DIGITAL_OUT) {
+  set_value(init_state);
+}
+
+ADIDigitalIn::ADIDigitalIn(std::uint8_t port) : ADIPort(port, E_ADI_DIGITAL_IN) {
+}
+
+std::int32_t ADIDigitalIn::get_new_press(void) const {
+  return c::adi_digital_get_new_press(_port);
+}
+
+ADIMotor::ADIMotor(std::uint8_t port) : ADIPort(port, E_ADI_LEGACY_PWM) {
+}
+
+std::int32_t ADIMotor::stop(void) const {
+  return c::adi_motor_stop(_port);
+}
+
+ADIEncoder::ADIEncoder(std::uint8_t port_top, std::uint8_t port_bottom, bool reversed) {
+  _port = c::adi_encoder_init(port_top, port_bottom, reversed);
+}
+
+std::int32_t ADIEncoder::reset(void) const {
+  return c::adi_encoder_reset(_port);
+}
+
+std::int32_t ADIEncoder::get_value(void) const {
+  return c::adi_encoder_get(_port);
+}
+
+ADIUltrasonic::ADIUltrasonic(std::uint8_t port_ping, std::uint8_t port_echo) {
+  _port = c::adi_ultrasonic_init(port_ping, port_echo);
+}
+
+ADIGyro::ADIGyro(std::uint8_t port, double multiplier) {
+  _port = c::adi_gyro_init(port, multiplier);
+}
+
+double ADIGyro::get_value(void) const {
+  return c::adi_gyro_get(_port);
+}
+
+std::int32_t ADIGyro::reset(void) const {
+  return c::adi_gyro_reset(_port);
+}
+
+Controller::Controller(controller_id_e_t id) : _id(id) {
+}
+
+std::int32_t Controller::is_connected(void) {
+  return c::controller_is_connected(_id);
+}
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) {
+  return c::controller_get_analog(_id, channel);
+}
+
+std::int32_t Controller::get_battery_capacity(void) {
+  return c::controller_get_battery_capacity(_id);
+}
+
+std::int32_t Controller::get_battery_level(void) {
+  return c::controller_get_battery_level(_id);
+}
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) {
+  return c::controller_get_digital(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+  return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char *str) {
+  return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) {
+  return c::controller_clear_line(_id, line);
+}
+
+std::int32_t Controller::rumble(const char *rumble_pattern) {
+  return c::controller_rumble(_id, rumble_pattern);
+}
+
+std::int32_t Controller::clear(void) {
+  return c::controller_clear(_id);
+}
+
+namespace battery {
+double get_capacity(void) {
+  return c::battery_get_capacity();
+}
+
+std::int32_t get_current(void) {
+  return c::battery_get_current();
+}
+
+double get_temperature(void) {
+  return c::battery_get_temperature();
+}
+
+std::int32_t get_voltage(void) {
+  return c::battery_get_voltage();
+}
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) {
+  return c::competition_get_status();
+}
+
+std::uint8_t is_autonomous(void) {
+  return (c::competition_get_status() & COMPETITION_AUTONOMOUS) != 0;
+}
+
+std::uint8_t is_connected(void) {
+  return (c::competition_get_status() & COMPETITION_CONNECTED) != 0;
+}
+
+std::uint8_t is_disabled(void) {
+  return (c::competition_get_status() & COMPETITION_DISABLED) != 0;
+}
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) {
+  return c::usd_is_installed();
+}
+} // namespace usd
+
+namespace lcd {
+bool is_initialized(void) {
+  return c::lcd_is_initialized();
+}
+
+bool initialize(void) {
+  return c::lcd_initialize();
+}
+
+bool shutdown(void) {
+  return c::lcd_shutdown();
+}
+
+bool set_text(std::int16_t line, std::string text) {
+  return c::lcd_set_text(line, text.c_str());
+}
+
+bool clear(void) {
+  return c::lcd_clear();
+}
+
+bool clear_line(std::int16_t line) {
+  return c::lcd_clear_line(line);
+}
+
+void register_btn0_cb(lcd_btn_cb_fn_t cb) {
+  c::lcd_register_btn0_cb(cb);
+}
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb) {
+  c::lcd_register_btn1_cb(cb);
+}
+
+void register_btn2_cb(lcd_btn_cb_fn_t cb) {
+  c::lcd_register_btn2_cb(cb);
+}
+
+std::uint8_t read_buttons(void) {
+  return c::lcd_read_buttons();
+}
+} // namespace lcd
+} // namespace pros
@@ -0,0 +1,318 @@
+/*
+ * Host implementation of the PROS RTOS API (pros/rtos.h, pros/rtos.hpp and the task and mutex
+ * parts of pros/apix.h) on VirtualClock, so robot code and OkapiLib built without THREADS_STD run
+ * in simulated time.
+ */
+#include "pros/apix.h"
+#include "pros/rtos.hpp"
+#include "virtualClock.hpp"
+
+namespace {
+struct HostMutex {
+  void *owner{nullptr};
+  std::uint32_t depth{0};
+};
+
+/**
+ * Only one task runs at a time, so taking a mutex is a plain check; a held mutex is retried every
+ * millisecond until the timeout.
+ */
+bool takeMutex(HostMutex *imutex, const std::uint32_t itimeout, const bool irecursive) {
+  auto &clock = VirtualClock::get();
+  void *const self = clock.current();
+  const auto isFree = [&]() { return !imutex->owner || (irecursive && imutex->owner == self); };
+
+  // Uncontended takes never touch the clock, so simulations stepped from its advance callback
+  // can lock their own mutexes
+  const std::uint64_t timeout =
+    isFree() || itimeout == TIMEOUT_MAX
+      ? UINT64_MAX
+      : clock.micros() + static_cast<std::uint64_t>(itimeout) * 1000;
+  while (!isFree()) {
+    if (clock.micros() >= timeout) {
+      return false;
+    }
+    clock.delay(1);
+  }
+  imutex->owner = self;
+  imutex->depth++;
+  return true;
+}
+
+bool giveMutex(HostMutex *imutex) {
+  if (imutex->depth == 0) {
+    return false;
+  }
+  if (--imutex->depth == 0) {
+    imutex->owner = nullptr;
+  }
+  return true;
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint32_t millis(void) {
+  return VirtualClock::get().millis();
+}
+
+task_t task_create(task_fn_t function,
+                   void *const parameters,
+                   uint32_t prio,
+                   const uint16_t,
+                   const char *const name) {
+  return VirtualClock::get().spawn([=]() { function(parameters); }, prio, name);
+}
+
+void task_delete(task_t task) {
+  VirtualClock::get().remove(task);
+}
+
+void task_delay(const uint32_t milliseconds) {
+  VirtualClock::get().delay(milliseconds);
+}
+
+void delay(const uint32_t milliseconds) {
+  VirtualClock::get().delay(milliseconds);
+}
+
+void task_delay_until(uint32_t *const prev_time, const uint32_t delta) {
+  *prev_time += delta;
+  VirtualClock::get().sleepUntil(static_cast<std::uint64_t>(*prev_time) * 1000);
+}
+
+uint32_t task_get_priority(task_t task) {
+  return VirtualClock::get().getPriority(task);
+}
+
+void task_set_priority(task_t task, uint32_t prio) {
+  VirtualClock::get().setPriority(task, prio);
+}
+
+task_state_e_t task_get_state(task_t task) {
+  switch (VirtualClock::get().getState(task)) {
+  case VirtualClock::State::running:
+    return E_TASK_STATE_RUNNING;
+  case VirtualClock::State::ready:
+    return E_TASK_STATE_READY;
+  case VirtualClock::State::waiting:
+    return E_TASK_STATE_BLOCKED;
+  case VirtualClock::State::suspended:
+    return E_TASK_STATE_SUSPENDED;
+  case VirtualClock::State::done:
+    return E_TASK_STATE_DELETED;
+  }
+  return E_TASK_STATE_INVALID;
+}
+
+void task_suspend(task_t task) {
+  VirtualClock::get().suspend(task);
+}
+
+void task_resume(task_t task) {
+  VirtualClock::get().resume(task);
+}
+
+uint32_t task_get_count(void) {
+  return VirtualClock::get().getTaskCount();
+}
+
+char *task_get_name(task_t task) {
+  return const_cast<char *>(VirtualClock::get().getName(task));
+}
+
+task_t task_get_by_name(const char *name) {
+  return VirtualClock::get().getByName(name);
+}
+
+task_t task_get_current() {
+  return VirtualClock::get().current();
+}
+
+uint32_t task_notify(task_t task) {
+  VirtualClock::get().notify(task, 1, false);
+  return 1;
+}
+
+uint32_t
+task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t *prev_value) {
+  auto &clock = VirtualClock::get();
+  std::uint32_t previous;
+  switch (action) {
+  case E_NOTIFY_ACTION_INCR:
+    previous = clock.notify(task, 1, false);
+    break;
+  case E_NOTIFY_ACTION_BITS:
+    previous = clock.notify(task, 0, false);
+    clock.notify(task, previous | value, true);
+    break;
+  case E_NOTIFY_ACTION_OWRITE:
+    previous = clock.notify(task, value, true);
+    break;
+  case E_NOTIFY_ACTION_NO_OWRITE:
+    previous = clock.notify(task, 0, false);
+    if (previous != 0) {
+      if (prev_value) {
+        *prev_value = previous;
+      }
+      return 0;
+    }
+    clock.notify(task, value, true);
+    break;
+  default:
+    previous = clock.notify(task, 0, false);
+    break;
+  }
+  if (prev_value) {
+    *prev_value = previous;
+  }
+  return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+  return VirtualClock::get().notifyTake(clear_on_exit, timeout);
+}
+
+bool task_notify_clear(task_t task) {
+  return VirtualClock::get().notify(task, 0, true) != 0;
+}
+
+void task_notify_when_deleting(task_t target_task,
+                               task_t task_to_notify,
+                               uint32_t,
+                               notify_action_e_t) {
+  VirtualClock::get().notifyWhenDeleting(target_task, task_to_notify);
+}
+
+bool task_abort_delay(task_t) {
+  return false;
+}
+
+mutex_t mutex_create(void) {
+  return new HostMutex();
+}
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+  return takeMutex(static_cast<HostMutex *>(mutex), timeout, false);
+}
+
+bool mutex_give(mutex_t mutex) {
+  return giveMutex(static_cast<HostMutex *>(mutex));
+}
+
+mutex_t mutex_recursive_create(void) {
+  return new HostMutex();
+}
+
+bool mutex_recursive_take(mutex_t mutex, uint32_t timeout) {
+  return takeMutex(static_cast<HostMutex *>(mutex), timeout, true);
+}
+
+bool mutex_recursive_give(mutex_t mutex) {
+  return giveMutex(static_cast<HostMutex *>(mutex));
+}
+
+task_t mutex_get_owner(mutex_t mutex) {
+  return static_cast<HostMutex *>(mutex)->owner;
+}
+} // namespace c
+
+Task::Task(task_fn_t function,
+           void *parameters,
+           std::uint32_t prio,
+           std::uint16_t stack_depth,
+           const char *name)
+  : task(c::task_create(function, parameters, prio, stack_depth, name)) {
+}
+
+Task::Task(task_fn_t function, void *parameters, const char *name)
+  : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {
+}
+
+Task::Task(task_t task) : task(task) {
+}
+
+Task Task::current() {
+  return Task(c::task_get_current());
+}
+
+void Task::operator=(const task_t in) {
+  task = in;
+}
+
+void Task::remove() {
+  c::task_delete(task);
+}
+
+std::uint32_t Task::get_priority(void) {
+  return c::task_get_priority(task);
+}
+
+void Task::set_priority(std::uint32_t prio) {
+  c::task_set_priority(task, prio);
+}
+
+std::uint32_t Task::get_state(void) {
+  return c::task_get_state(task);
+}
+
+void Task::suspend(void) {
+  c::task_suspend(task);
+}
+
+void Task::resume(void) {
+  c::task_resume(task);
+}
+
+const char *Task::get_name(void) {
+  return c::task_get_name(task);
+}
+
+std::uint32_t Task::notify(void) {
+  return c::task_notify(task);
+}
+
+std::uint32_t
+Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t *prev_value) {
+  return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+  return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear(void) {
+  return c::task_notify_clear(task);
+}
+
+void Task::delay(const std::uint32_t milliseconds) {
+  c::task_delay(milliseconds);
+}
+
+void Task::delay_until(std::uint32_t *const prev_time, const std::uint32_t delta) {
+  c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count(void) {
+  return c::task_get_count();
+}
+
+Mutex::Mutex(void) : mutex(c::mutex_create()) {
+}
+
+bool Mutex::take(std::uint32_t timeout) {
+  return c::mutex_take(mutex, timeout);
+}
+
+bool Mutex::give(void) {
+  return c::mutex_give(mutex);
+}
+} // namespace pros
+
+/*
+ * The V5 SDK's microsecond timer, which PROS 3.2 doesn't wrap; robot code reads it through
+ * microClock().
+ */
+extern "C" std::uint64_t vexSystemHighResTimeGet(void) {
+  return VirtualClock::get().micros();
+}
@@ -0,0 +1,57 @@
+/*
+ * The redirection works by interposing libc's file functions: the executable's definitions take
+ * precedence over libc's for its own calls and for libstdc++'s, and the originals are found with
+ * dlsym(RTLD_NEXT).
+ */
+#include "sdCard.hpp"
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <sys/stat.h>
+
+namespace {
+std::string mountPoint;
+
+template <typename F> F original(const char *iname) {
+  static_assert(sizeof(F) == sizeof(void *));
+  void *symbol = dlsym(RTLD_NEXT, iname);
+  F function;
+  std::memcpy(&function, &symbol, sizeof(function));
+  return function;
+}
+} // namespace
+
+void SdCard::mount(const std::string &idirectory) {
+  mountPoint = idirectory;
+  while (!mountPoint.empty() && mountPoint.back() == '/') {
+    mountPoint.pop_back();
+  }
+}
+
+bool SdCard::isMounted() {
+  return !mountPoint.empty();
+}
+
+std::string SdCard::resolve(const char *ipath) {
+  if (!ipath || mountPoint.empty() || std::strncmp(ipath, "/usd/", 5) != 0) {
+    return ipath ? ipath : "";
+  }
+  return mountPoint + (ipath + 4);
+}
+
+extern "C" {
+FILE *fopen(const char *ipath, const char *imode) {
+  static const auto real = original<FILE *(*)(const char *, const char *)>("fopen");
+  return real(SdCard::resolve(ipath).c_str(), imode);
+}
+
+FILE *fopen64(const char *ipath, const char *imode) {
+  static const auto real = original<FILE *(*)(const char *, const char *)>("fopen64");
+  return real(SdCard::resolve(ipath).c_str(), imode);
+}
+
+int stat(const char *__restrict ipath, struct stat *__restrict obuf) noexcept {
+  static const auto real = original<int (*)(const char *, struct stat *)>("stat");
+  return real(SdCard::resolve(ipath).c_str(), obuf);
+}
+}
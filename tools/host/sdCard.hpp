@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Stands in for the V5's SD card: while a host directory is mounted, `fopen`, `std::fstream` and
+ * `stat` on paths under `/usd/` open the same paths under that directory instead, so robot code
+ * reads and writes its files unchanged.
+ */
+class SdCard {
+  public:
+  /**
+   * Mounts a host directory as `/usd/`. An empty directory unmounts it.
+   */
+  static void mount(const std::string &idirectory);
+
+  /**
+   * @return Whether a directory is mounted.
+   */
+  static bool isMounted();
+
+  /**
+   * @return The host path for a robot path; paths outside of `/usd/` are returned unchanged.
+   */
+  static std::string resolve(const char *ipath);
+};
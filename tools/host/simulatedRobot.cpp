@@ -0,0 +1,206 @@
+#include "simulatedRobot.hpp"
+#include "virtualClock.hpp"
+#include <algorithm>
+#include <cmath>
+
+SimulatedRobot &SimulatedRobot::get() {
+  // Never destroyed, like the clock whose callback steps it
+  static SimulatedRobot *robot = new SimulatedRobot();
+  return *robot;
+}
+
+SimulatedRobot::SimulatedRobot() {
+  driveSide.fill(-1);
+  trackingSide.fill(-1);
+  configure(params);
+  VirtualClock::get().setAdvanceCallback([this](const std::uint64_t ifrom, const std::uint64_t ito) {
+    step((ito - ifrom) / 1e6);
+  });
+}
+
+void SimulatedRobot::configure(const Params &iparams) {
+  params = iparams;
+  sim = std::make_shared<SkidSteerSimulator>();
+  sim->setWheelDiameter(2 * params.wheelRadius);
+  sim->setWheelTrack(params.wheelTrack);
+  sim->setTrackingWheels(params.trackingWheelDiameter, params.trackingWheelTrack, 360);
+  sim->setBattery(params.batteryVoltage, 0.1);
+  sim->setFriction(params.traction, params.rolling);
+  sim->setPose(params.startPose);
+
+  for (auto &mechanism : mechanisms) {
+    mechanism = Mechanism{Control::voltage, 0, 0, false, mechanism.freeRpm};
+  }
+  random.seed(params.seed);
+  noise.reset();
+}
+
+const SimulatedRobot::Params &SimulatedRobot::getParams() const {
+  return params;
+}
+
+void SimulatedRobot::attachDrive(const SkidSteerSimulator::Side iside, const std::uint8_t iport) {
+  if (iport >= 1 && iport <= motorPorts) {
+    driveSide[iport] = iside;
+  }
+}
+
+void SimulatedRobot::attachTrackingWheel(const SkidSteerSimulator::Side iside,
+                                         const std::uint8_t itopPort) {
+  if (itopPort >= 1 && itopPort <= adiPorts) {
+    trackingSide[itopPort] = iside;
+  }
+}
+
+void SimulatedRobot::setAnalogInput(const std::uint8_t iport, std::function<std::int32_t()> iinput) {
+  if (iport >= 1 && iport <= adiPorts) {
+    analogInputs[iport] = std::move(iinput);
+  }
+}
+
+void SimulatedRobot::setDigitalInput(const std::uint8_t iport, std::function<bool()> iinput) {
+  if (iport >= 1 && iport <= adiPorts) {
+    digitalInputs[iport] = std::move(iinput);
+  }
+}
+
+void SimulatedRobot::step(const double iseconds) {
+  sim->stepFor(iseconds);
+
+  const double battery = sim->getBatteryVoltage();
+  for (std::size_t port = 1; port <= motorPorts; port++) {
+    if (driveSide[port] >= 0) {
+      continue;
+    }
+
+    Mechanism &m = mechanisms[port];
+    double target = 0;
+    switch (m.control) {
+    case Control::voltage:
+      m.volts = std::clamp(m.target, -battery, battery);
+      target = m.volts / 12 * m.freeRpm;
+      break;
+    case Control::velocity:
+      target = std::clamp(m.target, -m.freeRpm, m.freeRpm);
+      m.volts = target / m.freeRpm * 12;
+      break;
+    case Control::position:
+      target = std::clamp(positionKp * (m.target - m.degrees), -m.maxRpm, m.maxRpm);
+      m.volts = target / m.freeRpm * 12;
+      break;
+    }
+
+    const bool coasting = m.control == Control::voltage && m.volts == 0 && !m.brake;
+    const double tau = coasting ? coastTime : responseTime;
+    m.rpm += (target - m.rpm) * std::min(1.0, iseconds / tau);
+    m.degrees += m.rpm * 6 * iseconds;
+  }
+}
+
+std::shared_ptr<SkidSteerSimulator> SimulatedRobot::getSimulator() const {
+  return sim;
+}
+
+void SimulatedRobot::setVoltage(const std::uint8_t iport, const double ivolts) {
+  if (const int side = driveSide[iport]; side >= 0) {
+    sim->setVoltage(toSide(side), mount(side) * ivolts);
+  } else {
+    mechanisms[iport].control = Control::voltage;
+    mechanisms[iport].target = ivolts;
+  }
+}
+
+void SimulatedRobot::setVelocity(const std::uint8_t iport, const double irpm) {
+  if (const int side = driveSide[iport]; side >= 0) {
+    sim->setVelocity(toSide(side), mount(side) * irpm);
+  } else {
+    mechanisms[iport].control = Control::velocity;
+    mechanisms[iport].target = irpm;
+  }
+}
+
+void SimulatedRobot::setPosition(const std::uint8_t iport,
+                                 const double idegrees,
+                                 const double imaxRpm) {
+  if (const int side = driveSide[iport]; side >= 0) {
+    sim->setPosition(toSide(side), mount(side) * idegrees, imaxRpm);
+  } else {
+    mechanisms[iport].control = Control::position;
+    mechanisms[iport].target = idegrees;
+    mechanisms[iport].maxRpm = std::abs(imaxRpm);
+  }
+}
+
+void SimulatedRobot::setBrake(const std::uint8_t iport, const bool ibrake) {
+  if (const int side = driveSide[iport]; side >= 0) {
+    sim->setBrake(toSide(side), ibrake);
+  } else {
+    mechanisms[iport].brake = ibrake;
+  }
+}
+
+void SimulatedRobot::setFreeSpeed(const std::uint8_t iport, const double irpm) {
+  mechanisms[iport].freeRpm = irpm;
+}
+
+double SimulatedRobot::getPosition(const std::uint8_t iport) {
+  const int side = driveSide[iport];
+  const double degrees =
+    side >= 0 ? mount(side) * sim->getWheelPosition(toSide(side)) : mechanisms[iport].degrees;
+  return params.motorNoise > 0 ? degrees + params.motorNoise * noise(random) : degrees;
+}
+
+double SimulatedRobot::getVelocity(const std::uint8_t iport) const {
+  const int side = driveSide[iport];
+  return side >= 0 ? mount(side) * sim->getWheelVelocity(toSide(side)) : mechanisms[iport].rpm;
+}
+
+double SimulatedRobot::getVoltage(const std::uint8_t iport) const {
+  const int side = driveSide[iport];
+  return side >= 0 ? mount(side) * sim->getAppliedVoltage(toSide(side)) : mechanisms[iport].volts;
+}
+
+double SimulatedRobot::getCurrent(const std::uint8_t iport) const {
+  const int side = driveSide[iport];
+  return side >= 0 ? sim->getCurrent(toSide(side)) : 0;
+}
+
+double SimulatedRobot::getTorque(const std::uint8_t iport) const {
+  const int side = driveSide[iport];
+  return side >= 0 ? sim->getTorque(toSide(side)) : 0;
+}
+
+std::int32_t SimulatedRobot::getAnalog(const std::uint8_t iport) const {
+  return iport >= 1 && iport <= adiPorts && analogInputs[iport] ? analogInputs[iport]() : 0;
+}
+
+bool SimulatedRobot::getDigital(const std::uint8_t iport) const {
+  return iport >= 1 && iport <= adiPorts && digitalInputs[iport] && digitalInputs[iport]();
+}
+
+std::int32_t SimulatedRobot::getEncoder(const std::uint8_t itopPort) {
+  if (itopPort < 1 || itopPort > adiPorts || trackingSide[itopPort] < 0) {
+    return 0;
+  }
+
+  const int side = trackingSide[itopPort];
+  const double ticks = mount(side) * sim->getTrackingTicks(toSide(side));
+  return static_cast<std::int32_t>(
+    std::lround(params.encoderNoise > 0 ? ticks + params.encoderNoise * noise(random) : ticks));
+}
+
+double SimulatedRobot::getHeading() const {
+  return sim->getPose().theta * 180 / 3.14159265358979323846;
+}
+
+double SimulatedRobot::getBatteryVoltage() const {
+  return sim->getBatteryVoltage();
+}
+
+double SimulatedRobot::mount(const int iside) {
+  return iside == SkidSteerSimulator::right ? -1 : 1;
+}
+
+SkidSteerSimulator::Side SimulatedRobot::toSide(const int iside) {
+  return static_cast<SkidSteerSimulator::Side>(iside);
+}
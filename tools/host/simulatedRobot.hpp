@@ -0,0 +1,142 @@
+#pragma once
+
+#include "skidSteerSimulator.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+
+/**
+ * The physical robot behind the host PROS device shims. Smart ports attached to a side of the
+ * drive run a SkidSteerSimulator; every other motor turns a free mechanism with first-order
+ * dynamics. ADI encoders attached to a side count that side's tracking wheel, gyros read the
+ * chassis heading, and analog and digital inputs come from callbacks.
+ *
+ * As on any drive, the right side's motors and tracking wheel are mounted mirrored, so they count
+ * backwards while the robot drives forward; robot code reverses them the same way it does on the
+ * V5. Both motors of a side share one simulated gearbox, so the last command to either one wins.
+ *
+ * The process has one robot. It steps whenever VirtualClock advances, and positions and encoder
+ * counts can carry Gaussian noise drawn from a seeded generator, so a run is repeatable.
+ */
+class SimulatedRobot {
+  public:
+  struct Params {
+    double wheelRadius{0.0523875};           // m
+    double wheelTrack{0.30};                 // m
+    double trackingWheelDiameter{0.06985};   // m
+    double trackingWheelTrack{0.13335};      // m
+    double batteryVoltage{12.8};             // V, open-circuit
+    double traction{1.0};                    // wheel-to-field friction coefficient
+    double rolling{0.03};                    // rolling resistance coefficient
+    double encoderNoise{0};                  // tracking wheel ticks, standard deviation per read
+    double motorNoise{0};                    // motor encoder degrees, standard deviation per read
+    SkidSteerSimulator::Pose startPose{};
+    std::uint32_t seed{0};
+  };
+
+  /**
+   * @return The process' robot.
+   */
+  static SimulatedRobot &get();
+
+  /**
+   * Rebuilds the drive and mechanisms at rest with new parameters. Port attachments and inputs
+   * are kept.
+   */
+  void configure(const Params &iparams);
+
+  const Params &getParams() const;
+
+  /**
+   * Attaches a smart port to one side of the drive.
+   */
+  void attachDrive(SkidSteerSimulator::Side iside, std::uint8_t iport);
+
+  /**
+   * Attaches an ADI encoder, by its top port, to one side's tracking wheel.
+   */
+  void attachTrackingWheel(SkidSteerSimulator::Side iside, std::uint8_t itopPort);
+
+  void setAnalogInput(std::uint8_t iport, std::function<std::int32_t()> iinput);
+
+  void setDigitalInput(std::uint8_t iport, std::function<bool()> iinput);
+
+  /**
+   * Steps the drive and every mechanism.
+   *
+   * @param iseconds The time to simulate in sec.
+   */
+  void step(double iseconds);
+
+  std::shared_ptr<SkidSteerSimulator> getSimulator() const;
+
+  /*
+   * Motor ports, in the motor's own frame: positive is the direction the motor turns for a
+   * positive command before PROS reverses it.
+   */
+  void setVoltage(std::uint8_t iport, double ivolts);
+  void setVelocity(std::uint8_t iport, double irpm);
+  void setPosition(std::uint8_t iport, double idegrees, double imaxRpm);
+  void setBrake(std::uint8_t iport, bool ibrake);
+  void setFreeSpeed(std::uint8_t iport, double irpm);
+  double getPosition(std::uint8_t iport);
+  double getVelocity(std::uint8_t iport) const;
+  double getVoltage(std::uint8_t iport) const;
+  double getCurrent(std::uint8_t iport) const;
+  double getTorque(std::uint8_t iport) const;
+
+  /*
+   * ADI ports, 1 to 8.
+   */
+  std::int32_t getAnalog(std::uint8_t iport) const;
+  bool getDigital(std::uint8_t iport) const;
+  std::int32_t getEncoder(std::uint8_t itopPort);
+
+  /**
+   * @return The chassis heading in degrees, counter-clockwise.
+   */
+  double getHeading() const;
+
+  double getBatteryVoltage() const;
+
+  protected:
+  enum class Control { voltage, velocity, position };
+
+  struct Mechanism {
+    Control control{Control::voltage};
+    double target{0}; // V, rpm or degrees, per `control`
+    double maxRpm{0};
+    bool brake{false};
+    double freeRpm{200};
+    double rpm{0};
+    double degrees{0};
+    double volts{0};
+  };
+
+  static constexpr std::size_t motorPorts = 21;
+  static constexpr std::size_t adiPorts = 8;
+  static constexpr double responseTime = 0.05; // sec, mechanism velocity time constant
+  static constexpr double coastTime = 0.3;     // sec, unpowered spin-down time constant
+  static constexpr double positionKp = 2;      // rpm per degree of error
+
+  Params params;
+  std::shared_ptr<SkidSteerSimulator> sim;
+  std::array<int, motorPorts + 1> driveSide;    // -1 for a mechanism
+  std::array<int, adiPorts + 1> trackingSide;   // -1 if not a tracking wheel
+  std::array<Mechanism, motorPorts + 1> mechanisms;
+  std::array<std::function<std::int32_t()>, adiPorts + 1> analogInputs;
+  std::array<std::function<bool()>, adiPorts + 1> digitalInputs;
+  std::mt19937 random;
+  std::normal_distribution<double> noise{0, 1};
+
+  SimulatedRobot();
+
+  /**
+   * @return +1 for the left side and -1 for the mirrored right side.
+   */
+  static double mount(int iside);
+
+  static SkidSteerSimulator::Side toSide(int iside);
+};
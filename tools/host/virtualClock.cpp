@@ -0,0 +1,338 @@
+#include "virtualClock.hpp"
+#include <algorithm>
+
+using namespace okapi;
+
+bool VirtualClock::Event::operator>(const Event &other) const {
+  if (wakeUs != other.wakeUs) {
+    return wakeUs > other.wakeUs;
+  }
+  if (prio != other.prio) {
+    return prio < other.prio;
+  }
+  return seq > other.seq;
+}
+
+VirtualClock &VirtualClock::get() {
+  // Never destroyed: objects on abandoned tasks' stacks may still reference it at exit
+  static VirtualClock *clock = new VirtualClock();
+  return *clock;
+}
+
+VirtualClock::RunResult VirtualClock::run(std::function<void()> iroutine,
+                                          const std::uint32_t itimeoutMs,
+                                          const char *iname) {
+  const std::uint64_t start = now;
+  deadline = now + static_cast<std::uint64_t>(itimeoutMs) * 1000;
+  routineDone = false;
+  paused = false;
+
+  Task *routine = createTask(
+    [this, iroutine = std::move(iroutine)]() {
+      iroutine();
+      routineDone = true;
+    },
+    8,
+    iname);
+  schedule(routine, now);
+
+  // Everything left waiting from the last run resumes alongside the routine
+  yield();
+  return {routineDone, (now - start) / 1000.0};
+}
+
+void VirtualClock::reset() {
+  // Abandoned tasks are never switched to again, so their stacks can go
+  events = decltype(events)();
+  tasks.clear();
+  running = nullptr;
+  now = 0;
+  switches = 0;
+}
+
+std::uint64_t VirtualClock::micros() const {
+  return now;
+}
+
+std::uint32_t VirtualClock::millis() {
+  poll();
+  return static_cast<std::uint32_t>(now / 1000);
+}
+
+void VirtualClock::sleepUntil(const std::uint64_t iwakeUs) {
+  if (!running) {
+    // Outside of any task nothing else can be due, so time simply passes
+    advanceTo(iwakeUs);
+    return;
+  }
+
+  schedule(running, std::max(now, iwakeUs));
+  yield();
+}
+
+void VirtualClock::delay(const std::uint32_t ims) {
+  sleepUntil(now + static_cast<std::uint64_t>(ims) * 1000);
+}
+
+void VirtualClock::poll() {
+  if (running && ++running->polls >= pollsPerTick) {
+    sleepUntil(now + 1000);
+  }
+}
+
+void *VirtualClock::spawn(std::function<void()> ifunction,
+                          const std::uint32_t iprio,
+                          const char *iname) {
+  Task *task = createTask(std::move(ifunction), iprio, iname);
+  schedule(task, now);
+  return task;
+}
+
+void VirtualClock::remove(void *itask) {
+  Task *task = itask ? toTask(itask) : running;
+  if (task && task->state != State::done) {
+    // A waiting task's pending wake-up is skipped when it comes due
+    finish(task);
+  }
+}
+
+void VirtualClock::suspend(void *itask) {
+  Task *task = itask ? toTask(itask) : running;
+  if (!task || task->state == State::done) {
+    return;
+  }
+
+  task->state = State::suspended;
+  if (task == running) {
+    yield();
+  }
+}
+
+void VirtualClock::resume(void *itask) {
+  Task *task = toTask(itask);
+  if (task && task->state == State::suspended) {
+    schedule(task, std::max(now, task->wakeUs));
+  }
+}
+
+void *VirtualClock::current() const {
+  return running;
+}
+
+const char *VirtualClock::getName(void *itask) const {
+  const Task *task = itask ? toTask(itask) : running;
+  return task ? task->name.c_str() : "";
+}
+
+void *VirtualClock::getByName(const char *iname) const {
+  for (const auto &task : tasks) {
+    if (task->state != State::done && task->name == iname) {
+      return task.get();
+    }
+  }
+  return nullptr;
+}
+
+VirtualClock::State VirtualClock::getState(void *itask) const {
+  const Task *task = itask ? toTask(itask) : running;
+  return task ? task->state : State::done;
+}
+
+std::uint32_t VirtualClock::getPriority(void *itask) const {
+  const Task *task = itask ? toTask(itask) : running;
+  return task ? task->prio : 0;
+}
+
+void VirtualClock::setPriority(void *itask, const std::uint32_t iprio) {
+  if (Task *task = itask ? toTask(itask) : running) {
+    task->prio = iprio;
+  }
+}
+
+std::uint32_t VirtualClock::getTaskCount() const {
+  return static_cast<std::uint32_t>(std::count_if(
+    tasks.begin(), tasks.end(), [](const auto &task) { return task->state != State::done; }));
+}
+
+std::uint32_t VirtualClock::notify(void *itask, const std::uint32_t ivalue, const bool iset) {
+  Task *task = toTask(itask);
+  if (!task) {
+    return 0;
+  }
+  const std::uint32_t previous = task->notification;
+  task->notification = iset ? ivalue : task->notification + ivalue;
+  return previous;
+}
+
+std::uint32_t VirtualClock::notifyTake(const bool iclearOnExit, const std::uint32_t itimeoutMs) {
+  if (!running) {
+    return 0;
+  }
+
+  const std::uint64_t timeout =
+    itimeoutMs == UINT32_MAX ? UINT64_MAX : now + static_cast<std::uint64_t>(itimeoutMs) * 1000;
+  while (true) {
+    if (const std::uint32_t value = running->notification; value > 0) {
+      running->notification = iclearOnExit ? 0 : value - 1;
+      return value;
+    }
+    if (now >= timeout) {
+      return 0;
+    }
+    delay(1);
+  }
+}
+
+void VirtualClock::notifyWhenDeleting(void *itarget, void *inotify) {
+  Task *target = toTask(itarget);
+  Task *notify = inotify ? toTask(inotify) : running;
+  if (target && notify) {
+    target->notifyOnDelete.push_back(notify);
+  }
+}
+
+void VirtualClock::setAdvanceCallback(
+  std::function<void(std::uint64_t, std::uint64_t)> ionAdvance) {
+  onAdvance = std::move(ionAdvance);
+}
+
+std::uint64_t VirtualClock::getSwitchCount() const {
+  return switches;
+}
+
+void VirtualClock::setPollsPerTick(const std::uint32_t ipolls) {
+  pollsPerTick = std::max<std::uint32_t>(1, ipolls);
+}
+
+TimeUtil VirtualClock::createTimeUtil(const double iatTargetError,
+                                      const double iatTargetDerivative,
+                                      const QTime iatTargetTime) {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<VirtualTimer>(); }),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<VirtualRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>([=]() {
+      return std::make_unique<SettledUtil>(
+        std::make_unique<VirtualTimer>(), iatTargetError, iatTargetDerivative, iatTargetTime);
+    }));
+}
+
+VirtualClock::Task *VirtualClock::createTask(std::function<void()> ifunction,
+                                             const std::uint32_t iprio,
+                                             const char *iname) {
+  auto task = std::make_unique<Task>();
+  task->id = tasks.size();
+  task->name = iname ? iname : "";
+  task->prio = iprio;
+  task->function = std::move(ifunction);
+  task->stack = std::make_unique<char[]>(stackSize);
+
+  getcontext(&task->context);
+  task->context.uc_stack.ss_sp = task->stack.get();
+  task->context.uc_stack.ss_size = stackSize;
+  task->context.uc_link = nullptr;
+  makecontext(&task->context, &VirtualClock::entry, 0);
+
+  tasks.push_back(std::move(task));
+  return tasks.back().get();
+}
+
+void VirtualClock::schedule(Task *itask, const std::uint64_t iwakeUs) {
+  itask->state = State::waiting;
+  itask->wakeUs = iwakeUs;
+  events.push({iwakeUs, itask->prio, seq++, itask});
+}
+
+VirtualClock::Task *VirtualClock::pickNext() {
+  while (!events.empty()) {
+    const Event next = events.top();
+    if (routineDone || next.wakeUs > deadline) {
+      break;
+    }
+    events.pop();
+
+    // Removed tasks and tasks suspended while waiting are skipped
+    if (next.task->state != State::waiting || next.task->wakeUs != next.wakeUs) {
+      continue;
+    }
+
+    advanceTo(next.wakeUs);
+    next.task->state = State::running;
+    next.task->polls = 0;
+    return next.task;
+  }
+
+  // The routine finished, ran out of time, or nothing is left to run
+  if (!routineDone && !events.empty()) {
+    advanceTo(deadline);
+  }
+  paused = true;
+  return nullptr;
+}
+
+void VirtualClock::yield() {
+  Task *const from = running;
+  Task *const next = pickNext();
+  if (next == from) {
+    return;
+  }
+
+  switches++;
+  running = next;
+  swapcontext(from ? &from->context : &driverContext, next ? &next->context : &driverContext);
+}
+
+void VirtualClock::entry() {
+  VirtualClock &clock = get();
+  Task *const task = clock.running;
+  task->function();
+  clock.finish(task);
+}
+
+void VirtualClock::finish(Task *itask) {
+  itask->state = State::done;
+  for (Task *notify : itask->notifyOnDelete) {
+    notify->notification++;
+  }
+
+  if (itask == running) {
+    // A done task is never picked again, so this never returns
+    yield();
+  }
+}
+
+void VirtualClock::advanceTo(const std::uint64_t itimeUs) {
+  if (itimeUs > now) {
+    if (onAdvance) {
+      onAdvance(now, itimeUs);
+    }
+    now = itimeUs;
+  }
+}
+
+VirtualClock::Task *VirtualClock::toTask(void *itask) {
+  return static_cast<Task *>(itask);
+}
+
+VirtualTimer::VirtualTimer()
+  : AbstractTimer(VirtualClock::get().micros() / 1000.0 * millisecond) {
+}
+
+QTime VirtualTimer::millis() const {
+  return VirtualClock::get().micros() / 1000.0 * millisecond;
+}
+
+VirtualRate::VirtualRate() : lastTime(static_cast<std::uint32_t>(VirtualClock::get().micros() / 1000)) {
+}
+
+void VirtualRate::delay(const QFrequency ihz) {
+  delayUntil(1000 / ihz.convert(Hz));
+}
+
+void VirtualRate::delayUntil(const QTime itime) {
+  delayUntil(static_cast<uint32_t>(itime.convert(millisecond)));
+}
+
+void VirtualRate::delayUntil(const uint32_t ims) {
+  lastTime += ims;
+  VirtualClock::get().sleepUntil(static_cast<std::uint64_t>(lastTime) * 1000);
+}
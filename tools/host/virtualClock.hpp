@@ -0,0 +1,269 @@
+#pragma once
+
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <ucontext.h>
+#include <vector>
+
+/**
+ * A discrete-event clock that stands in for the V5's RTOS on the host. Every task is a coroutine
+ * with its own stack, switched with `swapcontext` on the calling thread, so only one runs at a
+ * time: a task runs until it waits (`delay`, `task_delay_until`, a taken mutex, a notification),
+ * then the clock jumps straight to the earliest pending wake-up and switches to that task. Ties go
+ * to the higher priority and then to the task which started waiting first, so a routine always
+ * runs the same way.
+ *
+ * Busy-waits such as `while (pros::c::millis() - start <= 750)` never wait, so every
+ * `pollsPerTick` polls of the clock or of a device cost a task one millisecond, the way the V5's
+ * time slicing would preempt it.
+ *
+ * The process has one clock, used from one thread. Robot code must run inside `run()`; the host
+ * shims for `pros::delay`, `pros::c::millis`, `pros::Task` and `pros::Mutex` forward here.
+ */
+class VirtualClock {
+  public:
+  enum class State { ready, running, waiting, suspended, done };
+
+  struct RunResult {
+    bool completed{false}; // false if the timeout was reached first
+    double durationMs{0};  // simulated time the routine took
+  };
+
+  /**
+   * @return The process' clock.
+   */
+  static VirtualClock &get();
+
+  /**
+   * Runs a routine as a new task until it returns or `itimeoutMs` of simulated time pass, while
+   * every other task keeps running around it. Afterwards all tasks are paused until the next call,
+   * so background tasks started by one routine (e.x. `initialize()`) carry on in the next.
+   *
+   * @param iroutine The routine.
+   * @param itimeoutMs The simulated time limit.
+   * @param iname The routine task's name.
+   * @return Whether the routine completed and how long it took.
+   */
+  RunResult run(std::function<void()> iroutine,
+                std::uint32_t itimeoutMs,
+                const char *iname = "User Autonomous (PROS)");
+
+  /**
+   * Abandons every task and rewinds the clock to zero.
+   */
+  void reset();
+
+  /**
+   * @return The simulated time in microseconds.
+   */
+  std::uint64_t micros() const;
+
+  /**
+   * @return The simulated time in milliseconds. Counts as a poll for the calling task.
+   */
+  std::uint32_t millis();
+
+  /**
+   * Waits until a simulated time in microseconds. Waiting for a time already past yields to other
+   * tasks due now.
+   */
+  void sleepUntil(std::uint64_t iwakeUs);
+
+  /**
+   * Waits for a number of simulated milliseconds.
+   */
+  void delay(std::uint32_t ims);
+
+  /**
+   * Accounts one poll of the clock or a device by the calling task, and preempts it for a
+   * millisecond every `pollsPerTick` polls without a wait.
+   */
+  void poll();
+
+  /**
+   * Starts a task. It first runs when the calling task next waits.
+   *
+   * @return The task's handle.
+   */
+  void *spawn(std::function<void()> ifunction, std::uint32_t iprio, const char *iname);
+
+  /**
+   * Removes a task. Removing the calling task (or null) never returns.
+   */
+  void remove(void *itask);
+
+  void suspend(void *itask);
+
+  void resume(void *itask);
+
+  /**
+   * @return The calling task's handle, or null outside of a task.
+   */
+  void *current() const;
+
+  const char *getName(void *itask) const;
+
+  /**
+   * @return The first task with a name, or null.
+   */
+  void *getByName(const char *iname) const;
+
+  State getState(void *itask) const;
+
+  std::uint32_t getPriority(void *itask) const;
+
+  void setPriority(void *itask, std::uint32_t iprio);
+
+  /**
+   * @return The number of tasks which have not finished or been removed.
+   */
+  std::uint32_t getTaskCount() const;
+
+  /**
+   * Adds to a task's notification value.
+   */
+  std::uint32_t notify(void *itask, std::uint32_t ivalue, bool iset);
+
+  /**
+   * Waits up to `itimeoutMs` for the calling task's notification value to become non-zero.
+   *
+   * @return The value before it was cleared or decremented.
+   */
+  std::uint32_t notifyTake(bool iclearOnExit, std::uint32_t itimeoutMs);
+
+  /**
+   * Notifies `inotify` once `itarget` finishes or is removed.
+   */
+  void notifyWhenDeleting(void *itarget, void *inotify);
+
+  /**
+   * Calls `ionAdvance(fromUs, toUs)` whenever simulated time moves forward, before the next task
+   * runs. Simulations step here instead of in a task, which would cost a switch every timestep.
+   * The callback must not wait.
+   */
+  void setAdvanceCallback(std::function<void(std::uint64_t, std::uint64_t)> ionAdvance);
+
+  /**
+   * @return The number of task switches so far.
+   */
+  std::uint64_t getSwitchCount() const;
+
+  /**
+   * Polls per millisecond of busy-waiting. The default of 16 suits loops which poll once or
+   * twice per iteration.
+   */
+  void setPollsPerTick(std::uint32_t ipolls);
+
+  /**
+   * A TimeUtil whose timers and rates run on this clock, for okapi controllers constructed
+   * directly instead of through TimeUtilFactory.
+   */
+  okapi::TimeUtil createTimeUtil(double iatTargetError = 50,
+                                 double iatTargetDerivative = 5,
+                                 okapi::QTime iatTargetTime = 250 * okapi::millisecond);
+
+  protected:
+  struct Task {
+    std::uint64_t id;
+    std::string name;
+    std::uint32_t prio;
+    std::function<void()> function;
+    std::unique_ptr<char[]> stack;
+    ucontext_t context;
+    State state{State::ready};
+    std::uint64_t wakeUs{0};
+    std::uint32_t polls{0};
+    std::uint32_t notification{0};
+    std::vector<Task *> notifyOnDelete;
+  };
+
+  struct Event {
+    std::uint64_t wakeUs;
+    std::uint32_t prio;
+    std::uint64_t seq;
+    Task *task;
+
+    bool operator>(const Event &other) const;
+  };
+
+  std::vector<std::unique_ptr<Task>> tasks;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+  Task *running{nullptr}; // null while `run()` itself has control
+  ucontext_t driverContext;
+  std::uint64_t now{0};
+  std::uint64_t seq{0};
+  std::uint64_t switches{0};
+  std::uint64_t deadline{0};
+  bool paused{true};
+  bool routineDone{false};
+  std::uint32_t pollsPerTick{16};
+  std::function<void(std::uint64_t, std::uint64_t)> onAdvance;
+
+  static constexpr std::size_t stackSize = 1 << 20;
+
+  VirtualClock() = default;
+
+  Task *createTask(std::function<void()> ifunction, std::uint32_t iprio, const char *iname);
+
+  void schedule(Task *itask, std::uint64_t iwakeUs);
+
+  /**
+   * Picks the next due task and advances time to it. Returns null, pausing the clock, if the
+   * routine finished or the deadline passed.
+   */
+  Task *pickNext();
+
+  /**
+   * Switches from the running task (or `run()`) to the next due one. Returns once the caller is
+   * picked again.
+   */
+  void yield();
+
+  /**
+   * Where every task's coroutine starts.
+   */
+  static void entry();
+
+  /**
+   * Moves simulated time forward, never back, and runs the advance callback.
+   */
+  void advanceTo(std::uint64_t itimeUs);
+
+  /**
+   * Marks a task done and notifies its watchers. A running task never returns from this.
+   */
+  void finish(Task *itask);
+
+  static Task *toTask(void *itask);
+};
+
+/**
+ * An AbstractTimer on the virtual clock.
+ */
+class VirtualTimer : public okapi::AbstractTimer {
+  public:
+  VirtualTimer();
+
+  okapi::QTime millis() const override;
+};
+
+/**
+ * An AbstractRate on the virtual clock, with okapi::Rate's semantics.
+ */
+class VirtualRate : public okapi::AbstractRate {
+  public:
+  VirtualRate();
+
+  void delay(okapi::QFrequency ihz) override;
+  void delayUntil(okapi::QTime itime) override;
+  void delayUntil(uint32_t ims) override;
+
+  protected:
+  std::uint32_t lastTime{0};
+};
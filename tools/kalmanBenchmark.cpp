@@ -0,0 +1,184 @@
+/*
+ * Times a FixedKalmanFilter predict and update at typical state and measurement sizes, in ns and,
+ * on x86, in TSC cycles. It then runs DriveStateEstimator on a simulated drive with the V5's
+ * sensors: 360 tick tracking wheels, noisy motor velocities and a noisy gyro. Each side's velocity
+ * estimate is compared against the truth, against the tracking wheel ticks differenced over the
+ * loop's dt, and against the motor velocities taken as they are.
+ *
+ * Usage: kalmanBenchmark [updates]
+ */
+#include "driveStateEstimator.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+using namespace okapi;
+
+namespace {
+/**
+ * The elapsed time and, where there is a cycle counter, cycles of a section of code.
+ */
+class Stopwatch {
+  public:
+  void start() {
+    startTime = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+    startCycles = __rdtsc();
+#endif
+  }
+
+  void stop() {
+#ifdef HAVE_TSC
+    cycles += __rdtsc() - startCycles;
+#endif
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime)
+            .count();
+  }
+
+  double ns{0};
+  double cycles{0};
+
+  protected:
+  std::chrono::steady_clock::time_point startTime;
+  unsigned long long startCycles{0};
+};
+
+void report(const char *iname, const Stopwatch &iwatch, const std::size_t icount) {
+#ifdef HAVE_TSC
+  printf("  %-24s %10.1f ns %10.0f cycles\n", iname, iwatch.ns / icount, iwatch.cycles / icount);
+#else
+  printf("  %-24s %10.1f ns\n", iname, iwatch.ns / icount);
+#endif
+}
+
+/**
+ * A constant-velocity model of N / 2 independent axes, observed through M of its positions.
+ */
+template <std::size_t N, std::size_t M> void benchmarkFilter(const std::size_t iupdates) {
+  static_assert(N % 2 == 0 && M <= N / 2, "N / 2 axes, M of them measured");
+  const double dt = 0.01;
+  auto F = FixedMatrix<N, N>::identity();
+  auto Q = FixedMatrix<N, N>::identity() * 1e-4;
+  FixedMatrix<M, N> H;
+  auto R = FixedMatrix<M, M>::identity() * 1e-2;
+  for (std::size_t axis = 0; axis < N / 2; axis++) {
+    F(2 * axis, 2 * axis + 1) = dt;
+  }
+  for (std::size_t m = 0; m < M; m++) {
+    H(m, 2 * m) = 1;
+  }
+
+  std::vector<FixedVector<M>> measurements(iupdates);
+  for (std::size_t i = 0; i < iupdates; i++) {
+    for (std::size_t m = 0; m < M; m++) {
+      measurements[i][m] = std::sin(i * dt + m);
+    }
+  }
+
+  // Timed as a whole, since one call is too short to time on its own
+  FixedKalmanFilter<N> filter(FixedVector<N>(), FixedMatrix<N, N>::identity());
+  Stopwatch watch;
+  watch.start();
+  for (const auto &z : measurements) {
+    filter.predict(F, Q);
+    filter.update(z, H, R);
+  }
+  watch.stop();
+
+  report((std::to_string(N) + " states, " + std::to_string(M) + " measured").c_str(),
+         watch,
+         iupdates);
+  // Keep the filter from being optimized out
+  if (std::isnan(filter.getState()[0])) {
+    printf("  diverged\n");
+  }
+}
+
+/**
+ * A drive following a smooth, turning profile, read by the V5's sensors every `iloop`.
+ */
+void simulateDrive(const QTime iloop, const double iseconds) {
+  DriveStateEstimator estimator;
+  const auto &config = estimator.getConfig();
+  const double metersPerTick =
+    1_pi * config.trackingScales.wheelDiameter.convert(meter) / config.trackingScales.tpr;
+  const double rpmPerMps = 60 / (1_pi * config.driveWheelDiameter.convert(meter));
+  const double track = config.trackingScales.wheelTrack.convert(meter);
+
+  std::mt19937 random(2);
+  std::normal_distribution<double> motorNoise(0, 3); // rpm
+  std::normal_distribution<double> gyroNoise(0, 1);  // deg/s
+
+  const double dt = iloop.convert(second);
+  double left = 0, right = 0;
+  double lastLeftTicks = 0, lastRightTicks = 0;
+  double estimateError = 0, differenceError = 0, motorError = 0;
+  std::size_t steps = 0, count = 0;
+  Stopwatch step;
+  for (double t = 0; t < iseconds; t += dt) {
+    const double leftVelocity = 1.2 * std::sin(t * 0.8) + 0.3 * std::sin(t * 3.1);
+    const double rightVelocity = 1.2 * std::sin(t * 0.8) - 0.3 * std::sin(t * 2.3);
+    left += leftVelocity * dt;
+    right += rightVelocity * dt;
+
+    const auto leftTicks = static_cast<std::int32_t>(std::floor(left / metersPerTick));
+    const auto rightTicks = static_cast<std::int32_t>(std::floor(right / metersPerTick));
+    const double yawRate = (leftVelocity - rightVelocity) / track * 180 / 1_pi + gyroNoise(random);
+
+    // The V5 reports motor velocities in whole rpm
+    const double leftMotor = std::round(leftVelocity * rpmPerMps + motorNoise(random));
+    const double rightMotor = std::round(rightVelocity * rpmPerMps + motorNoise(random));
+
+    step.start();
+    estimator.step(iloop, leftTicks, rightTicks, leftMotor, rightMotor, yawRate * degree / second);
+    step.stop();
+    steps++;
+
+    const double leftDifference = (leftTicks - lastLeftTicks) * metersPerTick / dt;
+    const double rightDifference = (rightTicks - lastRightTicks) * metersPerTick / dt;
+    lastLeftTicks = leftTicks;
+    lastRightTicks = rightTicks;
+    if (t < 1) {
+      continue;
+    }
+
+    estimateError += std::pow(estimator.getLeft().velocity.convert(mps) - leftVelocity, 2) +
+                     std::pow(estimator.getRight().velocity.convert(mps) - rightVelocity, 2);
+    differenceError +=
+      std::pow(leftDifference - leftVelocity, 2) + std::pow(rightDifference - rightVelocity, 2);
+    motorError += std::pow(leftMotor / rpmPerMps - leftVelocity, 2) +
+                  std::pow(rightMotor / rpmPerMps - rightVelocity, 2);
+    count += 2;
+  }
+
+  const int loopMs = static_cast<int>(iloop.convert(millisecond));
+  report(("drive, " + std::to_string(loopMs) + " ms loop").c_str(), step, steps);
+  printf("    velocity RMS error, m/s: estimate %.4f, differenced ticks %.4f, motors %.4f\n",
+         std::sqrt(estimateError / count),
+         std::sqrt(differenceError / count),
+         std::sqrt(motorError / count));
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const std::size_t updates = argc > 1 ? std::stoul(argv[1]) : 200000;
+  printf("FixedKalmanFilter, per predict and update\n");
+  benchmarkFilter<2, 1>(updates);
+  benchmarkFilter<4, 2>(updates);
+  benchmarkFilter<6, 2>(updates);
+  benchmarkFilter<6, 3>(updates);
+  benchmarkFilter<12, 4>(updates);
+
+  printf("\nDriveStateEstimator, per step (predict and three updates)\n");
+  simulateDrive(10_ms, 300);
+  simulateDrive(5_ms, 300);
+  return 0;
+}
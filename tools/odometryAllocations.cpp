@@ -0,0 +1,172 @@
+/*
+ * Counts heap allocations and time per odometry step, okapi's TwoEncoderOdometry and
+ * ThreeEncoderOdometry against FixedTwoEncoderOdometry and FixedThreeEncoderOdometry, on the same
+ * scripted sensor readings. The fixed versions must allocate nothing per step and land on the same
+ * pose.
+ *
+ * Usage: odometryAllocations [steps]
+ */
+#include "fixedOdometry.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace okapi;
+
+namespace {
+std::atomic<std::size_t> allocations{0};
+
+/**
+ * N tracking wheels (left, right, middle) driving a gentle S-curve, advanced by hand between steps.
+ */
+template <std::size_t N>
+class ScriptedModel : public ReadOnlyChassisModel, public FixedSensorModel<N> {
+  public:
+  std::valarray<std::int32_t> getSensorVals() const override {
+    return std::valarray<std::int32_t>(ticks.data(), N);
+  }
+
+  std::array<std::int32_t, N> getSensorArray() const override {
+    return ticks;
+  }
+
+  void advance(const std::size_t istep) {
+    const double t = istep * 0.01;
+    const std::int32_t steps[] = {static_cast<std::int32_t>(std::lround(8 + 3 * std::sin(t))),
+                                  static_cast<std::int32_t>(std::lround(8 - 3 * std::sin(t))),
+                                  static_cast<std::int32_t>(std::lround(2 * std::cos(t * 0.7)))};
+    for (std::size_t i = 0; i < N; i++) {
+      ticks[i] += steps[i];
+    }
+  }
+
+  std::array<std::int32_t, N> ticks{};
+};
+
+/**
+ * Reads a time the loop advances by 10 ms before each step, so every step has a time difference.
+ */
+class SteppedTimer : public AbstractTimer {
+  public:
+  explicit SteppedTimer(std::shared_ptr<const std::uint32_t> inow)
+    : AbstractTimer(*inow * millisecond), now(std::move(inow)) {
+  }
+
+  QTime millis() const override {
+    return *now * millisecond;
+  }
+
+  protected:
+  std::shared_ptr<const std::uint32_t> now;
+};
+
+class NoRate : public AbstractRate {
+  public:
+  void delay(QFrequency) override {
+  }
+  void delayUntil(QTime) override {
+  }
+  void delayUntil(uint32_t) override {
+  }
+};
+
+struct Result {
+  double allocationsPerStep;
+  double nsPerStep;
+  OdomState state;
+};
+
+template <typename O, std::size_t N>
+Result run(const std::size_t isteps, const ChassisScales &iscales) {
+  auto now = std::make_shared<std::uint32_t>(0);
+  std::shared_ptr<const std::uint32_t> clock = now;
+  auto timer = [=]() { return std::make_unique<SteppedTimer>(clock); };
+  const TimeUtil timeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>(timer),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<NoRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>(
+      [=]() { return std::make_unique<SettledUtil>(timer()); }));
+
+  auto model = std::make_shared<ScriptedModel<N>>();
+  O odometry(timeUtil, model, iscales);
+
+  std::size_t allocated = 0;
+  std::chrono::steady_clock::duration elapsed{};
+  for (std::size_t i = 0; i < isteps; i++) {
+    *now += 10;
+    model->advance(i);
+
+    const std::size_t before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    odometry.step();
+    elapsed += std::chrono::steady_clock::now() - start;
+    allocated += allocations - before;
+  }
+
+  return {static_cast<double>(allocated) / isteps,
+          std::chrono::duration<double, std::nano>(elapsed).count() / isteps,
+          odometry.getState()};
+}
+
+void report(const char *iname, const Result &iresult) {
+  printf("  %-26s %6.2f allocations/step  %7.1f ns/step  (%.4f m, %.4f m, %.2f deg)\n",
+         iname,
+         iresult.allocationsPerStep,
+         iresult.nsPerStep,
+         iresult.state.x.convert(meter),
+         iresult.state.y.convert(meter),
+         iresult.state.theta.convert(degree));
+}
+
+double difference(const Result &a, const Result &b) {
+  return std::max({std::abs((a.state.x - b.state.x).convert(meter)),
+                   std::abs((a.state.y - b.state.y).convert(meter)),
+                   std::abs((a.state.theta - b.state.theta).convert(radian))});
+}
+} // namespace
+
+void *operator new(const std::size_t isize) {
+  allocations++;
+  if (void *p = std::malloc(isize ? isize : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *iptr) noexcept {
+  std::free(iptr);
+}
+
+void operator delete(void *iptr, std::size_t) noexcept {
+  std::free(iptr);
+}
+
+int main(int argc, char *argv[]) {
+  const std::size_t steps = argc > 1 ? std::stoul(argv[1]) : 100000;
+  const ChassisScales twoScales({2.75_in, 5.25_in}, quadEncoderTPR);
+  const ChassisScales threeScales({2.75_in, 5.25_in, 4_in, 2.75_in}, quadEncoderTPR);
+
+  printf("%zu steps\n", steps);
+  const auto two = run<TwoEncoderOdometry, 2>(steps, twoScales);
+  const auto fixedTwo = run<FixedTwoEncoderOdometry, 2>(steps, twoScales);
+  const auto three = run<ThreeEncoderOdometry, 3>(steps, threeScales);
+  const auto fixedThree = run<FixedThreeEncoderOdometry, 3>(steps, threeScales);
+  report("TwoEncoderOdometry", two);
+  report("FixedTwoEncoderOdometry", fixedTwo);
+  report("ThreeEncoderOdometry", three);
+  report("FixedThreeEncoderOdometry", fixedThree);
+
+  const double twoDiff = difference(two, fixedTwo);
+  const double threeDiff = difference(three, fixedThree);
+  printf("Largest pose difference: two encoders %.3g, three encoders %.3g\n", twoDiff, threeDiff);
+
+  const bool ok = fixedTwo.allocationsPerStep == 0 && fixedThree.allocationsPerStep == 0 &&
+                  twoDiff < 1e-9 && threeDiff < 1e-9;
+  printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
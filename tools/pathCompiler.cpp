@@ -0,0 +1,315 @@
+/*
+ * Host-side batch compiler for the autonomous playbook.
+ *
+ * Reads a playbook file, generates every path with the same Pathfinder calls that
+ * AsyncMotionProfileController::generatePath makes on the robot, and writes the
+ * `<pathId>.left.csv` / `<pathId>.right.csv` pairs that AsyncMotionProfileController::loadPath
+ * reads back. Paths are generated in parallel, one job per path and alliance color.
+ *
+ * Usage: pathCompiler <playbook> <output directory> [threads]
+ *
+ * Playbook format (one directive per line, '#' starts a comment, units are meters/radians):
+ *
+ *   track 0.13335              wheel track used by pathfinder_modify_tank
+ *   limits 1.097 4.7 5.75      default max velocity, acceleration, jerk
+ *   path S sides               start a path; "sides" also emits the mirrored alliance
+ *   point 0 0 0                waypoint x y theta
+ *   limits 1.0 3.0 5.0         per-path limits (only inside a path)
+ *   variants backwards         setTarget() flags this path is run with (summary only)
+ *
+ * A path marked "sides" is written for red as `<pathId>-red` exactly as given and for blue as
+ * `<pathId>-blue` with y and theta negated, matching `sideSelector` in main.cpp.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "okapi/pathfinder/include/pathfinder.h"
+}
+
+namespace {
+struct Limits {
+  double maxVel;
+  double maxAccel;
+  double maxJerk;
+};
+
+struct PathSpec {
+  std::string id;
+  std::vector<Waypoint> points;
+  Limits limits;
+  bool sides{false};
+  std::string variants;
+  int line{0};
+};
+
+struct Job {
+  std::string id;
+  const PathSpec *spec;
+  double sign;
+};
+
+struct Result {
+  bool ok{false};
+  int length{0};
+  double duration{0};
+  double peakVel{0};
+  std::string error;
+};
+
+struct Playbook {
+  double track{0};
+  std::vector<PathSpec> paths;
+};
+
+Playbook parsePlaybook(std::istream &input) {
+  Playbook book;
+  Limits defaults{0, 0, 0};
+  bool haveDefaults = false;
+  PathSpec *current = nullptr;
+  std::string line;
+  int lineNum = 0;
+
+  while (std::getline(input, line)) {
+    lineNum++;
+    if (const auto hash = line.find('#'); hash != std::string::npos) {
+      line.erase(hash);
+    }
+
+    std::istringstream words(line);
+    std::string directive;
+    if (!(words >> directive)) {
+      continue;
+    }
+
+    auto fail = [&](const std::string &why) {
+      throw std::runtime_error("line " + std::to_string(lineNum) + ": " + why);
+    };
+
+    if (directive == "track") {
+      if (!(words >> book.track) || book.track <= 0) {
+        fail("track needs a positive width in meters");
+      }
+    } else if (directive == "limits") {
+      Limits limits{};
+      if (!(words >> limits.maxVel >> limits.maxAccel >> limits.maxJerk)) {
+        fail("limits needs velocity, acceleration and jerk");
+      }
+      if (current) {
+        current->limits = limits;
+      } else {
+        defaults = limits;
+        haveDefaults = true;
+      }
+    } else if (directive == "path") {
+      if (!haveDefaults) {
+        fail("default limits must be given before the first path");
+      }
+      PathSpec spec;
+      spec.limits = defaults;
+      spec.line = lineNum;
+      if (!(words >> spec.id)) {
+        fail("path needs an id");
+      }
+      std::string flag;
+      while (words >> flag) {
+        if (flag == "sides") {
+          spec.sides = true;
+        } else {
+          fail("unknown path flag " + flag);
+        }
+      }
+      book.paths.push_back(spec);
+      current = &book.paths.back();
+    } else if (directive == "point") {
+      Waypoint point{};
+      if (!current || !(words >> point.x >> point.y >> point.angle)) {
+        fail("point needs x y theta inside a path");
+      }
+      current->points.push_back(point);
+    } else if (directive == "variants") {
+      if (!current) {
+        fail("variants must be inside a path");
+      }
+      std::string variant;
+      while (words >> variant) {
+        if (variant != "backwards" && variant != "mirrored") {
+          fail("unknown variant " + variant);
+        }
+        current->variants += (current->variants.empty() ? "" : ",") + variant;
+      }
+    } else {
+      fail("unknown directive " + directive);
+    }
+  }
+
+  if (book.track <= 0) {
+    throw std::runtime_error("playbook does not set the wheel track");
+  }
+
+  return book;
+}
+
+/**
+ * Generates one path the same way AsyncMotionProfileController::generatePath does and stores it
+ * the same way AsyncMotionProfileController::storePath does.
+ */
+Result compile(const Job &job, double track, const std::string &outDir) {
+  Result result;
+  std::vector<Waypoint> points = job.spec->points;
+  for (auto &point : points) {
+    point.y *= job.sign;
+    point.angle *= job.sign;
+  }
+
+  if (points.size() < 2) {
+    result.error = "needs at least two points";
+    return result;
+  }
+
+  TrajectoryCandidate candidate{};
+  pathfinder_prepare(points.data(),
+                     static_cast<int>(points.size()),
+                     FIT_HERMITE_CUBIC,
+                     PATHFINDER_SAMPLES_FAST,
+                     0.010,
+                     job.spec->limits.maxVel,
+                     job.spec->limits.maxAccel,
+                     job.spec->limits.maxJerk,
+                     &candidate);
+
+  const int length = candidate.length;
+  if (length < 0) {
+    free(candidate.saptr);
+    free(candidate.laptr);
+    result.error = "waypoints form an impossible path";
+    return result;
+  }
+
+  std::vector<Segment> trajectory(length), left(length), right(length);
+  // pathfinder_generate releases the candidate's spline buffers
+  pathfinder_generate(&candidate, trajectory.data());
+  pathfinder_modify_tank(trajectory.data(), length, left.data(), right.data(), track);
+
+  const std::string base = outDir + "/" + job.id;
+  FILE *leftFile = fopen((base + ".left.csv").c_str(), "w");
+  FILE *rightFile = fopen((base + ".right.csv").c_str(), "w");
+  if (!leftFile || !rightFile) {
+    if (leftFile) {
+      fclose(leftFile);
+    }
+    if (rightFile) {
+      fclose(rightFile);
+    }
+    result.error = "could not open " + base + ".*.csv for writing";
+    return result;
+  }
+
+  pathfinder_serialize_csv(leftFile, left.data(), length);
+  pathfinder_serialize_csv(rightFile, right.data(), length);
+  fclose(leftFile);
+  fclose(rightFile);
+
+  result.ok = true;
+  result.length = length;
+  for (int i = 0; i < length; i++) {
+    result.duration += trajectory[i].dt;
+    result.peakVel = std::max(result.peakVel, std::abs(trajectory[i].velocity));
+  }
+  return result;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " <playbook> <output directory> [threads]" << std::endl;
+    return 2;
+  }
+
+  std::ifstream input(argv[1]);
+  if (!input) {
+    std::cerr << "cannot open playbook " << argv[1] << std::endl;
+    return 2;
+  }
+
+  Playbook book;
+  try {
+    book = parsePlaybook(input);
+  } catch (const std::runtime_error &e) {
+    std::cerr << argv[1] << ": " << e.what() << std::endl;
+    return 2;
+  }
+
+  std::vector<Job> jobs;
+  for (const auto &spec : book.paths) {
+    if (spec.sides) {
+      jobs.push_back({spec.id + "-red", &spec, 1});
+      jobs.push_back({spec.id + "-blue", &spec, -1});
+    } else {
+      jobs.push_back({spec.id, &spec, 1});
+    }
+  }
+
+  unsigned threadCount = std::thread::hardware_concurrency();
+  if (argc > 3) {
+    try {
+      threadCount = std::stoul(argv[3]);
+    } catch (const std::logic_error &) {
+      // std::invalid_argument for no number, std::out_of_range for one too large
+      std::cerr << "threads must be a number, not " << argv[3] << std::endl;
+      std::cerr << "usage: " << argv[0] << " <playbook> <output directory> [threads]" << std::endl;
+      return 2;
+    }
+  }
+  threadCount = std::clamp(threadCount, 1u, static_cast<unsigned>(std::max<size_t>(jobs.size(), 1)));
+
+  const std::string outDir = argv[2];
+  std::vector<Result> results(jobs.size());
+  std::atomic_size_t next{0};
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < threadCount; i++) {
+    workers.emplace_back([&]() {
+      for (size_t job = next++; job < jobs.size(); job = next++) {
+        results[job] = compile(jobs[job], book.track, outDir);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  int failures = 0;
+  double total = 0;
+  printf("%-16s %9s %10s %10s  %s\n", "path", "segments", "duration", "peak m/s", "variants");
+  for (size_t i = 0; i < jobs.size(); i++) {
+    if (!results[i].ok) {
+      failures++;
+      fprintf(stderr,
+              "%s (line %d): %s\n",
+              jobs[i].id.c_str(),
+              jobs[i].spec->line,
+              results[i].error.c_str());
+      continue;
+    }
+    total += results[i].duration;
+    printf("%-16s %9d %9.2fs %10.3f  %s\n",
+           jobs[i].id.c_str(),
+           results[i].length,
+           results[i].duration,
+           results[i].peakVel,
+           jobs[i].spec->variants.c_str());
+  }
+  printf("%zu paths, %.2fs of motion, %u threads\n", jobs.size() - failures, total, threadCount);
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/*
+ * Runs the same unit-typed math in each representation RepQuantity supports, double, float, and
+ * fixed point with 16 and 24 fraction bits, and reports its time and its error against double:
+ *  - odometry: TwoEncoderOdometry's arc math, on a drive's tracking wheel ticks every 10 ms,
+ *  - profile: a trapezoidal motion profile's position and velocity, evaluated every 10 ms.
+ *
+ * The host's FPU does double about as fast as float, so the times here only show what the
+ * representations cost relative to each other on this machine; run it on the target to compare
+ * them there.
+ *
+ * Usage: quantityBenchmark [steps]
+ */
+#include "fixedPoint.hpp"
+#include "okapi/api/units/QAcceleration.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "repQuantity.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+template <typename Rep> struct Pose {
+  Quantity<Rep, QLength> x;
+  Quantity<Rep, QLength> y;
+  Quantity<Rep, QAngle> theta;
+};
+
+/**
+ * TwoEncoderOdometry's step, from each tracking wheel's ticks since the last step.
+ */
+template <typename Rep>
+void odometryStep(Pose<Rep> &iopose,
+                  const std::int32_t ileftTicks,
+                  const std::int32_t irightTicks,
+                  const Quantity<Rep, QLength> &ilengthPerTick,
+                  const Quantity<Rep, QLength> &itrack) {
+  constexpr auto radianR = quantityCast<Rep>(radian);
+  const Quantity<Rep, QLength> deltaL = Rep(ileftTicks) * ilengthPerTick;
+  const Quantity<Rep, QLength> deltaR = Rep(irightTicks) * ilengthPerTick;
+  const Quantity<Rep, QAngle> deltaTheta = (deltaL - deltaR) / itrack * radianR;
+
+  Quantity<Rep, QLength> localOffY = deltaR;
+  if (deltaTheta != Quantity<Rep, QAngle>()) {
+    const Rep chord = Rep(2) * sin(deltaTheta / Rep(2));
+    localOffY = chord * (deltaR / (deltaTheta / radianR).getValue() + itrack / Rep(2));
+  }
+
+  // The polar math, with no sideways offset, is a rotation by the average heading
+  const Quantity<Rep, QAngle> average = iopose.theta + deltaTheta / Rep(2);
+  iopose.x += localOffY * sin(average);
+  iopose.y += localOffY * cos(average);
+  iopose.theta += deltaTheta;
+}
+
+/**
+ * A trapezoidal profile's setpoint at time `it`: accelerate to `imaxVel`, cruise, decelerate.
+ */
+template <typename Rep>
+void profileStep(const Quantity<Rep, QTime> &it,
+                 const Quantity<Rep, QTime> &iaccelTime,
+                 const Quantity<Rep, QTime> &itotalTime,
+                 const Quantity<Rep, QSpeed> &imaxVel,
+                 const Quantity<Rep, QAcceleration> &imaxAccel,
+                 Quantity<Rep, QLength> &oposition,
+                 Quantity<Rep, QSpeed> &ovelocity) {
+  const Quantity<Rep, QLength> accelDistance = imaxAccel * iaccelTime * iaccelTime / Rep(2);
+  if (it < iaccelTime) {
+    ovelocity = imaxAccel * it;
+    oposition = imaxAccel * it * it / Rep(2);
+  } else if (it < itotalTime - iaccelTime) {
+    ovelocity = imaxVel;
+    oposition = accelDistance + imaxVel * (it - iaccelTime);
+  } else if (it < itotalTime) {
+    const Quantity<Rep, QTime> left = itotalTime - it;
+    ovelocity = imaxAccel * left;
+    oposition = imaxVel * (itotalTime - iaccelTime) - imaxAccel * left * left / Rep(2);
+  } else {
+    ovelocity = Quantity<Rep, QSpeed>();
+    oposition = imaxVel * (itotalTime - iaccelTime);
+  }
+}
+
+struct Ticks {
+  std::vector<std::int32_t> left;
+  std::vector<std::int32_t> right;
+};
+
+Ticks makeTicks(const std::size_t isteps) {
+  Ticks ticks;
+  for (std::size_t i = 0; i < isteps; i++) {
+    const double t = i * 0.01;
+    ticks.left.push_back(static_cast<std::int32_t>(std::lround(6 + 3 * std::sin(t * 0.7))));
+    ticks.right.push_back(static_cast<std::int32_t>(std::lround(6 - 3 * std::sin(t * 0.5))));
+  }
+  return ticks;
+}
+
+struct Result {
+  double ns;
+  double x, y, theta; // odometry's final pose, m and rad
+  double profileSum;  // the sum of the profile's positions and velocities
+};
+
+template <typename Rep> Result run(const Ticks &iticks) {
+  Result result{};
+  const auto lengthPerTick = quantityCast<Rep>(1_pi * 2.75_in / 360);
+  const auto track = quantityCast<Rep>(5.25_in);
+
+  Pose<Rep> pose;
+  const auto odomStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iticks.left.size(); i++) {
+    odometryStep<Rep>(pose, iticks.left[i], iticks.right[i], lengthPerTick, track);
+  }
+  result.ns =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - odomStart).count();
+  result.x = static_cast<double>(pose.x.getValue());
+  result.y = static_cast<double>(pose.y.getValue());
+  result.theta = static_cast<double>(pose.theta.getValue());
+  return result;
+}
+
+template <typename Rep> Result runProfile(const std::size_t isteps) {
+  Result result{};
+  const auto maxVel = quantityCast<Rep>(1.2_mps);
+  const auto maxAccel = quantityCast<Rep>(2.0_mps2);
+  const auto accelTime = quantityCast<Rep>(0.6_s);
+  const auto totalTime = quantityCast<Rep>(4.0_s);
+  const auto period = quantityCast<Rep>(10_ms);
+  const auto restart = quantityCast<Rep>(4.5_s);
+
+  double sum = 0;
+  Quantity<Rep, QTime> time;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < isteps; i++) {
+    Quantity<Rep, QLength> position;
+    Quantity<Rep, QSpeed> velocity;
+    profileStep<Rep>(time, accelTime, totalTime, maxVel, maxAccel, position, velocity);
+    time += period;
+    if (time > restart) {
+      time = Quantity<Rep, QTime>();
+    }
+    sum += static_cast<double>(position.getValue()) + static_cast<double>(velocity.getValue());
+  }
+  result.ns =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  result.profileSum = sum;
+  return result;
+}
+
+template <typename Rep>
+void report(const char *iname,
+            const Ticks &iticks,
+            const Result &iodomTruth,
+            const Result &iprofileTruth) {
+  const std::size_t steps = iticks.left.size();
+  const Result odom = run<Rep>(iticks);
+  const Result profile = runProfile<Rep>(steps);
+  const double poseError = std::hypot(odom.x - iodomTruth.x, odom.y - iodomTruth.y);
+  printf("  %-8s %10.1f %12.2g %12.2g %10.1f %12.2g\n",
+         iname,
+         odom.ns / steps,
+         poseError,
+         std::abs(odom.theta - iodomTruth.theta),
+         profile.ns / steps,
+         std::abs(profile.profileSum - iprofileTruth.profileSum) / steps);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const std::size_t steps = argc > 1 ? std::stoul(argv[1]) : 100000;
+  const Ticks ticks = makeTicks(steps);
+  const Result odomTruth = run<double>(ticks);
+  const Result profileTruth = runProfile<double>(steps);
+
+  printf("%zu steps, ns per step, errors against double\n", steps);
+  printf("                  odometry                               profile\n");
+  printf("  %-8s %10s %12s %12s %10s %12s\n",
+         "rep",
+         "ns",
+         "position m",
+         "heading rad",
+         "ns",
+         "mean error");
+  report<double>("double", ticks, odomTruth, profileTruth);
+  report<float>("float", ticks, odomTruth, profileTruth);
+  report<Q16>("Q16", ticks, odomTruth, profileTruth);
+  report<FixedPoint<24>>("Q24", ticks, odomTruth, profileTruth);
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Compares running autonomous actions as ScriptScheduler scripts on one task against giving each a
+ * task of its own, as main.cpp's straight-line routines do: the memory each action holds, and what
+ * it costs to go from one action to another.
+ *
+ * A task holds its TASK_STACK_DEPTH_DEFAULT stack whether it uses it or not; a script holds its
+ * slot in the scheduler and whatever its captures allocate, both measured here. Switching between
+ * tasks is measured as two host threads handing a turn back and forth, which stands in for the
+ * RTOS' context switch; switching between scripts is the scheduler resuming one that is waiting.
+ *
+ * Usage: scriptBenchmark [actions] [ticks]
+ */
+#include "pros/rtos.h"
+#include "scriptScheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+
+using namespace okapi;
+
+namespace {
+std::atomic<std::size_t> allocatedBytes{0};
+
+/**
+ * Reads a time the benchmark advances by hand between ticks.
+ */
+class SteppedTimer : public AbstractTimer {
+  public:
+  explicit SteppedTimer(std::shared_ptr<const std::uint32_t> inow)
+    : AbstractTimer(*inow * millisecond), now(std::move(inow)) {
+  }
+
+  QTime millis() const override {
+    return *now * millisecond;
+  }
+
+  protected:
+  std::shared_ptr<const std::uint32_t> now;
+};
+
+class NoRate : public AbstractRate {
+  public:
+  void delay(QFrequency) override {
+  }
+  void delayUntil(QTime) override {
+  }
+  void delayUntil(uint32_t) override {
+  }
+};
+
+/**
+ * A script shaped like main.cpp's intakeScript: a delay, a wait on a sensor, then another delay.
+ */
+ScriptScheduler::Body action(const std::atomic_bool &isensor,
+                             const int idelayMs,
+                             const int itimeMs) {
+  return [&isensor, idelayMs, itimeMs](ScriptScheduler::Script &s) {
+    SCRIPT_BEGIN(s);
+    SCRIPT_DELAY(s, idelayMs);
+    SCRIPT_AWAIT(s, isensor.load(std::memory_order_relaxed));
+    SCRIPT_DELAY(s, itimeMs);
+    SCRIPT_END(s);
+  };
+}
+
+/**
+ * @return The average time two threads take to hand a turn to each other.
+ */
+double threadHandoffNs(const std::size_t irounds) {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::size_t turn = 0;
+
+  std::thread other([&] {
+    std::unique_lock<std::mutex> guard(lock);
+    for (std::size_t i = 0; i < irounds; i++) {
+      changed.wait(guard, [&] { return turn % 2 == 1; });
+      turn++;
+      changed.notify_one();
+    }
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    for (std::size_t i = 0; i < irounds; i++) {
+      turn++;
+      changed.notify_one();
+      changed.wait(guard, [&] { return turn % 2 == 0; });
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  other.join();
+  return std::chrono::duration<double, std::nano>(elapsed).count() / (2 * irounds);
+}
+} // namespace
+
+void *operator new(const std::size_t isize) {
+  allocatedBytes += isize;
+  if (void *p = std::malloc(isize ? isize : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *iptr) noexcept {
+  std::free(iptr);
+}
+
+void operator delete(void *iptr, std::size_t) noexcept {
+  std::free(iptr);
+}
+
+int main(int argc, char *argv[]) {
+  const std::size_t actions = argc > 1 ? std::stoul(argv[1]) : 7;
+  const std::size_t ticks = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+  auto now = std::make_shared<std::uint32_t>(0);
+  std::shared_ptr<const std::uint32_t> clock = now;
+  auto timer = [=]() { return std::make_unique<SteppedTimer>(clock); };
+  const TimeUtil timeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>(timer),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<NoRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>(
+      [=]() { return std::make_unique<SettledUtil>(timer()); }));
+
+  ScriptScheduler scheduler(timeUtil, actions);
+  std::atomic_bool sensor{false};
+  const std::size_t before = allocatedBytes;
+  for (std::size_t i = 0; i < actions; i++) {
+    scheduler.spawn("action", action(sensor, 100, 500));
+  }
+  const std::size_t capturedBytes = allocatedBytes - before;
+
+  // Every script reaches the sensor wait, which never holds, so each tick resumes all of them
+  for (std::uint32_t ms = 0; ms <= 100; ms += 10) {
+    *now = ms;
+    scheduler.step();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < ticks; i++) {
+    scheduler.step();
+  }
+  const double resumeNs =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+    (ticks * actions);
+
+  sensor = true;
+  for (std::uint32_t ms = 110; !scheduler.isDone() && ms <= 1000; ms += 10) {
+    *now = ms;
+    scheduler.step();
+  }
+
+  const std::size_t taskBytes = TASK_STACK_DEPTH_DEFAULT * sizeof(std::uint32_t);
+  const std::size_t scriptBytes =
+    sizeof(ScriptScheduler::Script) + (capturedBytes + actions - 1) / actions;
+  printf("%zu actions\n", actions);
+  printf("memory:\n");
+  printf("  task per action   %8zu bytes each, %8zu in all (stack only)\n",
+         taskBytes,
+         taskBytes * actions);
+  printf("  scripts           %8zu bytes each, %8zu in all (%zu slot + %zu captures)\n",
+         scriptBytes,
+         scriptBytes * actions,
+         sizeof(ScriptScheduler::Script),
+         (capturedBytes + actions - 1) / actions);
+  printf("switching:\n");
+  printf("  threads           %8.1f ns per handoff (host threads standing in for tasks)\n",
+         threadHandoffNs(ticks));
+  printf("  scripts           %8.1f ns per resume\n", resumeNs);
+  printf("Either way a wait is noticed on the next 10 ms tick, as the tasks poll at that rate.\n");
+
+  const bool ok = scheduler.isDone();
+  printf("%s\n", ok ? "OK" : "FAILED: scripts didn't finish");
+  return ok ? 0 : 1;
+}
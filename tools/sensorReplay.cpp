@@ -0,0 +1,276 @@
+/*
+ * Host-side replay of sensor logs recorded on the robot by SensorRecorder.
+ *
+ * Feeds the recorded samples through a fresh SensorPipeline (odometry, velocity filters, angle and
+ * heading controllers), several times over, and reports
+ *  - whether every replay produced bit-for-bit the same outputs,
+ *  - how the outputs differ from the ones the robot recorded: samples that match exactly, and the
+ *    largest difference. With the default pipeline these are the same computation, so any
+ *    difference is the V5's libm against the host's,
+ *  - the time each stage takes per sample on this machine,
+ *  - optionally, the final pose against one measured on the field.
+ *
+ * Changing the pipeline with the options shows what a different filter or set of scales would
+ * have produced from the same run, and what it costs.
+ *
+ * Usage: sensorReplay <sensors.csv> [--repeat 5] [--filter ema:0.5] [--wheel 2.75] [--track 5.25]
+ *                     [--truth x_m,y_m,theta_deg] [--out replay.csv]
+ *
+ * Filters are ema:alpha, dema:alpha,beta, average:n, median:n (n of 3, 5, 7, 9 or 15) and none.
+ */
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/demaFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include "sensorPipeline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+const char *const outputNames[] = {
+  "x_m", "y_m", "theta_deg", "left_filtered_rpm", "right_filtered_rpm", "angle_out", "heading_out"};
+constexpr std::size_t outputCount = sizeof(outputNames) / sizeof(outputNames[0]);
+
+double field(const PipelineOutput &ioutput, const std::size_t i) {
+  const double fields[] = {ioutput.x,
+                           ioutput.y,
+                           ioutput.theta,
+                           ioutput.leftVelocity,
+                           ioutput.rightVelocity,
+                           ioutput.angle,
+                           ioutput.heading};
+  return fields[i];
+}
+
+bool sameBits(const double a, const double b) {
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+template <template <std::size_t> class F>
+std::unique_ptr<Filter> windowed(const std::size_t n) {
+  switch (n) {
+  case 3:
+    return std::make_unique<F<3>>();
+  case 5:
+    return std::make_unique<F<5>>();
+  case 7:
+    return std::make_unique<F<7>>();
+  case 9:
+    return std::make_unique<F<9>>();
+  case 15:
+    return std::make_unique<F<15>>();
+  default:
+    return nullptr;
+  }
+}
+
+/**
+ * Parses a filter option, e.x. `ema:0.5`. Returns false if the option isn't one.
+ */
+bool parseFilter(const std::string &ioption, SensorPipeline::Config &oconfig) {
+  const std::size_t colon = ioption.find(':');
+  const std::string name = ioption.substr(0, colon);
+  const std::string args = colon == std::string::npos ? "" : ioption.substr(colon + 1);
+  const double a = args.empty() ? 0 : std::atof(args.c_str());
+  const std::size_t comma = args.find(',');
+  const double b = comma == std::string::npos ? 0 : std::atof(args.c_str() + comma + 1);
+  const auto n = static_cast<std::size_t>(a);
+
+  std::function<std::unique_ptr<Filter>()> make;
+  if (name == "ema" && a > 0) {
+    make = [=]() { return std::make_unique<EmaFilter>(a); };
+  } else if (name == "dema" && a > 0 && b > 0) {
+    make = [=]() { return std::make_unique<DemaFilter>(a, b); };
+  } else if (name == "average" && windowed<AverageFilter>(n)) {
+    make = [=]() { return windowed<AverageFilter>(n); };
+  } else if (name == "median" && windowed<MedianFilter>(n)) {
+    make = [=]() { return windowed<MedianFilter>(n); };
+  } else if (name == "none") {
+    make = []() { return std::make_unique<PassthroughFilter>(); };
+  } else {
+    return false;
+  }
+  oconfig.velocityFilter = Supplier<std::unique_ptr<Filter>>(make);
+  return true;
+}
+
+struct StageTimes {
+  std::vector<double> odometry;
+  std::vector<double> filters;
+  std::vector<double> controllers;
+};
+
+/**
+ * Replays every sample through `ipipeline`, timing each stage.
+ */
+std::vector<PipelineOutput> replay(SensorPipeline &ipipeline,
+                                   const std::vector<SensorRecord> &irecords,
+                                   StageTimes &otimes) {
+  using clock = std::chrono::steady_clock;
+  const auto ns = [](clock::time_point a, clock::time_point b) {
+    return std::chrono::duration<double, std::nano>(b - a).count();
+  };
+
+  std::vector<PipelineOutput> outputs;
+  outputs.reserve(irecords.size());
+  ipipeline.reset();
+  for (const auto &record : irecords) {
+    const auto t0 = clock::now();
+    ipipeline.stepOdometry(record.sample);
+    const auto t1 = clock::now();
+    ipipeline.stepFilters(record.sample);
+    const auto t2 = clock::now();
+    ipipeline.stepControllers(record.sample);
+    const auto t3 = clock::now();
+
+    otimes.odometry.push_back(ns(t0, t1));
+    otimes.filters.push_back(ns(t1, t2));
+    otimes.controllers.push_back(ns(t2, t3));
+    outputs.push_back(ipipeline.getOutput());
+  }
+  return outputs;
+}
+
+void printTimes(const char *iname, std::vector<double> itimes) {
+  std::sort(itimes.begin(), itimes.end());
+  double sum = 0;
+  for (double t : itimes) {
+    sum += t;
+  }
+  printf("  %-12s mean %8.0f ns  p50 %8.0f ns  p99 %8.0f ns  max %8.0f ns\n",
+         iname,
+         sum / itimes.size(),
+         itimes[itimes.size() / 2],
+         itimes[itimes.size() * 99 / 100],
+         itimes.back());
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argv[1][0] == '-') {
+    fprintf(stderr,
+            "Usage: %s <sensors.csv> [--repeat 5] [--filter ema:0.5] [--wheel 2.75] "
+            "[--track 5.25] [--truth x_m,y_m,theta_deg] [--out replay.csv]\n",
+            argv[0]);
+    return 1;
+  }
+
+  std::map<std::string, std::string> options{{"--repeat", "5"},
+                                             {"--filter", ""},
+                                             {"--wheel", "2.75"},
+                                             {"--track", "5.25"},
+                                             {"--truth", ""},
+                                             {"--out", ""}};
+  for (int i = 2; i + 1 < argc; i += 2) {
+    if (!options.count(argv[i])) {
+      fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+    options[argv[i]] = argv[i + 1];
+  }
+
+  const auto records = SensorLog::load(argv[1]);
+  if (records.empty()) {
+    fprintf(stderr, "No samples in %s\n", argv[1]);
+    return 1;
+  }
+
+  SensorPipeline::Config config;
+  config.scales = ChassisScales({std::stod(options["--wheel"]) * inch,
+                                 std::stod(options["--track"]) * inch},
+                                quadEncoderTPR);
+  if (!options["--filter"].empty() && !parseFilter(options["--filter"], config)) {
+    fprintf(stderr, "Unknown filter %s\n", options["--filter"].c_str());
+    return 1;
+  }
+  const bool changed = !options["--filter"].empty() || options["--wheel"] != "2.75" ||
+                       options["--track"] != "5.25";
+
+  printf("%zu samples, %.2f s\n", records.size(), records.back().sample.time / 1000.0);
+
+  // Every replay must reproduce the first one exactly
+  SensorPipeline pipeline(config);
+  StageTimes times;
+  const auto outputs = replay(pipeline, records, times);
+  const int repeat = std::max(1, std::stoi(options["--repeat"]));
+  bool deterministic = true;
+  for (int run = 1; run < repeat && deterministic; run++) {
+    SensorPipeline fresh(config);
+    const auto again = replay(fresh, records, times);
+    for (std::size_t i = 0; i < records.size() && deterministic; i++) {
+      for (std::size_t f = 0; f < outputCount; f++) {
+        if (!sameBits(field(outputs[i], f), field(again[i], f))) {
+          printf("Replay %d diverged at %lu ms in %s\n",
+                 run + 1,
+                 static_cast<unsigned long>(records[i].sample.time),
+                 outputNames[f]);
+          deterministic = false;
+          break;
+        }
+      }
+    }
+  }
+  printf("Deterministic over %d replays: %s\n", repeat, deterministic ? "yes" : "NO");
+
+  printf("\n%s against the recorded outputs:\n",
+         changed ? "Changed pipeline" : "Replay");
+  for (std::size_t f = 0; f < outputCount; f++) {
+    std::size_t exact = 0;
+    double worst = 0;
+    std::size_t worstAt = 0;
+    for (std::size_t i = 0; i < records.size(); i++) {
+      const double recorded = field(records[i].output, f);
+      const double replayed = field(outputs[i], f);
+      if (sameBits(recorded, replayed)) {
+        exact++;
+      } else if (std::abs(recorded - replayed) > worst) {
+        worst = std::abs(recorded - replayed);
+        worstAt = i;
+      }
+    }
+    printf("  %-19s %6zu/%zu exact", outputNames[f], exact, records.size());
+    if (worst > 0) {
+      printf(", max difference %.3g at %lu ms",
+             worst,
+             static_cast<unsigned long>(records[worstAt].sample.time));
+    }
+    printf("\n");
+  }
+
+  printf("\nPer sample, %d replays:\n", repeat);
+  printTimes("odometry", times.odometry);
+  printTimes("filters", times.filters);
+  printTimes("controllers", times.controllers);
+
+  const PipelineOutput &last = outputs.back();
+  printf("\nFinal pose: x %.4f m, y %.4f m, theta %.2f deg\n", last.x, last.y, last.theta);
+  double truth[3];
+  if (!options["--truth"].empty() &&
+      sscanf(options["--truth"].c_str(), "%lf,%lf,%lf", &truth[0], &truth[1], &truth[2]) == 3) {
+    printf("Against the measured pose: %.2f cm, %.2f deg\n",
+           std::hypot(last.x - truth[0], last.y - truth[1]) * 100,
+           last.theta - truth[2]);
+  }
+
+  if (!options["--out"].empty()) {
+    std::vector<SensorRecord> replayed = records;
+    for (std::size_t i = 0; i < replayed.size(); i++) {
+      replayed[i].output = outputs[i];
+    }
+    if (!SensorLog::save(options["--out"], replayed)) {
+      fprintf(stderr, "Couldn't write %s\n", options["--out"].c_str());
+      return 1;
+    }
+  }
+
+  return deterministic ? 0 : 2;
+}
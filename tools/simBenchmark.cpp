@@ -0,0 +1,92 @@
+/*
+ * Benchmarks SkidSteerSimulator against wall time.
+ *
+ * First the physics alone is stepped, then the full robot-side loop: every 10 ms the drive is
+ * commanded through the SkidSteerModel adapter (velocity mode, as ChassisControllerPID drives it)
+ * and TwoEncoderOdometry is stepped from the simulated tracking wheels. Both are reported as
+ * simulated seconds per wall second, along with how far odometry drifted from the true pose.
+ *
+ * Usage: simBenchmark [simulated seconds]
+ */
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "skidSteerSimulator.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+using namespace okapi;
+
+namespace {
+/**
+ * Reads the simulation's clock. Odometry only needs a TimeUtil to construct; stepping it by hand
+ * never waits on a rate.
+ */
+class SimulatedTimer : public AbstractTimer {
+  public:
+  explicit SimulatedTimer(std::shared_ptr<SkidSteerSimulator> isim)
+    : AbstractTimer(isim->getTime() * second), sim(std::move(isim)) {
+  }
+
+  QTime millis() const override {
+    return sim->getTime() * second;
+  }
+
+  protected:
+  std::shared_ptr<SkidSteerSimulator> sim;
+};
+
+double wallSeconds(const std::chrono::steady_clock::time_point &istart) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - istart).count();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const double duration = argc > 1 ? std::stod(argv[1]) : 600;
+
+  {
+    SkidSteerSimulator sim;
+    sim.setVoltage(SkidSteerSimulator::left, 8);
+    sim.setVoltage(SkidSteerSimulator::right, 10);
+    const auto start = std::chrono::steady_clock::now();
+    sim.stepFor(duration);
+    printf("physics only:       %8.0f simulated s per wall s\n", duration / wallSeconds(start));
+  }
+
+  auto sim = std::make_shared<SkidSteerSimulator>();
+  auto model = SkidSteerSimulator::makeChassisModel(sim);
+  const TimeUtil timeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([=]() { return std::make_unique<SimulatedTimer>(sim); }),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::unique_ptr<AbstractRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>([=]() {
+      return std::make_unique<SettledUtil>(std::make_unique<SimulatedTimer>(sim));
+    }));
+  TwoEncoderOdometry odom(
+    timeUtil, model, ChassisScales({2.75_in, 5.25_in}, quadEncoderTPR), std::make_shared<Logger>());
+
+  // Figure eights: alternating arcs with a straight between them
+  const auto start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick * 0.010 < duration; tick++) {
+    const int phase = (tick / 150) % 4;
+    const double yaw = phase == 0 ? 0.4 : phase == 2 ? -0.4 : 0;
+    model->driveVector(0.8, yaw);
+    sim->stepFor(0.010);
+    odom.step();
+  }
+  const double wall = wallSeconds(start);
+
+  const auto truth = sim->getPose();
+  const auto state = odom.getState(StateMode::FRAME_TRANSFORMATION);
+  // Odometry's frame has y to the right and theta clockwise
+  const double dx = state.x.convert(meter) - truth.x;
+  const double dy = state.y.convert(meter) + truth.y;
+  printf("model + odometry:   %8.0f simulated s per wall s\n", duration / wall);
+  printf("odometry drift after %.0f s: %.3f m, %.2f deg\n",
+         duration,
+         std::hypot(dx, dy),
+         std::remainder(state.theta.convert(degree) + truth.theta * 180 / 3.14159265358979323846,
+                        360));
+  return 0;
+}
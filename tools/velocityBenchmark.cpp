@@ -0,0 +1,219 @@
+/*
+ * Lag against noise for velocity estimators, on the tracking wheel ticks of a sensor log recorded
+ * by SensorRecorder: okapi's VelMath (two positions differenced over the loop dt, then filtered)
+ * against LeastSquaresVelMath fitting a line or a parabola over windows of a few samples.
+ *
+ * A log has no true velocity, so each estimate is compared against a non-causal one: the slope of
+ * a line fit centered on each sample, over `--reference` samples either side, which has no lag.
+ * For each estimator this reports
+ *  - lag: the delay of the estimate behind the reference which matches it best,
+ *  - noise: the RMS difference from the reference once delayed by that lag,
+ *  - error: the RMS difference with no delay, which is what a controller sees,
+ *  - the time it takes per sample on this machine.
+ *
+ * Usage: velocityBenchmark <sensors.csv> [--reference 10]
+ */
+#include "leastSquaresVelMath.hpp"
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include "sensorPipeline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+constexpr double ticksPerRev = quadEncoderTPR;
+constexpr std::size_t maxLag = 30; // samples
+
+/**
+ * Reads the time of the sample being stepped.
+ */
+class SampleTimer : public AbstractTimer {
+  public:
+  explicit SampleTimer(const std::uint32_t *inow) : AbstractTimer(*inow * millisecond), now(inow) {
+  }
+
+  QTime millis() const override {
+    return *now * millisecond;
+  }
+
+  protected:
+  const std::uint32_t *now;
+};
+
+struct Track {
+  std::vector<std::uint32_t> times; // ms
+  std::vector<double> ticks;
+};
+
+/**
+ * The slope of a least-squares line through `iradius` samples either side of each sample, in rpm.
+ */
+std::vector<double> reference(const Track &itrack, const std::size_t iradius) {
+  const std::size_t size = itrack.ticks.size();
+  std::vector<double> out(size, NAN);
+  for (std::size_t i = iradius; i + iradius < size; i++) {
+    double st = 0, sx = 0, stt = 0, stx = 0;
+    const double n = 2 * iradius + 1;
+    for (std::size_t j = i - iradius; j <= i + iradius; j++) {
+      const double t = (static_cast<double>(itrack.times[j]) - itrack.times[i]) / 1000;
+      const double x = itrack.ticks[j] - itrack.ticks[i];
+      st += t;
+      sx += x;
+      stt += t * t;
+      stx += t * x;
+    }
+    out[i] = (n * stx - st * sx) / (n * stt - st * st) * 60 / ticksPerRev;
+  }
+  return out;
+}
+
+struct Result {
+  double lagMs;
+  double noise;
+  double error;
+  double nsPerSample;
+};
+
+/**
+ * Runs the track through a fresh VelMath and scores its velocity against the reference.
+ */
+Result run(const Track &itrack,
+           const std::vector<double> &ireference,
+           const std::function<std::unique_ptr<VelMath>(const std::uint32_t *)> &imake) {
+  std::uint32_t now = itrack.times.front();
+  const auto velMath = imake(&now);
+  std::vector<double> estimate(itrack.ticks.size());
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < itrack.ticks.size(); i++) {
+    now = itrack.times[i];
+    estimate[i] = velMath->step(itrack.ticks[i]).convert(rpm);
+  }
+  const double ns =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  auto rms = [&](const std::size_t ilag) {
+    double sum = 0;
+    std::size_t n = 0;
+    for (std::size_t i = maxLag + ilag; i < estimate.size(); i++) {
+      const double ref = ireference[i - ilag];
+      if (!std::isnan(ref)) {
+        sum += (estimate[i] - ref) * (estimate[i] - ref);
+        n++;
+      }
+    }
+    return n > 0 ? std::sqrt(sum / n) : NAN;
+  };
+
+  std::size_t bestLag = 0;
+  for (std::size_t lag = 1; lag <= maxLag; lag++) {
+    if (rms(lag) < rms(bestLag)) {
+      bestLag = lag;
+    }
+  }
+
+  const double period = static_cast<double>(itrack.times.back() - itrack.times.front()) /
+                        std::max<std::size_t>(1, itrack.times.size() - 1);
+  return {bestLag * period, rms(bestLag), rms(0), ns / itrack.ticks.size()};
+}
+
+struct Estimator {
+  std::string name;
+  std::function<std::unique_ptr<VelMath>(const std::uint32_t *)> make;
+};
+
+std::vector<Estimator> estimators() {
+  std::vector<Estimator> out;
+  auto velMath = [](std::function<std::unique_ptr<Filter>()> ifilter) {
+    return [=](const std::uint32_t *inow) {
+      return std::make_unique<VelMath>(
+        ticksPerRev, ifilter(), 0_ms, std::make_unique<SampleTimer>(inow));
+    };
+  };
+  out.push_back({"VelMath", velMath([] { return std::make_unique<PassthroughFilter>(); })});
+  out.push_back(
+    {"VelMath average:2", velMath([] { return std::make_unique<AverageFilter<2>>(); })});
+  out.push_back(
+    {"VelMath average:5", velMath([] { return std::make_unique<AverageFilter<5>>(); })});
+  out.push_back({"VelMath ema:0.3", velMath([] { return std::make_unique<EmaFilter>(0.3); })});
+
+  for (const int order : {1, 2}) {
+    for (const std::size_t window : {3, 5, 8, 12, 16}) {
+      if (window < static_cast<std::size_t>(order) + 2) {
+        continue;
+      }
+      out.push_back({std::string(order == 1 ? "line:" : "parabola:") + std::to_string(window),
+                     [=](const std::uint32_t *inow) {
+                       return std::make_unique<LeastSquaresVelMath>(
+                         ticksPerRev, window, std::make_unique<SampleTimer>(inow), order);
+                     }});
+    }
+  }
+  return out;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <sensors.csv> [--reference 10]\n", argv[0]);
+    return 1;
+  }
+
+  std::size_t radius = 10;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--reference") == 0) {
+      radius = std::stoul(argv[i + 1]);
+    } else {
+      fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  const auto records = SensorLog::load(argv[1]);
+  if (records.size() < 2 * radius + maxLag + 2) {
+    fprintf(stderr, "%s: not enough samples\n", argv[1]);
+    return 1;
+  }
+
+  Track sides[2];
+  for (const auto &record : records) {
+    for (auto &side : sides) {
+      side.times.push_back(record.sample.time);
+    }
+    sides[0].ticks.push_back(record.sample.leftTicks);
+    sides[1].ticks.push_back(record.sample.rightTicks);
+  }
+  const std::vector<double> references[] = {reference(sides[0], radius),
+                                            reference(sides[1], radius)};
+
+  printf("%zu samples, reference fit over %zu samples, velocities in rpm\n\n",
+         records.size(),
+         2 * radius + 1);
+  printf("  %-20s %8s %8s %8s %8s\n", "estimator", "lag ms", "noise", "error", "ns");
+  for (const auto &estimator : estimators()) {
+    // Both sides count equally; lag and timing are averaged, noise and error combined as RMS
+    Result total{0, 0, 0, 0};
+    for (int i = 0; i < 2; i++) {
+      const Result result = run(sides[i], references[i], estimator.make);
+      total.lagMs += result.lagMs / 2;
+      total.noise += result.noise * result.noise / 2;
+      total.error += result.error * result.error / 2;
+      total.nsPerSample += result.nsPerSample / 2;
+    }
+    printf("  %-20s %8.1f %8.2f %8.2f %8.1f\n",
+           estimator.name.c_str(),
+           total.lagMs,
+           std::sqrt(total.noise),
+           std::sqrt(total.error),
+           total.nsPerSample);
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Runs an autonomous-style routine on VirtualClock and the host PROS shims, and reports the
+ * simulated routine duration against wall time.
+ *
+ * The routine is written the way main.cpp's are: pros::Task function pointers, busy-waits on
+ * pros::c::millis, pros::delay between steps, an okapi-style fixed-rate control loop and a mutex
+ * shared between tasks. The drive is a SkidSteerSimulator stepped as simulated time advances.
+ * Every run must finish at the same simulated time, pose and task switch count.
+ *
+ * Usage: virtualTimeBenchmark [runs]
+ */
+#include "api.h"
+#include "skidSteerSimulator.hpp"
+#include "virtualClock.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+std::shared_ptr<SkidSteerSimulator> sim;
+pros::Mutex *driveMutex;
+double targetLeft = 0;  // rpm
+double targetRight = 0; // rpm
+bool routineRunning = false;
+
+void setDrive(const double ileft, const double iright) {
+  driveMutex->take(TIMEOUT_MAX);
+  targetLeft = ileft;
+  targetRight = iright;
+  driveMutex->give();
+}
+
+/**
+ * The drive's control loop at 10 ms, like ChassisControllerPID's thread.
+ */
+void driveTask(void *) {
+  std::uint32_t now = pros::c::millis();
+  while (routineRunning) {
+    driveMutex->take(TIMEOUT_MAX);
+    sim->setVelocity(SkidSteerSimulator::left, targetLeft);
+    sim->setVelocity(SkidSteerSimulator::right, targetRight);
+    driveMutex->give();
+    pros::Task::delay_until(&now, 10);
+  }
+}
+
+/**
+ * A busy-waiting intake, like main.cpp's intake().
+ */
+void intakeTask(void *) {
+  pros::delay(300);
+  const std::uint32_t time = pros::c::millis();
+  volatile int spins = 0;
+  while (pros::c::millis() - time <= 1500) {
+    spins = spins + 1;
+  }
+}
+
+void routine() {
+  routineRunning = true;
+  pros::Task drive(driveTask, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Drive");
+  pros::Task intake(intakeTask, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Intake");
+
+  setDrive(150, 150);
+  pros::delay(1200);
+  setDrive(-100, 100);
+  pros::delay(450);
+  setDrive(120, 120);
+  pros::delay(900);
+  setDrive(0, 0);
+  pros::delay(250);
+
+  // Wait for the intake, then back off for a fixed time
+  while (intake.get_state() != pros::E_TASK_STATE_DELETED) {
+    pros::delay(10);
+  }
+  setDrive(-80, -80);
+  const std::uint32_t time = pros::c::millis();
+  while (pros::c::millis() - time <= 600) {
+  }
+  setDrive(0, 0);
+  pros::delay(300);
+  routineRunning = false;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int runs = argc > 1 ? std::stoi(argv[1]) : 1000;
+  auto &clock = VirtualClock::get();
+  pros::Mutex mutex;
+  driveMutex = &mutex;
+
+  double firstDuration = 0;
+  SkidSteerSimulator::Pose firstPose;
+  std::uint64_t firstSwitches = 0;
+  bool deterministic = true;
+  double simulated = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int run = 0; run < runs; run++) {
+    clock.reset();
+    sim = std::make_shared<SkidSteerSimulator>();
+    clock.setAdvanceCallback([](const std::uint64_t ifrom, const std::uint64_t ito) {
+      sim->stepFor((ito - ifrom) / 1e6);
+    });
+
+    const auto result = clock.run(routine, 15000);
+    const auto pose = sim->getPose();
+    const std::uint64_t switches = clock.getSwitchCount();
+    simulated += result.durationMs / 1000;
+
+    if (run == 0) {
+      firstDuration = result.durationMs;
+      firstPose = pose;
+      firstSwitches = switches;
+      printf("routine %s in %.0f ms simulated, %llu task switches, pose (%.4f m, %.4f m, %.2f deg)\n",
+             result.completed ? "completed" : "timed out",
+             result.durationMs,
+             static_cast<unsigned long long>(switches),
+             pose.x,
+             pose.y,
+             pose.theta * 180 / 3.14159265358979323846);
+    } else if (result.durationMs != firstDuration || pose.x != firstPose.x ||
+               pose.y != firstPose.y || pose.theta != firstPose.theta ||
+               switches != firstSwitches) {
+      deterministic = false;
+    }
+  }
+  const double wall =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%d runs: %.1f s simulated in %.3f s wall, %.0fx real time, %s\n",
+         runs,
+         simulated,
+         wall,
+         simulated / wall,
+         deterministic ? "every run identical" : "RUNS DIFFERED");
+  return deterministic ? 0 : 1;
+}